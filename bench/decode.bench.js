@@ -0,0 +1,308 @@
+#!/usr/bin/env node
+
+/**
+ * End-to-end decode benchmark for the Node.js wrapper
+ *
+ * Measures decodeImage and decodeImageAsync over images of several sizes:
+ * calls per second, latency percentiles, event-loop lag and RSS growth.
+ * Results can be compared against a stored baseline with tolerance bands,
+ * exiting with status 1 on a regression.
+ *
+ * Usage: npm run bench -- [options]
+ *   --sizes LIST           Canvas sizes, e.g. 640x480,1920x1080 (default 640x480,1920x1080,3840x2160)
+ *   --duration MS          Measured time per scenario (default 3000)
+ *   --concurrency N        In-flight decodeImageAsync calls for the parallel scenario (default: CPU count)
+ *   --json                 Print results as JSON only
+ *   --out FILE             Also write the JSON results to FILE
+ *   --baseline FILE        Compare against FILE (default bench/baseline.json when it exists)
+ *   --update-baseline      Write the results to the baseline file instead of comparing
+ *   --tolerance FRACTION   Allowed relative regression (default 0.15)
+ *
+ * The license key is read from BARKODER_LICENSE_KEY, or from config.json.
+ */
+
+const BarkoderSDK = require('../lib/index');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { monitorEventLoopDelay } = require('perf_hooks');
+
+const DEFAULT_BASELINE = path.join(__dirname, 'baseline.json');
+
+function parseArgs(argv) {
+    const options = {
+        sizes: '640x480,1920x1080,3840x2160',
+        duration: 3000,
+        concurrency: os.cpus().length,
+        json: false,
+        out: null,
+        baseline: null,
+        updateBaseline: false,
+        tolerance: 0.15
+    };
+
+    for (let i = 0; i < argv.length; i++) {
+        const arg = argv[i];
+        const value = argv[i + 1];
+        switch (arg) {
+            case '--sizes': options.sizes = value; i++; break;
+            case '--duration': options.duration = Number(value); i++; break;
+            case '--concurrency': options.concurrency = Number(value); i++; break;
+            case '--json': options.json = true; break;
+            case '--out': options.out = value; i++; break;
+            case '--baseline': options.baseline = value; i++; break;
+            case '--update-baseline': options.updateBaseline = true; break;
+            case '--tolerance': options.tolerance = Number(value); i++; break;
+            default: throw new Error(`Unknown option ${arg}`);
+        }
+    }
+
+    options.sizes = options.sizes.split(',').map(size => {
+        const [width, height] = size.split('x').map(Number);
+        if (!(width > 0 && height > 0)) {
+            throw new Error(`Invalid size ${size}, expected WIDTHxHEIGHT`);
+        }
+        return { width, height };
+    });
+    return options;
+}
+
+// Load a 24-bit BMP as a grayscale buffer, top row first
+function loadBmpAsGrayscale(filePath) {
+    const data = fs.readFileSync(filePath);
+    const offset = data.readUInt32LE(10);
+    const width = data.readUInt32LE(18);
+    const height = data.readUInt32LE(22);
+    const rowSize = Math.ceil(width * 3 / 4) * 4;
+    const pixels = Buffer.alloc(width * height);
+
+    for (let y = 0; y < height; y++) {
+        const row = offset + (height - 1 - y) * rowSize;
+        for (let x = 0; x < width; x++) {
+            const i = row + x * 3;
+            pixels[y * width + x] = Math.round(0.299 * data[i + 2] + 0.587 * data[i + 1] + 0.114 * data[i]);
+        }
+    }
+    return { buffer: pixels, width, height };
+}
+
+// Center an image on a white canvas, shrinking it first when it does not fit
+function placeOnCanvas(image, width, height) {
+    const canvas = Buffer.alloc(width * height, 255);
+    const scale = Math.min(1, width / image.width, height / image.height);
+    const placedWidth = Math.max(1, Math.floor(image.width * scale));
+    const placedHeight = Math.max(1, Math.floor(image.height * scale));
+    const left = Math.floor((width - placedWidth) / 2);
+    const top = Math.floor((height - placedHeight) / 2);
+
+    for (let y = 0; y < placedHeight; y++) {
+        const sourceY = Math.min(image.height - 1, Math.floor(y / scale));
+        for (let x = 0; x < placedWidth; x++) {
+            const sourceX = Math.min(image.width - 1, Math.floor(x / scale));
+            canvas[(top + y) * width + left + x] = image.buffer[sourceY * image.width + sourceX];
+        }
+    }
+    return { buffer: canvas, width, height };
+}
+
+function initialize() {
+    if (process.env.BARKODER_LICENSE_KEY) {
+        const status = BarkoderSDK.initialize(process.env.BARKODER_LICENSE_KEY);
+        if (!status.startsWith('SUCCESS:')) {
+            throw new Error(status);
+        }
+        return;
+    }
+    const result = BarkoderSDK.initializeFromConfig(path.join(__dirname, '../config.json'));
+    if (!result.success) {
+        throw new Error(result.status);
+    }
+}
+
+function percentile(sorted, quantile) {
+    if (sorted.length === 0) {
+        return 0;
+    }
+    return sorted[Math.min(sorted.length - 1, Math.floor(quantile * sorted.length))];
+}
+
+function round(value, digits = 3) {
+    const factor = 10 ** digits;
+    return Math.round(value * factor) / factor;
+}
+
+/**
+ * Run decode calls for the given time and summarize them
+ * @param {Function} call - Returns a promise or value for one decode
+ * @param {number} concurrency - Calls kept in flight (1 for the sync path)
+ */
+async function measure(call, concurrency, durationMs) {
+    // Warm up decoder state and JIT before measuring
+    for (let i = 0; i < 5; i++) {
+        await call();
+    }
+    if (global.gc) {
+        global.gc();
+    }
+
+    const latencies = [];
+    const lag = monitorEventLoopDelay({ resolution: 10 });
+    const rssBefore = process.memoryUsage().rss;
+    const start = process.hrtime.bigint();
+    const deadline = start + BigInt(durationMs) * 1000000n;
+
+    lag.enable();
+    const lanes = [];
+    for (let lane = 0; lane < concurrency; lane++) {
+        lanes.push((async () => {
+            while (process.hrtime.bigint() < deadline) {
+                const before = process.hrtime.bigint();
+                await call();
+                latencies.push(Number(process.hrtime.bigint() - before) / 1e6);
+                // Let timers run between sync calls so event-loop lag is observable
+                if (concurrency === 1) {
+                    await new Promise(resolve => setImmediate(resolve));
+                }
+            }
+        })());
+    }
+    await Promise.all(lanes);
+    lag.disable();
+
+    const elapsedSeconds = Number(process.hrtime.bigint() - start) / 1e9;
+    if (global.gc) {
+        global.gc();
+    }
+    const rssAfter = process.memoryUsage().rss;
+
+    latencies.sort((a, b) => a - b);
+    return {
+        calls: latencies.length,
+        callsPerSec: round(latencies.length / elapsedSeconds, 2),
+        latencyMs: {
+            p50: round(percentile(latencies, 0.5)),
+            p90: round(percentile(latencies, 0.9)),
+            p99: round(percentile(latencies, 0.99)),
+            max: round(latencies[latencies.length - 1] || 0)
+        },
+        eventLoopLagMs: {
+            p50: round(lag.percentile(50) / 1e6),
+            p99: round(lag.percentile(99) / 1e6),
+            max: round(lag.max / 1e6)
+        },
+        rssGrowthMB: round((rssAfter - rssBefore) / (1024 * 1024), 2)
+    };
+}
+
+async function runScenarios(options) {
+    const image = loadBmpAsGrayscale(path.join(__dirname, '../examples/qr.bmp'));
+    const scenarios = [];
+
+    for (const size of options.sizes) {
+        const frame = placeOnCanvas(image, size.width, size.height);
+        const cases = [
+            { path: 'decodeImage', concurrency: 1, call: () => BarkoderSDK.decodeImage(frame.buffer, frame.width, frame.height) },
+            { path: 'decodeImageAsync', concurrency: 1, call: () => BarkoderSDK.decodeImageAsync(frame.buffer, frame.width, frame.height) }
+        ];
+        if (options.concurrency > 1) {
+            cases.push({ path: 'decodeImageAsync', concurrency: options.concurrency, call: () => BarkoderSDK.decodeImageAsync(frame.buffer, frame.width, frame.height) });
+        }
+
+        for (const scenario of cases) {
+            const name = `${scenario.path}/${size.width}x${size.height}/c${scenario.concurrency}`;
+            if (!options.json) {
+                process.stderr.write(`  ${name} ...`);
+            }
+            const result = await measure(scenario.call, scenario.concurrency, options.duration);
+            if (!options.json) {
+                process.stderr.write(` ${result.callsPerSec} calls/s, p99 ${result.latencyMs.p99} ms\n`);
+            }
+            scenarios.push({ name, path: scenario.path, width: size.width, height: size.height, concurrency: scenario.concurrency, ...result });
+        }
+    }
+    return scenarios;
+}
+
+/**
+ * Compare results with a baseline
+ * @returns {Array<string>} Descriptions of every metric outside its tolerance band
+ */
+function compare(results, baseline, tolerance) {
+    const regressions = [];
+    const byName = new Map(baseline.scenarios.map(scenario => [scenario.name, scenario]));
+
+    for (const scenario of results.scenarios) {
+        const reference = byName.get(scenario.name);
+        if (!reference) {
+            continue;
+        }
+        const check = (metric, current, previous, higherIsBetter, slack = 0) => {
+            const limit = higherIsBetter ? previous * (1 - tolerance) : previous * (1 + tolerance) + slack;
+            if (higherIsBetter ? current < limit : current > limit) {
+                regressions.push(`${scenario.name} ${metric}: ${current} vs baseline ${previous} (limit ${round(limit)})`);
+            }
+        };
+        check('callsPerSec', scenario.callsPerSec, reference.callsPerSec, true);
+        check('latencyMs.p99', scenario.latencyMs.p99, reference.latencyMs.p99, false);
+        // Lag and RSS are noisy at small values, allow a fixed slack on top of the relative band
+        check('eventLoopLagMs.p99', scenario.eventLoopLagMs.p99, reference.eventLoopLagMs.p99, false, 5);
+        check('rssGrowthMB', scenario.rssGrowthMB, Math.max(0, reference.rssGrowthMB), false, 16);
+    }
+    return regressions;
+}
+
+async function main() {
+    const options = parseArgs(process.argv.slice(2));
+    initialize();
+    BarkoderSDK.enableDecoders(['QR']);
+    BarkoderSDK.setDecodingSpeed(BarkoderSDK.constants.DecodingSpeed.Normal);
+
+    if (!options.json) {
+        console.error(`Barkoder ${BarkoderSDK.getVersion()} on Node ${process.version}, ${os.cpus().length} CPUs`);
+    }
+
+    const results = {
+        sdkVersion: BarkoderSDK.getVersion(),
+        node: process.version,
+        platform: `${process.platform}-${process.arch}`,
+        cpus: os.cpus().length,
+        durationMs: options.duration,
+        scenarios: await runScenarios(options)
+    };
+
+    const json = JSON.stringify(results, null, 2);
+    if (options.json) {
+        console.log(json);
+    }
+    if (options.out) {
+        fs.writeFileSync(options.out, json + '\n');
+    }
+
+    const baselinePath = options.baseline || DEFAULT_BASELINE;
+    if (options.updateBaseline) {
+        fs.writeFileSync(baselinePath, json + '\n');
+        console.error(`Baseline written to ${baselinePath}`);
+        return 0;
+    }
+    if (!fs.existsSync(baselinePath)) {
+        if (options.baseline) {
+            throw new Error(`Baseline ${baselinePath} not found`);
+        }
+        console.error('No baseline to compare against, create one with --update-baseline');
+        return 0;
+    }
+
+    const regressions = compare(results, JSON.parse(fs.readFileSync(baselinePath, 'utf8')), options.tolerance);
+    if (regressions.length > 0) {
+        console.error(`\n${regressions.length} regression(s) beyond ${options.tolerance * 100}% of ${baselinePath}:`);
+        regressions.forEach(regression => console.error(`  ${regression}`));
+        return 1;
+    }
+    console.error(`\nWithin ${options.tolerance * 100}% of ${baselinePath}`);
+    return 0;
+}
+
+main().then(code => process.exit(code), error => {
+    console.error(`Benchmark failed: ${error.message}`);
+    process.exit(2);
+});
@@ -0,0 +1,189 @@
+#include "Degradation.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace BKBench {
+
+/**
+ * Projective map of the unit square onto a quadrilateral (Heckbert, "Fundamentals of Texture Mapping")
+ */
+struct Homography {
+    double m[3][3];
+
+    static Homography SquareToQuad(const double quad[4][2]) {
+        double x0 = quad[0][0], y0 = quad[0][1], x1 = quad[1][0], y1 = quad[1][1];
+        double x2 = quad[2][0], y2 = quad[2][1], x3 = quad[3][0], y3 = quad[3][1];
+        double dx1 = x1 - x2, dx2 = x3 - x2, dx3 = x0 - x1 + x2 - x3;
+        double dy1 = y1 - y2, dy2 = y3 - y2, dy3 = y0 - y1 + y2 - y3;
+
+        double g = 0;
+        double h = 0;
+        double denominator = dx1 * dy2 - dx2 * dy1;
+        if (std::fabs(dx3) > 1e-12 || std::fabs(dy3) > 1e-12) {
+            g = (dx3 * dy2 - dx2 * dy3) / denominator;
+            h = (dx1 * dy3 - dx3 * dy1) / denominator;
+        }
+
+        Homography result = { {
+            { x1 - x0 + g * x1, x3 - x0 + h * x3, x0 },
+            { y1 - y0 + g * y1, y3 - y0 + h * y3, y0 },
+            { g, h, 1 },
+        } };
+        return result;
+    }
+
+    Homography Inverse() const {
+        Homography result;
+        result.m[0][0] = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+        result.m[0][1] = m[0][2] * m[2][1] - m[0][1] * m[2][2];
+        result.m[0][2] = m[0][1] * m[1][2] - m[0][2] * m[1][1];
+        result.m[1][0] = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+        result.m[1][1] = m[0][0] * m[2][2] - m[0][2] * m[2][0];
+        result.m[1][2] = m[0][2] * m[1][0] - m[0][0] * m[1][2];
+        result.m[2][0] = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+        result.m[2][1] = m[0][1] * m[2][0] - m[0][0] * m[2][1];
+        result.m[2][2] = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+        return result; // Adjugate, the scale factor cancels out in Map
+    }
+
+    void Map(double x, double y, double &mappedX, double &mappedY) const {
+        double w = m[2][0] * x + m[2][1] * y + m[2][2];
+        mappedX = (m[0][0] * x + m[0][1] * y + m[0][2]) / w;
+        mappedY = (m[1][0] * x + m[1][1] * y + m[1][2]) / w;
+    }
+};
+
+/**
+ * Separable gaussian blur with clamped edges
+ */
+static void GaussianBlur(std::vector<float> &values, int width, int height, double sigma) {
+    int radius = static_cast<int>(std::ceil(sigma * 3));
+    std::vector<float> kernel(radius * 2 + 1);
+    float sum = 0;
+    for (int i = -radius; i <= radius; i++) {
+        kernel[i + radius] = static_cast<float>(std::exp(-(i * i) / (2 * sigma * sigma)));
+        sum += kernel[i + radius];
+    }
+    for (float &weight : kernel) {
+        weight /= sum;
+    }
+
+    std::vector<float> temporary(values.size());
+    for (int y = 0; y < height; y++) {
+        const float *row = &values[static_cast<size_t>(y) * width];
+        for (int x = 0; x < width; x++) {
+            float value = 0;
+            for (int k = -radius; k <= radius; k++) {
+                value += kernel[k + radius] * row[std::min(width - 1, std::max(0, x + k))];
+            }
+            temporary[static_cast<size_t>(y) * width + x] = value;
+        }
+    }
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            float value = 0;
+            for (int k = -radius; k <= radius; k++) {
+                value += kernel[k + radius] * temporary[static_cast<size_t>(std::min(height - 1, std::max(0, y + k))) * width + x];
+            }
+            values[static_cast<size_t>(y) * width + x] = value;
+        }
+    }
+}
+
+void Render(const ModuleGrid &grid, const Degradation &degradation, Random &random, RenderedImage &image) {
+    // Symbol plane in modules, quiet zone included. Linear symbols get bars 40% as tall as they are wide.
+    int quietZone = grid.quietZone;
+    int symbolHeight = grid.linear ? std::max(20, grid.width * 2 / 5) : grid.height;
+    double planeWidth = grid.width + 2 * quietZone;
+    double planeHeight = symbolHeight + 2 * quietZone;
+
+    // Scale and rotate about the center, then pull one random edge toward its midpoint
+    double angle = degradation.rotation * 3.141592653589793 / 180;
+    double cosine = std::cos(angle);
+    double sine = std::sin(angle);
+    const double unit[4][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+    double quad[4][2];
+    for (int i = 0; i < 4; i++) {
+        double x = (unit[i][0] - 0.5) * planeWidth * degradation.moduleSize;
+        double y = (unit[i][1] - 0.5) * planeHeight * degradation.moduleSize;
+        quad[i][0] = x * cosine + y * sine;
+        quad[i][1] = -x * sine + y * cosine;
+    }
+    if (degradation.perspective > 0) {
+        int edge = random.Int(0, 3);
+        double (&a)[2] = quad[edge];
+        double (&b)[2] = quad[(edge + 1) % 4];
+        double middleX = (a[0] + b[0]) / 2;
+        double middleY = (a[1] + b[1]) / 2;
+        double keep = 1 - degradation.perspective;
+        a[0] = middleX + (a[0] - middleX) * keep;
+        a[1] = middleY + (a[1] - middleY) * keep;
+        b[0] = middleX + (b[0] - middleX) * keep;
+        b[1] = middleY + (b[1] - middleY) * keep;
+    }
+
+    double minX = quad[0][0], maxX = quad[0][0], minY = quad[0][1], maxY = quad[0][1];
+    for (int i = 1; i < 4; i++) {
+        minX = std::min(minX, quad[i][0]);
+        maxX = std::max(maxX, quad[i][0]);
+        minY = std::min(minY, quad[i][1]);
+        maxY = std::max(maxY, quad[i][1]);
+    }
+    for (int i = 0; i < 4; i++) {
+        quad[i][0] += degradation.margin - minX;
+        quad[i][1] += degradation.margin - minY;
+    }
+    image.width = static_cast<int>(std::ceil(maxX - minX)) + 2 * degradation.margin;
+    image.height = static_cast<int>(std::ceil(maxY - minY)) + 2 * degradation.margin;
+
+    Homography toImage = Homography::SquareToQuad(quad);
+    Homography toSquare = toImage.Inverse();
+
+    const double symbolCorners[4][2] = {
+        { quietZone / planeWidth, quietZone / planeHeight },
+        { 1 - quietZone / planeWidth, quietZone / planeHeight },
+        { 1 - quietZone / planeWidth, 1 - quietZone / planeHeight },
+        { quietZone / planeWidth, 1 - quietZone / planeHeight },
+    };
+    for (int i = 0; i < 4; i++) {
+        toImage.Map(symbolCorners[i][0], symbolCorners[i][1], image.corners[i][0], image.corners[i][1]);
+    }
+
+    // Fraction of each pixel covered by light modules
+    const int samples = 4;
+    std::vector<float> light(static_cast<size_t>(image.width) * image.height);
+    for (int y = 0; y < image.height; y++) {
+        for (int x = 0; x < image.width; x++) {
+            int lightSamples = 0;
+            for (int sy = 0; sy < samples; sy++) {
+                for (int sx = 0; sx < samples; sx++) {
+                    double s, t;
+                    toSquare.Map(x + (sx + 0.5) / samples, y + (sy + 0.5) / samples, s, t);
+                    int column = static_cast<int>(std::floor(s * planeWidth)) - quietZone;
+                    int row = static_cast<int>(std::floor(t * planeHeight)) - quietZone;
+                    bool dark = column >= 0 && column < grid.width && row >= 0 && row < symbolHeight &&
+                                grid.At(column, grid.linear ? 0 : row);
+                    lightSamples += dark ? 0 : 1;
+                }
+            }
+            light[static_cast<size_t>(y) * image.width + x] = static_cast<float>(lightSamples) / (samples * samples);
+        }
+    }
+
+    if (degradation.blur > 0) {
+        GaussianBlur(light, image.width, image.height, degradation.blur);
+    }
+
+    double darkLevel = 127.5 * (1 - degradation.contrast);
+    double range = 255 - 2 * darkLevel;
+    image.pixels.resize(light.size());
+    for (size_t i = 0; i < light.size(); i++) {
+        double value = darkLevel + range * light[i];
+        if (degradation.noise > 0) {
+            value += random.Gaussian(0, degradation.noise);
+        }
+        image.pixels[i] = static_cast<uint8_t>(std::min(255.0, std::max(0.0, std::round(value))));
+    }
+}
+
+}
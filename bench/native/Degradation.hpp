@@ -0,0 +1,47 @@
+#ifndef Degradation_hpp
+#define Degradation_hpp
+
+#include <stdint.h>
+#include <vector>
+#include "SyntheticBarcodes.hpp"
+
+namespace BKBench {
+
+/**
+ * @brief Capture conditions applied when rendering a symbol.
+ */
+struct Degradation {
+    double moduleSize = 4;     /**< Pixels per module before perspective. */
+    double rotation = 0;       /**< Degrees, counterclockwise. */
+    double perspective = 0;    /**< Relative shrink of the far edge, 0 for a frontal view. */
+    double blur = 0;           /**< Gaussian sigma in pixels, 0 for none. */
+    double noise = 0;          /**< Gaussian noise deviation in gray levels, 0 for none. */
+    double contrast = 1;       /**< Dark to light difference as a fraction of the full range. */
+    int margin = 16;           /**< Light pixels around the symbol's quiet zone. */
+};
+
+/**
+ * @brief A rendered grayscale image and where the symbol lies in it.
+ */
+struct RenderedImage {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels;  /**< Row-major, one byte per pixel. */
+    double corners[4][2];         /**< Symbol corners without quiet zone: top left, top right, bottom right, bottom left. */
+};
+
+/**
+ * @brief Renders a symbol under the given degradation.
+ *
+ * The symbol is mapped by a homography, sampled with 4x4 supersampling,
+ * then blurred, scaled to the contrast range and overlaid with noise.
+ * @param grid Encoded modules.
+ * @param degradation Capture conditions.
+ * @param random Source of the perspective direction and the noise.
+ * @param image Receives the pixels and corner ground truth.
+ */
+void Render(const ModuleGrid &grid, const Degradation &degradation, Random &random, RenderedImage &image);
+
+}
+
+#endif /* Degradation_hpp */
@@ -0,0 +1,832 @@
+#include "SyntheticBarcodes.hpp"
+#include <stdlib.h>
+#include <algorithm>
+#include <cmath>
+
+namespace BKBench {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Random
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+uint64_t Random::Next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+int Random::Int(int low, int high) {
+    return low + static_cast<int>(Next() % static_cast<uint64_t>(high - low + 1));
+}
+
+double Random::Uniform(double low, double high) {
+    return low + (high - low) * (Next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+double Random::Gaussian(double mean, double deviation) {
+    // Box-Muller, one value per call keeps the sequence independent of call order
+    double u1 = Uniform(1e-12, 1.0);
+    double u2 = Uniform(0.0, 1.0);
+    return mean + deviation * std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Names and content
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *const kSymbologyNames[] = { "QR", "Code128", "Ean13", "Datamatrix", "ITF14" };
+
+const char *SymbologyName(Symbology symbology) {
+    return kSymbologyNames[static_cast<int>(symbology)];
+}
+
+bool ParseSymbology(const std::string &name, Symbology &symbology) {
+    for (int i = 0; i < static_cast<int>(Symbology::Count); i++) {
+        if (name == kSymbologyNames[i]) {
+            symbology = static_cast<Symbology>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+static std::string RandomDigits(Random &random, int count) {
+    std::string digits;
+    for (int i = 0; i < count; i++) {
+        digits += static_cast<char>('0' + random.Int(0, 9));
+    }
+    return digits;
+}
+
+/**
+ * Check digit of EAN-13 and ITF-14: weights 3 and 1 alternating from the rightmost data digit
+ */
+static char Mod10CheckDigit(const std::string &digits) {
+    int sum = 0;
+    for (size_t i = 0; i < digits.size(); i++) {
+        int weight = (digits.size() - i) % 2 == 1 ? 3 : 1;
+        sum += (digits[i] - '0') * weight;
+    }
+    return static_cast<char>('0' + (10 - sum % 10) % 10);
+}
+
+std::string RandomContent(Symbology symbology, Random &random) {
+    static const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-./:";
+
+    switch (symbology) {
+        case Symbology::Ean13: {
+            // A leading zero would make the symbol a UPC-A, which decoders report under that type
+            std::string digits = static_cast<char>('0' + random.Int(1, 9)) + RandomDigits(random, 11);
+            return digits + Mod10CheckDigit(digits);
+        }
+        case Symbology::ITF14: {
+            std::string digits = RandomDigits(random, 13);
+            return digits + Mod10CheckDigit(digits);
+        }
+        default: {
+            int length = symbology == Symbology::QR ? random.Int(8, 60) : random.Int(6, 20);
+            std::string text;
+            for (int i = 0; i < length; i++) {
+                text += kAlphabet[random.Int(0, static_cast<int>(sizeof(kAlphabet)) - 2)];
+            }
+            return text;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Linear symbols
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Append alternating bars and spaces, starting with a bar, from module widths
+ */
+static void AppendWidths(std::vector<uint8_t> &modules, const char *widths) {
+    for (int i = 0; widths[i]; i++) {
+        modules.insert(modules.end(), widths[i] - '0', i % 2 == 0 ? 1 : 0);
+    }
+}
+
+static void LinearGrid(const std::vector<uint8_t> &modules, ModuleGrid &grid) {
+    grid.width = static_cast<int>(modules.size());
+    grid.height = 1;
+    grid.quietZone = 10;
+    grid.linear = true;
+    grid.dark = modules;
+}
+
+static const char *const kCode128Patterns[107] = {
+    "212222", "222122", "222221", "121223", "121322", "131222", "122213", "122312", "132212", "221213",
+    "221312", "231212", "112232", "122132", "122231", "113222", "123122", "123221", "223211", "221132",
+    "221231", "213212", "223112", "312131", "311222", "321122", "321221", "312212", "322112", "322211",
+    "212123", "212321", "232121", "111323", "131123", "131321", "112313", "132113", "132311", "211313",
+    "231113", "231311", "112133", "112331", "132131", "113123", "113321", "133121", "313121", "211331",
+    "231131", "213113", "213311", "213131", "311123", "311321", "331121", "312113", "312311", "332111",
+    "314111", "221411", "431111", "111224", "111422", "121124", "121421", "141122", "141221", "112214",
+    "112412", "122114", "122411", "142112", "142211", "241211", "221114", "413111", "241112", "134111",
+    "111242", "121142", "121241", "114212", "124112", "124211", "411212", "421112", "421211", "212141",
+    "214121", "412121", "111143", "111341", "131141", "114113", "114311", "411113", "411311", "113141",
+    "114131", "311141", "411131", "211412", "211214", "211232", "2331112"
+};
+
+/**
+ * Code 128 in code set C for even digit strings, code set B otherwise
+ */
+static bool EncodeCode128(const std::string &content, ModuleGrid &grid) {
+    const int startB = 104;
+    const int startC = 105;
+    const int stop = 106;
+
+    bool digits = !content.empty() && content.size() % 2 == 0 &&
+                  std::all_of(content.begin(), content.end(), [](char c) { return c >= '0' && c <= '9'; });
+
+    std::vector<int> values;
+    values.push_back(digits ? startC : startB);
+    if (digits) {
+        for (size_t i = 0; i < content.size(); i += 2) {
+            values.push_back((content[i] - '0') * 10 + content[i + 1] - '0');
+        }
+    } else {
+        for (char c : content) {
+            if (c < 32 || c > 126) {
+                return false;
+            }
+            values.push_back(c - 32);
+        }
+    }
+
+    int checksum = values[0];
+    for (size_t i = 1; i < values.size(); i++) {
+        checksum += static_cast<int>(i) * values[i];
+    }
+    values.push_back(checksum % 103);
+    values.push_back(stop);
+
+    std::vector<uint8_t> modules;
+    for (int value : values) {
+        AppendWidths(modules, kCode128Patterns[value]);
+    }
+    LinearGrid(modules, grid);
+    return true;
+}
+
+static const char *const kEanLeft[10] = {
+    "0001101", "0011001", "0010011", "0111101", "0100011", "0110001", "0101111", "0111011", "0110111", "0001011"
+};
+static const char *const kEanParity[10] = {
+    "LLLLLL", "LLGLGG", "LLGGLG", "LLGGGL", "LGLLGG", "LGGLLG", "LGGGLL", "LGLGLG", "LGLGGL", "LGGLGL"
+};
+
+static bool EncodeEan13(const std::string &content, ModuleGrid &grid) {
+    if (content.size() != 13 || !std::all_of(content.begin(), content.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return false;
+    }
+
+    std::vector<uint8_t> modules = { 1, 0, 1 };
+    const char *parity = kEanParity[content[0] - '0'];
+    for (int i = 1; i <= 6; i++) {
+        const char *left = kEanLeft[content[i] - '0'];
+        for (int m = 0; m < 7; m++) {
+            // G codes are the mirrored complement of the L codes
+            char bit = parity[i - 1] == 'L' ? left[m] : (left[6 - m] == '1' ? '0' : '1');
+            modules.push_back(bit == '1');
+        }
+    }
+    modules.insert(modules.end(), { 0, 1, 0, 1, 0 });
+    for (int i = 7; i <= 12; i++) {
+        const char *left = kEanLeft[content[i] - '0'];
+        for (int m = 0; m < 7; m++) {
+            modules.push_back(left[m] == '0'); // R codes are the complement of L codes
+        }
+    }
+    modules.insert(modules.end(), { 1, 0, 1 });
+
+    LinearGrid(modules, grid);
+    grid.quietZone = 11;
+    return true;
+}
+
+static const char *const kItfPatterns[10] = {
+    "NNWWN", "WNNNW", "NWNNW", "WWNNN", "NNWNW", "WNWNN", "NWWNN", "NNNWW", "WNNWN", "NWNWN"
+};
+
+/**
+ * Interleaved 2 of 5 with a wide to narrow ratio of 3
+ */
+static bool EncodeItf(const std::string &content, ModuleGrid &grid) {
+    if (content.empty() || content.size() % 2 != 0 ||
+        !std::all_of(content.begin(), content.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return false;
+    }
+
+    const int wide = 3;
+    std::vector<uint8_t> modules;
+    AppendWidths(modules, "1111");
+    for (size_t i = 0; i < content.size(); i += 2) {
+        const char *bars = kItfPatterns[content[i] - '0'];
+        const char *spaces = kItfPatterns[content[i + 1] - '0'];
+        for (int k = 0; k < 5; k++) {
+            modules.insert(modules.end(), bars[k] == 'W' ? wide : 1, 1);
+            modules.insert(modules.end(), spaces[k] == 'W' ? wide : 1, 0);
+        }
+    }
+    modules.insert(modules.end(), wide, 1);
+    modules.insert(modules.end(), 1, 0);
+    modules.insert(modules.end(), 1, 1);
+
+    LinearGrid(modules, grid);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Reed-Solomon over GF(256)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint8_t GfMultiply(uint8_t a, uint8_t b, int polynomial) {
+    int result = 0;
+    for (int i = 7; i >= 0; i--) {
+        result = (result << 1) ^ ((result >> 7) * polynomial);
+        result ^= ((b >> i) & 1) * a;
+    }
+    return static_cast<uint8_t>(result);
+}
+
+/**
+ * Error correction codewords for data, with generator roots a^firstRoot ... a^(firstRoot + count - 1)
+ */
+static std::vector<uint8_t> ReedSolomon(const std::vector<uint8_t> &data, int count, int polynomial, int firstRoot) {
+    // Generator coefficients, highest degree first, leading 1 omitted
+    std::vector<uint8_t> generator(count, 0);
+    generator[count - 1] = 1;
+    uint8_t root = 1;
+    for (int i = 0; i < firstRoot; i++) {
+        root = GfMultiply(root, 2, polynomial);
+    }
+    for (int i = 0; i < count; i++) {
+        for (int j = 0; j < count; j++) {
+            generator[j] = GfMultiply(generator[j], root, polynomial);
+            if (j + 1 < count) {
+                generator[j] ^= generator[j + 1];
+            }
+        }
+        root = GfMultiply(root, 2, polynomial);
+    }
+
+    std::vector<uint8_t> remainder(count, 0);
+    for (uint8_t byte : data) {
+        uint8_t factor = byte ^ remainder[0];
+        remainder.erase(remainder.begin());
+        remainder.push_back(0);
+        for (int i = 0; i < count; i++) {
+            remainder[i] ^= GfMultiply(generator[i], factor, polynomial);
+        }
+    }
+    return remainder;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// QR Code, byte mode, error correction level M, versions 1-10
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct QrVersion {
+    int ecPerBlock;
+    int blocks1;
+    int data1;
+    int blocks2;
+    int data2;
+    int alignment[3];
+};
+
+static const QrVersion kQrVersions[10] = {
+    { 10, 1, 16, 0, 0, { 0 } },
+    { 16, 1, 28, 0, 0, { 6, 18 } },
+    { 26, 1, 44, 0, 0, { 6, 22 } },
+    { 18, 2, 32, 0, 0, { 6, 26 } },
+    { 24, 2, 43, 0, 0, { 6, 30 } },
+    { 16, 4, 27, 0, 0, { 6, 34 } },
+    { 18, 4, 31, 0, 0, { 6, 22, 38 } },
+    { 22, 2, 38, 2, 39, { 6, 24, 42 } },
+    { 22, 3, 36, 2, 37, { 6, 26, 46 } },
+    { 26, 4, 43, 1, 44, { 6, 28, 50 } },
+};
+
+class QrMatrix {
+public:
+    explicit QrMatrix(int version) : size(version * 4 + 17), dark(size * size, 0), function(size * size, 0) {}
+
+    void Set(int x, int y, bool value) {
+        dark[y * size + x] = value;
+        function[y * size + x] = 1;
+    }
+
+    bool IsFunction(int x, int y) const { return function[y * size + x] != 0; }
+
+    int size;
+    std::vector<uint8_t> dark;
+    std::vector<uint8_t> function;
+};
+
+static void DrawQrFunctionPatterns(QrMatrix &matrix, int version) {
+    int size = matrix.size;
+
+    for (int i = 0; i < size; i++) {
+        matrix.Set(6, i, i % 2 == 0);
+        matrix.Set(i, 6, i % 2 == 0);
+    }
+
+    const int finders[3][2] = { { 3, 3 }, { size - 4, 3 }, { 3, size - 4 } };
+    for (const auto &finder : finders) {
+        for (int dy = -4; dy <= 4; dy++) {
+            for (int dx = -4; dx <= 4; dx++) {
+                int x = finder[0] + dx;
+                int y = finder[1] + dy;
+                if (x >= 0 && x < size && y >= 0 && y < size) {
+                    int distance = std::max(abs(dx), abs(dy));
+                    matrix.Set(x, y, distance != 2 && distance != 4);
+                }
+            }
+        }
+    }
+
+    const int *positions = kQrVersions[version - 1].alignment;
+    int count = version == 1 ? 0 : (version < 7 ? 2 : 3);
+    for (int i = 0; i < count; i++) {
+        for (int j = 0; j < count; j++) {
+            if ((i == 0 && j == 0) || (i == 0 && j == count - 1) || (i == count - 1 && j == 0)) {
+                continue;
+            }
+            for (int dy = -2; dy <= 2; dy++) {
+                for (int dx = -2; dx <= 2; dx++) {
+                    matrix.Set(positions[i] + dx, positions[j] + dy, std::max(abs(dx), abs(dy)) != 1);
+                }
+            }
+        }
+    }
+
+    if (version >= 7) {
+        int remainder = version;
+        for (int i = 0; i < 12; i++) {
+            remainder = (remainder << 1) ^ ((remainder >> 11) * 0x1F25);
+        }
+        int bits = version << 12 | remainder;
+        for (int i = 0; i < 18; i++) {
+            bool bit = (bits >> i) & 1;
+            int a = size - 11 + i % 3;
+            int b = i / 3;
+            matrix.Set(a, b, bit);
+            matrix.Set(b, a, bit);
+        }
+    }
+}
+
+static void DrawQrFormatBits(QrMatrix &matrix, int mask) {
+    const int levelM = 0;
+    int data = levelM << 3 | mask;
+    int remainder = data;
+    for (int i = 0; i < 10; i++) {
+        remainder = (remainder << 1) ^ ((remainder >> 9) * 0x537);
+    }
+    int bits = (data << 10 | remainder) ^ 0x5412;
+    int size = matrix.size;
+    auto bit = [&](int i) { return ((bits >> i) & 1) != 0; };
+
+    for (int i = 0; i <= 5; i++) {
+        matrix.Set(8, i, bit(i));
+    }
+    matrix.Set(8, 7, bit(6));
+    matrix.Set(8, 8, bit(7));
+    matrix.Set(7, 8, bit(8));
+    for (int i = 9; i < 15; i++) {
+        matrix.Set(14 - i, 8, bit(i));
+    }
+
+    for (int i = 0; i < 8; i++) {
+        matrix.Set(size - 1 - i, 8, bit(i));
+    }
+    for (int i = 8; i < 15; i++) {
+        matrix.Set(8, size - 15 + i, bit(i));
+    }
+    matrix.Set(8, size - 8, true);
+}
+
+static bool QrMaskBit(int mask, int x, int y) {
+    switch (mask) {
+        case 0: return (x + y) % 2 == 0;
+        case 1: return y % 2 == 0;
+        case 2: return x % 3 == 0;
+        case 3: return (x + y) % 3 == 0;
+        case 4: return (x / 3 + y / 2) % 2 == 0;
+        case 5: return x * y % 2 + x * y % 3 == 0;
+        case 6: return (x * y % 2 + x * y % 3) % 2 == 0;
+        default: return ((x + y) % 2 + x * y % 3) % 2 == 0;
+    }
+}
+
+static void ApplyQrMask(QrMatrix &matrix, int mask) {
+    for (int y = 0; y < matrix.size; y++) {
+        for (int x = 0; x < matrix.size; x++) {
+            if (!matrix.IsFunction(x, y) && QrMaskBit(mask, x, y)) {
+                matrix.dark[y * matrix.size + x] ^= 1;
+            }
+        }
+    }
+}
+
+/**
+ * Mask penalty of ISO 18004 section 7.8.3: runs, 2x2 blocks, finder-like patterns and dark balance
+ */
+static int QrPenalty(const QrMatrix &matrix) {
+    int size = matrix.size;
+    int penalty = 0;
+    auto at = [&](int x, int y, bool vertical) { return matrix.dark[vertical ? x * size + y : y * size + x] != 0; };
+
+    for (int vertical = 0; vertical < 2; vertical++) {
+        for (int y = 0; y < size; y++) {
+            int run = 1;
+            for (int x = 1; x <= size; x++) {
+                if (x < size && at(x, y, vertical) == at(x - 1, y, vertical)) {
+                    run++;
+                    continue;
+                }
+                if (run >= 5) {
+                    penalty += run - 2;
+                }
+                run = 1;
+            }
+
+            for (int x = 0; x + 11 <= size; x++) {
+                static const uint8_t finderA[11] = { 1, 0, 1, 1, 1, 0, 1, 0, 0, 0, 0 };
+                static const uint8_t finderB[11] = { 0, 0, 0, 0, 1, 0, 1, 1, 1, 0, 1 };
+                bool matchA = true;
+                bool matchB = true;
+                for (int k = 0; k < 11; k++) {
+                    matchA = matchA && at(x + k, y, vertical) == (finderA[k] != 0);
+                    matchB = matchB && at(x + k, y, vertical) == (finderB[k] != 0);
+                }
+                penalty += (matchA ? 40 : 0) + (matchB ? 40 : 0);
+            }
+        }
+    }
+
+    int darkCount = 0;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            darkCount += matrix.dark[y * size + x];
+            if (x + 1 < size && y + 1 < size) {
+                uint8_t color = matrix.dark[y * size + x];
+                if (color == matrix.dark[y * size + x + 1] && color == matrix.dark[(y + 1) * size + x] &&
+                    color == matrix.dark[(y + 1) * size + x + 1]) {
+                    penalty += 3;
+                }
+            }
+        }
+    }
+    int percent = darkCount * 100 / (size * size);
+    penalty += abs(percent - 50) / 5 * 10;
+    return penalty;
+}
+
+static bool EncodeQr(const std::string &content, ModuleGrid &grid) {
+    int version = 0;
+    for (int v = 1; v <= 10; v++) {
+        const QrVersion &info = kQrVersions[v - 1];
+        int capacityBits = (info.blocks1 * info.data1 + info.blocks2 * info.data2) * 8;
+        int countBits = v < 10 ? 8 : 16;
+        if (4 + countBits + static_cast<int>(content.size()) * 8 <= capacityBits) {
+            version = v;
+            break;
+        }
+    }
+    if (version == 0) {
+        return false;
+    }
+
+    const QrVersion &info = kQrVersions[version - 1];
+    int dataCodewords = info.blocks1 * info.data1 + info.blocks2 * info.data2;
+
+    // Bit stream: byte mode indicator, character count, data, terminator, padding
+    std::vector<uint8_t> bits;
+    auto append = [&](int value, int length) {
+        for (int i = length - 1; i >= 0; i--) {
+            bits.push_back((value >> i) & 1);
+        }
+    };
+    append(0x4, 4);
+    append(static_cast<int>(content.size()), version < 10 ? 8 : 16);
+    for (unsigned char c : content) {
+        append(c, 8);
+    }
+    append(0, std::min(4, dataCodewords * 8 - static_cast<int>(bits.size())));
+    while (bits.size() % 8 != 0) {
+        bits.push_back(0);
+    }
+
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < bits.size(); i += 8) {
+        int byte = 0;
+        for (int k = 0; k < 8; k++) {
+            byte = byte << 1 | bits[i + k];
+        }
+        data.push_back(static_cast<uint8_t>(byte));
+    }
+    for (int pad = 0; static_cast<int>(data.size()) < dataCodewords; pad++) {
+        data.push_back(pad % 2 == 0 ? 0xEC : 0x11);
+    }
+
+    // Split into blocks, add error correction, interleave
+    std::vector<std::vector<uint8_t>> dataBlocks;
+    std::vector<std::vector<uint8_t>> ecBlocks;
+    size_t offset = 0;
+    for (int b = 0; b < info.blocks1 + info.blocks2; b++) {
+        int length = b < info.blocks1 ? info.data1 : info.data2;
+        dataBlocks.emplace_back(data.begin() + offset, data.begin() + offset + length);
+        ecBlocks.push_back(ReedSolomon(dataBlocks.back(), info.ecPerBlock, 0x11D, 0));
+        offset += length;
+    }
+
+    std::vector<uint8_t> codewords;
+    int longest = std::max(info.data1, info.data2);
+    for (int i = 0; i < longest; i++) {
+        for (const auto &block : dataBlocks) {
+            if (i < static_cast<int>(block.size())) {
+                codewords.push_back(block[i]);
+            }
+        }
+    }
+    for (int i = 0; i < info.ecPerBlock; i++) {
+        for (const auto &block : ecBlocks) {
+            codewords.push_back(block[i]);
+        }
+    }
+
+    QrMatrix matrix(version);
+    DrawQrFunctionPatterns(matrix, version);
+    DrawQrFormatBits(matrix, 0); // Reserves the format areas
+
+    size_t bit = 0;
+    int size = matrix.size;
+    for (int right = size - 1; right >= 1; right -= 2) {
+        if (right == 6) {
+            right = 5;
+        }
+        for (int vertical = 0; vertical < size; vertical++) {
+            for (int j = 0; j < 2; j++) {
+                int x = right - j;
+                bool upward = ((right + 1) & 2) == 0;
+                int y = upward ? size - 1 - vertical : vertical;
+                if (!matrix.IsFunction(x, y) && bit < codewords.size() * 8) {
+                    matrix.dark[y * size + x] = (codewords[bit >> 3] >> (7 - (bit & 7))) & 1;
+                    bit++;
+                }
+            }
+        }
+    }
+
+    int bestMask = 0;
+    int bestPenalty = -1;
+    for (int mask = 0; mask < 8; mask++) {
+        QrMatrix candidate = matrix;
+        ApplyQrMask(candidate, mask);
+        DrawQrFormatBits(candidate, mask);
+        int penalty = QrPenalty(candidate);
+        if (bestPenalty < 0 || penalty < bestPenalty) {
+            bestPenalty = penalty;
+            bestMask = mask;
+        }
+    }
+    ApplyQrMask(matrix, bestMask);
+    DrawQrFormatBits(matrix, bestMask);
+
+    grid.width = size;
+    grid.height = size;
+    grid.quietZone = 4;
+    grid.linear = false;
+    grid.dark = matrix.dark;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Data Matrix ECC 200, ASCII encodation, square single-region sizes 10x10 - 26x26
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct DatamatrixSize {
+    int size;
+    int dataCodewords;
+    int ecCodewords;
+};
+
+static const DatamatrixSize kDatamatrixSizes[] = {
+    { 10, 3, 5 }, { 12, 5, 7 }, { 14, 8, 10 }, { 16, 12, 12 }, { 18, 18, 14 },
+    { 20, 22, 18 }, { 22, 30, 20 }, { 24, 36, 24 }, { 26, 44, 28 },
+};
+
+/**
+ * Module placement of ISO 16022 Annex F. Each entry holds 10 * codeword + bit, or 1 for a fixed dark module.
+ */
+class DatamatrixPlacement {
+public:
+    DatamatrixPlacement(int rows, int columns) : rows(rows), columns(columns), cells(rows * columns, 0) {
+        int codeword = 1;
+        int row = 4;
+        int column = 0;
+        do {
+            if (row == rows && column == 0) {
+                Corner1(codeword++);
+            }
+            if (row == rows - 2 && column == 0 && columns % 4 != 0) {
+                Corner2(codeword++);
+            }
+            if (row == rows - 2 && column == 0 && columns % 8 == 4) {
+                Corner3(codeword++);
+            }
+            if (row == rows + 4 && column == 2 && columns % 8 == 0) {
+                Corner4(codeword++);
+            }
+            do {
+                if (row < rows && column >= 0 && !cells[row * columns + column]) {
+                    Utah(row, column, codeword++);
+                }
+                row -= 2;
+                column += 2;
+            } while (row >= 0 && column < columns);
+            row += 1;
+            column += 3;
+            do {
+                if (row >= 0 && column < columns && !cells[row * columns + column]) {
+                    Utah(row, column, codeword++);
+                }
+                row += 2;
+                column -= 2;
+            } while (row < rows && column >= 0);
+            row += 3;
+            column += 1;
+        } while (row < rows || column < columns);
+
+        if (!cells[rows * columns - 1]) {
+            cells[rows * columns - 1] = 1;
+            cells[rows * columns - columns - 2] = 1;
+        }
+    }
+
+    bool Dark(int row, int column, const std::vector<uint8_t> &codewords) const {
+        int cell = cells[row * columns + column];
+        if (cell < 10) {
+            return cell == 1;
+        }
+        int codeword = cell / 10 - 1;
+        int bit = cell % 10;
+        return (codewords[codeword] >> (8 - bit)) & 1;
+    }
+
+private:
+    void Module(int row, int column, int codeword, int bit) {
+        if (row < 0) {
+            row += rows;
+            column += 4 - ((rows + 4) % 8);
+        }
+        if (column < 0) {
+            column += columns;
+            row += 4 - ((columns + 4) % 8);
+        }
+        cells[row * columns + column] = 10 * codeword + bit;
+    }
+
+    void Utah(int row, int column, int codeword) {
+        Module(row - 2, column - 2, codeword, 1);
+        Module(row - 2, column - 1, codeword, 2);
+        Module(row - 1, column - 2, codeword, 3);
+        Module(row - 1, column - 1, codeword, 4);
+        Module(row - 1, column, codeword, 5);
+        Module(row, column - 2, codeword, 6);
+        Module(row, column - 1, codeword, 7);
+        Module(row, column, codeword, 8);
+    }
+
+    void Corner1(int codeword) {
+        Module(rows - 1, 0, codeword, 1);
+        Module(rows - 1, 1, codeword, 2);
+        Module(rows - 1, 2, codeword, 3);
+        Module(0, columns - 2, codeword, 4);
+        Module(0, columns - 1, codeword, 5);
+        Module(1, columns - 1, codeword, 6);
+        Module(2, columns - 1, codeword, 7);
+        Module(3, columns - 1, codeword, 8);
+    }
+
+    void Corner2(int codeword) {
+        Module(rows - 3, 0, codeword, 1);
+        Module(rows - 2, 0, codeword, 2);
+        Module(rows - 1, 0, codeword, 3);
+        Module(0, columns - 4, codeword, 4);
+        Module(0, columns - 3, codeword, 5);
+        Module(0, columns - 2, codeword, 6);
+        Module(0, columns - 1, codeword, 7);
+        Module(1, columns - 1, codeword, 8);
+    }
+
+    void Corner3(int codeword) {
+        Module(rows - 3, 0, codeword, 1);
+        Module(rows - 2, 0, codeword, 2);
+        Module(rows - 1, 0, codeword, 3);
+        Module(0, columns - 2, codeword, 4);
+        Module(0, columns - 1, codeword, 5);
+        Module(1, columns - 1, codeword, 6);
+        Module(2, columns - 1, codeword, 7);
+        Module(3, columns - 1, codeword, 8);
+    }
+
+    void Corner4(int codeword) {
+        Module(rows - 1, 0, codeword, 1);
+        Module(rows - 1, columns - 1, codeword, 2);
+        Module(0, columns - 3, codeword, 3);
+        Module(0, columns - 2, codeword, 4);
+        Module(0, columns - 1, codeword, 5);
+        Module(1, columns - 3, codeword, 6);
+        Module(1, columns - 2, codeword, 7);
+        Module(1, columns - 1, codeword, 8);
+    }
+
+    int rows;
+    int columns;
+    std::vector<int> cells;
+};
+
+static bool EncodeDatamatrix(const std::string &content, ModuleGrid &grid) {
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < content.size(); i++) {
+        unsigned char c = content[i];
+        if (c > 127) {
+            return false;
+        }
+        if (isdigit(c) && i + 1 < content.size() && isdigit(static_cast<unsigned char>(content[i + 1]))) {
+            data.push_back(static_cast<uint8_t>(130 + (c - '0') * 10 + content[i + 1] - '0'));
+            i++;
+        } else {
+            data.push_back(static_cast<uint8_t>(c + 1));
+        }
+    }
+
+    const DatamatrixSize *size = nullptr;
+    for (const DatamatrixSize &candidate : kDatamatrixSizes) {
+        if (static_cast<int>(data.size()) <= candidate.dataCodewords) {
+            size = &candidate;
+            break;
+        }
+    }
+    if (!size) {
+        return false;
+    }
+
+    // First pad is 129, later pads are scrambled by their position
+    if (static_cast<int>(data.size()) < size->dataCodewords) {
+        data.push_back(129);
+    }
+    while (static_cast<int>(data.size()) < size->dataCodewords) {
+        int position = static_cast<int>(data.size()) + 1;
+        int pad = 129 + ((149 * position) % 253) + 1;
+        data.push_back(static_cast<uint8_t>(pad > 254 ? pad - 254 : pad));
+    }
+
+    std::vector<uint8_t> codewords = data;
+    std::vector<uint8_t> ec = ReedSolomon(data, size->ecCodewords, 0x12D, 1);
+    codewords.insert(codewords.end(), ec.begin(), ec.end());
+
+    int regionSize = size->size - 2;
+    DatamatrixPlacement placement(regionSize, regionSize);
+
+    grid.width = size->size;
+    grid.height = size->size;
+    grid.quietZone = 2;
+    grid.linear = false;
+    grid.dark.assign(static_cast<size_t>(size->size) * size->size, 0);
+    for (int y = 0; y < size->size; y++) {
+        for (int x = 0; x < size->size; x++) {
+            bool dark;
+            if (x == 0 || y == size->size - 1) {
+                dark = true; // Solid L finder
+            } else if (y == 0) {
+                dark = x % 2 == 0; // Clock track along the top
+            } else if (x == size->size - 1) {
+                dark = y % 2 == 1; // Clock track along the right
+            } else {
+                dark = placement.Dark(y - 1, x - 1, codewords);
+            }
+            grid.dark[static_cast<size_t>(y) * size->size + x] = dark;
+        }
+    }
+    return true;
+}
+
+bool Encode(Symbology symbology, const std::string &content, ModuleGrid &grid) {
+    switch (symbology) {
+        case Symbology::QR: return EncodeQr(content, grid);
+        case Symbology::Code128: return EncodeCode128(content, grid);
+        case Symbology::Ean13: return EncodeEan13(content, grid);
+        case Symbology::Datamatrix: return EncodeDatamatrix(content, grid);
+        case Symbology::ITF14: return EncodeItf(content, grid);
+        default: return false;
+    }
+}
+
+}
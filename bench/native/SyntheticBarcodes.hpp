@@ -0,0 +1,97 @@
+#ifndef SyntheticBarcodes_hpp
+#define SyntheticBarcodes_hpp
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace BKBench {
+
+/**
+ * @brief Symbologies the corpus generator can render.
+ */
+enum class Symbology {
+    QR = 0,
+    Code128,
+    Ean13,
+    Datamatrix,
+    ITF14,
+    Count
+};
+
+/**
+ * @brief Grid of modules of an encoded symbol, without quiet zone.
+ *
+ * Linear symbols have a single row that is stretched to the bar height when rendered.
+ */
+struct ModuleGrid {
+    int width = 0;
+    int height = 0;
+    int quietZone = 0;          /**< Light modules required around the symbol. */
+    bool linear = false;
+    std::vector<uint8_t> dark;  /**< Row-major, 1 for a dark module. */
+
+    bool At(int x, int y) const { return dark[static_cast<size_t>(y) * width + x] != 0; }
+};
+
+/**
+ * @brief Small deterministic random generator (SplitMix64).
+ *
+ * Used instead of <random> distributions, whose output differs between
+ * standard libraries, so a seed gives the same corpus everywhere.
+ */
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint64_t Next();
+
+    /**
+     * @brief Gets a uniform integer in [low, high].
+     */
+    int Int(int low, int high);
+
+    /**
+     * @brief Gets a uniform double in [low, high).
+     */
+    double Uniform(double low, double high);
+
+    /**
+     * @brief Gets a normally distributed double.
+     */
+    double Gaussian(double mean, double deviation);
+
+private:
+    uint64_t state;
+};
+
+/**
+ * @brief Gets the name of a symbology, matching the decoder constant names.
+ */
+const char *SymbologyName(Symbology symbology);
+
+/**
+ * @brief Parses a symbology name.
+ * @return False when the name is unknown.
+ */
+bool ParseSymbology(const std::string &name, Symbology &symbology);
+
+/**
+ * @brief Generates content valid for a symbology.
+ *
+ * EAN-13 and ITF-14 content includes the check digit.
+ */
+std::string RandomContent(Symbology symbology, Random &random);
+
+/**
+ * @brief Encodes content as modules.
+ * @param symbology The symbology.
+ * @param content Content from RandomContent, or any text the symbology can hold.
+ * @param grid Receives the modules.
+ * @return False when the content cannot be encoded.
+ */
+bool Encode(Symbology symbology, const std::string &content, ModuleGrid &grid);
+
+}
+
+#endif /* SyntheticBarcodes_hpp */
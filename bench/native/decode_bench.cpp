@@ -0,0 +1,491 @@
+/**
+ * Native decode benchmark
+ *
+ * Calls Barkoder::DecodeImageMemory directly, without Node or the addon,
+ * across a matrix of symbology x resolution x decoding speed x thread count,
+ * and reports latency, throughput and heap allocations per decode.
+ *
+ * Build: npm run bench:native (node-gyp rebuild --build_native_bench=true)
+ * Usage: build/Release/barkoder_bench [options]
+ *   --image FILE:DECODER   24-bit BMP or binary PGM and the decoder for its barcode (repeatable, default examples/qr.bmp:QR)
+ *   --resolutions LIST     Canvas sizes the image is centered on, e.g. 640x480,1920x1080
+ *   --speeds LIST          Decoding speeds 0-3 (Fast, Normal, Slow, Rigorous)
+ *   --threads LIST         Concurrent decoding threads
+ *   --iterations N         Timed decodes per thread and case (default 20)
+ *   --license KEY          License key (default: BARKODER_LICENSE_KEY environment variable)
+ *   --json                 Print results as JSON instead of a table
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Barkoder.hpp"
+#include "Config.hpp"
+
+using namespace NSBarkoder;
+
+typedef std::chrono::steady_clock Clock;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Allocation counting
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Counts every operator new in the process, including the SDK's. malloc calls made directly are not seen.
+static std::atomic<uint64_t> allocationCount{0};
+static std::atomic<uint64_t> allocationBytes{0};
+
+static void *CountedAllocate(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    void *pointer = malloc(size ? size : 1);
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void *operator new(size_t size) { return CountedAllocate(size); }
+void *operator new[](size_t size) { return CountedAllocate(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    try { return CountedAllocate(size); } catch (...) { return nullptr; }
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    try { return CountedAllocate(size); } catch (...) { return nullptr; }
+}
+void operator delete(void *pointer) noexcept { free(pointer); }
+void operator delete[](void *pointer) noexcept { free(pointer); }
+void operator delete(void *pointer, size_t) noexcept { free(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { free(pointer); }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Inputs
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct Image {
+    std::string name;
+    DecoderType decoder;
+    std::vector<uint8_t> pixels;
+    int width = 0;
+    int height = 0;
+};
+
+struct Resolution {
+    int width;
+    int height;
+};
+
+struct Options {
+    std::vector<Image> images;
+    std::vector<Resolution> resolutions = { {640, 480}, {1280, 720}, {1920, 1080}, {3840, 2160} };
+    std::vector<int> speeds = { 0, 1, 2, 3 };
+    std::vector<int> threads = { 1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) };
+    int iterations = 20;
+    std::string license;
+    bool json = false;
+};
+
+static const struct {
+    const char *name;
+    DecoderType type;
+} kDecoderNames[] = {
+    { "Aztec", DecoderType::Aztec }, { "AztecCompact", DecoderType::AztecCompact }, { "QR", DecoderType::QR },
+    { "QRMicro", DecoderType::QRMicro }, { "Code128", DecoderType::Code128 }, { "Code93", DecoderType::Code93 },
+    { "Code39", DecoderType::Code39 }, { "Codabar", DecoderType::Codabar }, { "Code11", DecoderType::Code11 },
+    { "Msi", DecoderType::Msi }, { "UpcA", DecoderType::UpcA }, { "UpcE", DecoderType::UpcE },
+    { "UpcE1", DecoderType::UpcE1 }, { "Ean13", DecoderType::Ean13 }, { "Ean8", DecoderType::Ean8 },
+    { "PDF417", DecoderType::PDF417 }, { "PDF417Micro", DecoderType::PDF417Micro },
+    { "Datamatrix", DecoderType::Datamatrix }, { "Code25", DecoderType::Code25 },
+    { "Interleaved25", DecoderType::Interleaved25 }, { "ITF14", DecoderType::ITF14 },
+    { "IATA25", DecoderType::IATA25 }, { "Matrix25", DecoderType::Matrix25 },
+    { "Datalogic25", DecoderType::Datalogic25 }, { "COOP25", DecoderType::COOP25 },
+    { "Code32", DecoderType::Code32 }, { "Telepen", DecoderType::Telepen }, { "Dotcode", DecoderType::Dotcode },
+    { "Databar14", DecoderType::Databar14 }, { "DatabarLimited", DecoderType::DatabarLimited },
+    { "DatabarExpanded", DecoderType::DatabarExpanded }, { "MaxiCode", DecoderType::MaxiCode },
+};
+
+static bool ParseDecoder(const std::string &name, DecoderType &type) {
+    for (const auto &entry : kDecoderNames) {
+        if (name == entry.name) {
+            type = entry.type;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Load a 24-bit BMP as 8-bit grayscale, top row first
+ */
+static bool LoadBmp(const std::string &path, Image &image) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < 54 || data[0] != 'B' || data[1] != 'M') {
+        return false;
+    }
+
+    auto read32 = [&](size_t offset) {
+        return static_cast<int32_t>(data[offset] | data[offset + 1] << 8 | data[offset + 2] << 16 | data[offset + 3] << 24);
+    };
+    int offset = read32(10);
+    int width = read32(18);
+    int height = read32(22);
+    int bitsPerPixel = data[28] | data[29] << 8;
+    int rowSize = (width * 3 + 3) / 4 * 4;
+    if (bitsPerPixel != 24 || width <= 0 || height <= 0 || data.size() < static_cast<size_t>(offset) + static_cast<size_t>(rowSize) * height) {
+        return false;
+    }
+
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; y++) {
+        const uint8_t *row = &data[offset + static_cast<size_t>(height - 1 - y) * rowSize];
+        for (int x = 0; x < width; x++) {
+            const uint8_t *bgr = row + x * 3;
+            image.pixels[static_cast<size_t>(y) * width + x] =
+                static_cast<uint8_t>(0.299 * bgr[2] + 0.587 * bgr[1] + 0.114 * bgr[0] + 0.5);
+        }
+    }
+    return true;
+}
+
+/**
+ * Load an 8-bit binary PGM, as written by barkoder_corpus
+ */
+static bool LoadPgm(const std::string &path, Image &image) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    int width = 0;
+    int height = 0;
+    int maxValue = 0;
+    bool loaded = fscanf(file, "P5 %d %d %d", &width, &height, &maxValue) == 3 && fgetc(file) != EOF &&
+                  width > 0 && height > 0 && maxValue == 255;
+    if (loaded) {
+        image.width = width;
+        image.height = height;
+        image.pixels.resize(static_cast<size_t>(width) * height);
+        loaded = fread(image.pixels.data(), 1, image.pixels.size(), file) == image.pixels.size();
+    }
+    fclose(file);
+    return loaded;
+}
+
+static bool LoadImage(const std::string &path, Image &image) {
+    bool pgm = path.size() > 4 && path.compare(path.size() - 4, 4, ".pgm") == 0;
+    return pgm ? LoadPgm(path, image) : LoadBmp(path, image);
+}
+
+/**
+ * Center an image on a white canvas, shrinking it first when it does not fit
+ */
+static std::vector<uint8_t> Place(const Image &image, const Resolution &resolution) {
+    std::vector<uint8_t> canvas(static_cast<size_t>(resolution.width) * resolution.height, 255);
+
+    double scale = std::min(1.0, std::min(static_cast<double>(resolution.width) / image.width,
+                                          static_cast<double>(resolution.height) / image.height));
+    int width = std::max(1, static_cast<int>(image.width * scale));
+    int height = std::max(1, static_cast<int>(image.height * scale));
+    int left = (resolution.width - width) / 2;
+    int top = (resolution.height - height) / 2;
+
+    for (int y = 0; y < height; y++) {
+        int sourceY = std::min(image.height - 1, static_cast<int>(y / scale));
+        for (int x = 0; x < width; x++) {
+            int sourceX = std::min(image.width - 1, static_cast<int>(x / scale));
+            canvas[static_cast<size_t>(top + y) * resolution.width + left + x] =
+                image.pixels[static_cast<size_t>(sourceY) * image.width + sourceX];
+        }
+    }
+    return canvas;
+}
+
+template <typename T>
+static std::vector<T> ParseList(const char *text, T (*parse)(const std::string &)) {
+    std::vector<T> values;
+    std::string list(text);
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        if (end > start) {
+            values.push_back(parse(list.substr(start, end - start)));
+        }
+        start = end + 1;
+    }
+    return values;
+}
+
+static int ParseInt(const std::string &text) {
+    return atoi(text.c_str());
+}
+
+static Resolution ParseResolution(const std::string &text) {
+    Resolution resolution = { 0, 0 };
+    sscanf(text.c_str(), "%dx%d", &resolution.width, &resolution.height);
+    return resolution;
+}
+
+static bool ParseOptions(int argc, char **argv, Options &options) {
+    const char *license = getenv("BARKODER_LICENSE_KEY");
+    options.license = license ? license : "";
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (arg == "--json") {
+            options.json = true;
+            continue;
+        }
+        if (!value) {
+            fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return false;
+        }
+        i++;
+
+        if (arg == "--image") {
+            std::string spec(value);
+            size_t colon = spec.rfind(':');
+            Image image;
+            if (colon == std::string::npos || !ParseDecoder(spec.substr(colon + 1), image.decoder)) {
+                fprintf(stderr, "Expected FILE:DECODER, got %s\n", value);
+                return false;
+            }
+            image.name = spec.substr(colon + 1);
+            if (!LoadImage(spec.substr(0, colon), image)) {
+                fprintf(stderr, "Cannot load 24-bit BMP or binary PGM %s\n", spec.substr(0, colon).c_str());
+                return false;
+            }
+            options.images.push_back(std::move(image));
+        } else if (arg == "--resolutions") {
+            options.resolutions = ParseList(value, ParseResolution);
+        } else if (arg == "--speeds") {
+            options.speeds = ParseList(value, ParseInt);
+        } else if (arg == "--threads") {
+            options.threads = ParseList(value, ParseInt);
+        } else if (arg == "--iterations") {
+            options.iterations = std::max(1, atoi(value));
+        } else if (arg == "--license") {
+            options.license = value;
+        } else {
+            fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+
+    if (options.images.empty()) {
+        Image image;
+        image.name = "QR";
+        image.decoder = DecoderType::QR;
+        if (!LoadBmp("examples/qr.bmp", image)) {
+            fprintf(stderr, "Cannot load examples/qr.bmp, run from the package root or pass --image\n");
+            return false;
+        }
+        options.images.push_back(std::move(image));
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Measurement
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct CaseResult {
+    std::string symbology;
+    bool allDecoders;
+    Resolution resolution;
+    int speed;
+    int threads;
+    uint64_t decodes;
+    uint64_t hits;
+    double nsPerOp;
+    double p50Ns;
+    double p99Ns;
+    double decodesPerSecond;
+    double allocationsPerOp;
+    double allocatedBytesPerOp;
+};
+
+static double Percentile(std::vector<uint64_t> &values, double quantile) {
+    if (values.empty()) {
+        return 0;
+    }
+    size_t rank = std::min(values.size() - 1, static_cast<size_t>(quantile * values.size()));
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return static_cast<double>(values[rank]);
+}
+
+/**
+ * Decode the same canvas on every thread and time each call
+ */
+static CaseResult RunCase(Config *config, const std::vector<uint8_t> &canvas, const Resolution &resolution,
+                          int threadCount, int iterations) {
+    std::vector<std::vector<uint64_t>> durations(threadCount);
+    std::vector<uint64_t> hits(threadCount, 0);
+    std::vector<std::vector<uint8_t>> inputs(threadCount, canvas);
+
+    // Untimed warmup so lazily created decoder state is not measured
+    for (int t = 0; t < threadCount; t++) {
+        Barkoder::DecodeImageMemory(config, inputs[t].data(), resolution.width, resolution.height);
+        durations[t].reserve(iterations);
+    }
+
+    std::atomic<int> ready{0};
+    uint64_t allocationsBefore = allocationCount.load();
+    uint64_t bytesBefore = allocationBytes.load();
+    Clock::time_point start;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        workers.emplace_back([&, t] {
+            ready++;
+            while (ready.load() < threadCount) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < iterations; i++) {
+                auto before = Clock::now();
+                std::vector<BaseResult> results =
+                    Barkoder::DecodeImageMemory(config, inputs[t].data(), resolution.width, resolution.height);
+                durations[t].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - before).count());
+                hits[t] += results.empty() ? 0 : 1;
+            }
+        });
+    }
+    start = Clock::now();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    double wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    CaseResult result = {};
+    std::vector<uint64_t> all;
+    uint64_t totalNs = 0;
+    for (int t = 0; t < threadCount; t++) {
+        all.insert(all.end(), durations[t].begin(), durations[t].end());
+        result.hits += hits[t];
+    }
+    for (uint64_t ns : all) {
+        totalNs += ns;
+    }
+
+    result.decodes = all.size();
+    result.nsPerOp = static_cast<double>(totalNs) / result.decodes;
+    result.p50Ns = Percentile(all, 0.5);
+    result.p99Ns = Percentile(all, 0.99);
+    result.decodesPerSecond = result.decodes / wallSeconds;
+    // Thread start-up allocations are included, spread over the decodes
+    result.allocationsPerOp = static_cast<double>(allocationCount.load() - allocationsBefore) / result.decodes;
+    result.allocatedBytesPerOp = static_cast<double>(allocationBytes.load() - bytesBefore) / result.decodes;
+    return result;
+}
+
+static void PrintTable(const std::vector<CaseResult> &results) {
+    printf("%-14s %-5s %-10s %-5s %-7s %12s %12s %12s %10s %10s %12s %6s\n", "symbology", "set", "resolution", "speed",
+           "threads", "ns/op", "p50 ns", "p99 ns", "decodes/s", "allocs/op", "bytes/op", "hit%");
+    for (const CaseResult &result : results) {
+        char resolution[24];
+        snprintf(resolution, sizeof(resolution), "%dx%d", result.resolution.width, result.resolution.height);
+        printf("%-14s %-5s %-10s %-5d %-7d %12.0f %12.0f %12.0f %10.1f %10.1f %12.0f %6.1f\n", result.symbology.c_str(),
+               result.allDecoders ? "all" : "own", resolution, result.speed, result.threads, result.nsPerOp, result.p50Ns,
+               result.p99Ns, result.decodesPerSecond, result.allocationsPerOp, result.allocatedBytesPerOp,
+               100.0 * result.hits / result.decodes);
+    }
+}
+
+static void PrintJson(const std::vector<CaseResult> &results) {
+    printf("{\"sdkVersion\":\"%s\",\"results\":[", Barkoder::GetLibVersion().c_str());
+    for (size_t i = 0; i < results.size(); i++) {
+        const CaseResult &result = results[i];
+        printf("%s\n{\"symbology\":\"%s\",\"decoders\":\"%s\",\"width\":%d,\"height\":%d,\"speed\":%d,\"threads\":%d,"
+               "\"decodes\":%llu,\"hits\":%llu,\"nsPerOp\":%.0f,\"p50Ns\":%.0f,\"p99Ns\":%.0f,\"decodesPerSecond\":%.2f,"
+               "\"allocationsPerOp\":%.2f,\"allocatedBytesPerOp\":%.0f}",
+               i ? "," : "", result.symbology.c_str(), result.allDecoders ? "all" : "own", result.resolution.width,
+               result.resolution.height, result.speed, result.threads, static_cast<unsigned long long>(result.decodes),
+               static_cast<unsigned long long>(result.hits), result.nsPerOp, result.p50Ns, result.p99Ns,
+               result.decodesPerSecond, result.allocationsPerOp, result.allocatedBytesPerOp);
+    }
+    printf("\n]}\n");
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        return 2;
+    }
+
+    Config *config = nullptr;
+    try {
+        auto response = Config::InitializeWithLicenseKey(options.license);
+        if (response.GetResult() == ConfigResponse::Result::Error) {
+            fprintf(stderr, "Initialization failed: %s\n", response.Message().c_str());
+            return 1;
+        }
+        config = response.GetConfig();
+    } catch (const std::exception &e) {
+        fprintf(stderr, "Initialization failed: %s (set BARKODER_LICENSE_KEY or pass --license)\n", e.what());
+        return 1;
+    }
+
+    // Same global options the addon sets on initialize
+    Config::SetGlobalOption(BKGlobalOption_SetMaximumThreads, 1);
+    Config::SetGlobalOption(BKGlobalOption_UseGPU, 0);
+    config->maximumResultsCount = 1;
+
+    std::vector<DecoderType> allDecoders;
+    for (const auto &entry : kDecoderNames) {
+        allDecoders.push_back(entry.type);
+    }
+
+    std::vector<CaseResult> results;
+    for (const Image &image : options.images) {
+        for (int allSet = 0; allSet < 2; allSet++) {
+            config->SetEnabledDecoders(allSet ? allDecoders : std::vector<DecoderType>{ image.decoder });
+
+            for (const Resolution &resolution : options.resolutions) {
+                if (resolution.width <= 0 || resolution.height <= 0) {
+                    continue;
+                }
+                std::vector<uint8_t> canvas = Place(image, resolution);
+
+                for (int speed : options.speeds) {
+                    config->decodingSpeed = static_cast<DecodingSpeed>(std::min(3, std::max(0, speed)));
+
+                    for (int threads : options.threads) {
+                        CaseResult result = RunCase(config, canvas, resolution, std::max(1, threads), options.iterations);
+                        result.symbology = image.name;
+                        result.allDecoders = allSet != 0;
+                        result.resolution = resolution;
+                        result.speed = static_cast<int>(config->decodingSpeed);
+                        result.threads = std::max(1, threads);
+                        results.push_back(result);
+
+                        if (!options.json) {
+                            fprintf(stderr, ".");
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (options.json) {
+        PrintJson(results);
+    } else {
+        fprintf(stderr, "\n");
+        PrintTable(results);
+    }
+    return 0;
+}
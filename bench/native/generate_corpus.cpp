@@ -0,0 +1,252 @@
+/**
+ * Synthetic barcode corpus generator
+ *
+ * Renders QR, Code 128, EAN-13, Data Matrix and ITF-14 symbols from a seed,
+ * applies random scale, rotation, perspective, blur, noise and contrast
+ * degradations, and writes binary PGM images with a manifest.json holding
+ * the ground truth of every sample. Needs no network access and no license,
+ * and the same seed and options give byte-identical output on every machine.
+ *
+ * PDF417 is not rendered yet: its codeword patterns come from the ISO 15438
+ * cluster tables, which are left to a follow-up request together with the
+ * encoder. Asking for it fails instead of silently skipping it.
+ *
+ * Build: npm run bench:native (node-gyp rebuild --build_native_bench=true)
+ * Usage: build/Release/barkoder_corpus [options]
+ *   --out DIR              Output directory (default corpus)
+ *   --seed N               Corpus seed (default 1)
+ *   --count N              Samples per symbology (default 20)
+ *   --symbologies LIST     Subset of QR,Code128,Ean13,Datamatrix,ITF14 (default all)
+ *   --module-size MIN:MAX  Pixels per module (default 2:6)
+ *   --rotation MAX         Largest rotation in degrees, either direction (default 30)
+ *   --perspective MAX      Largest relative shrink of one edge (default 0.2)
+ *   --blur MAX             Largest gaussian sigma in pixels (default 1.2)
+ *   --noise MAX            Largest noise deviation in gray levels (default 12)
+ *   --contrast MIN         Smallest dark to light difference, 0-1 (default 0.4)
+ *   --clean                No degradation besides scale, for accuracy baselines
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "Degradation.hpp"
+#include "SyntheticBarcodes.hpp"
+#include "json/cJSON.h"
+
+using namespace BKBench;
+
+struct Options {
+    std::string out = "corpus";
+    uint64_t seed = 1;
+    int count = 20;
+    std::vector<Symbology> symbologies;
+    double minModuleSize = 2;
+    double maxModuleSize = 6;
+    double rotation = 30;
+    double perspective = 0.2;
+    double blur = 1.2;
+    double noise = 12;
+    double contrast = 0.4;
+};
+
+static bool ParseOptions(int argc, char **argv, Options &options) {
+    bool clean = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (arg == "--clean") {
+            clean = true;
+            continue;
+        }
+        if (!value) {
+            fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return false;
+        }
+        i++;
+
+        if (arg == "--out") {
+            options.out = value;
+        } else if (arg == "--seed") {
+            options.seed = strtoull(value, nullptr, 10);
+        } else if (arg == "--count") {
+            options.count = std::max(1, atoi(value));
+        } else if (arg == "--symbologies") {
+            std::string list(value);
+            size_t start = 0;
+            while (start <= list.size()) {
+                size_t end = list.find(',', start);
+                if (end == std::string::npos) {
+                    end = list.size();
+                }
+                Symbology symbology;
+                std::string name = list.substr(start, end - start);
+                if (name == "PDF417") {
+                    fprintf(stderr, "PDF417 is not generated yet\n");
+                    return false;
+                }
+                if (end > start && !ParseSymbology(name, symbology)) {
+                    fprintf(stderr, "Unknown symbology %s\n", name.c_str());
+                    return false;
+                }
+                if (end > start) {
+                    options.symbologies.push_back(symbology);
+                }
+                start = end + 1;
+            }
+        } else if (arg == "--module-size") {
+            if (sscanf(value, "%lf:%lf", &options.minModuleSize, &options.maxModuleSize) != 2 ||
+                options.minModuleSize <= 0 || options.maxModuleSize < options.minModuleSize) {
+                fprintf(stderr, "Expected MIN:MAX module size, got %s\n", value);
+                return false;
+            }
+        } else if (arg == "--rotation") {
+            options.rotation = atof(value);
+        } else if (arg == "--perspective") {
+            options.perspective = std::min(0.9, std::max(0.0, atof(value)));
+        } else if (arg == "--blur") {
+            options.blur = std::max(0.0, atof(value));
+        } else if (arg == "--noise") {
+            options.noise = std::max(0.0, atof(value));
+        } else if (arg == "--contrast") {
+            options.contrast = std::min(1.0, std::max(0.05, atof(value)));
+        } else {
+            fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+
+    if (clean) {
+        options.rotation = 0;
+        options.perspective = 0;
+        options.blur = 0;
+        options.noise = 0;
+        options.contrast = 1;
+    }
+    if (options.symbologies.empty()) {
+        for (int i = 0; i < static_cast<int>(Symbology::Count); i++) {
+            options.symbologies.push_back(static_cast<Symbology>(i));
+        }
+    }
+    return true;
+}
+
+/**
+ * Round to the precision stored in the manifest, so the manifest alone reproduces a sample
+ */
+static double Quantize(double value) {
+    return std::round(value * 1000) / 1000;
+}
+
+static bool WritePgm(const std::string &path, const RenderedImage &image) {
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "P5\n%d %d\n255\n", image.width, image.height);
+    bool written = fwrite(image.pixels.data(), 1, image.pixels.size(), file) == image.pixels.size();
+    return fclose(file) == 0 && written;
+}
+
+static cJSON *SampleJson(const std::string &file, Symbology symbology, const std::string &text, uint64_t seed,
+                         const Degradation &degradation, const RenderedImage &image) {
+    cJSON *sample = cJSON_CreateObject();
+    cJSON_AddStringToObject(sample, "file", file.c_str());
+    cJSON_AddStringToObject(sample, "symbology", SymbologyName(symbology));
+    cJSON_AddStringToObject(sample, "text", text.c_str());
+    // Sample seeds can exceed 2^53, so they are kept as strings
+    cJSON_AddStringToObject(sample, "seed", std::to_string(seed).c_str());
+    cJSON_AddNumberToObject(sample, "width", image.width);
+    cJSON_AddNumberToObject(sample, "height", image.height);
+    cJSON_AddNumberToObject(sample, "moduleSize", degradation.moduleSize);
+    cJSON_AddNumberToObject(sample, "rotation", degradation.rotation);
+    cJSON_AddNumberToObject(sample, "perspective", degradation.perspective);
+    cJSON_AddNumberToObject(sample, "blur", degradation.blur);
+    cJSON_AddNumberToObject(sample, "noise", degradation.noise);
+    cJSON_AddNumberToObject(sample, "contrast", degradation.contrast);
+
+    cJSON *corners = cJSON_CreateArray();
+    for (int i = 0; i < 4; i++) {
+        double point[2] = { Quantize(image.corners[i][0]), Quantize(image.corners[i][1]) };
+        cJSON_AddItemToArray(corners, cJSON_CreateDoubleArray(point, 2));
+    }
+    cJSON_AddItemToObject(sample, "corners", corners);
+    return sample;
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        return 2;
+    }
+
+    if (mkdir(options.out.c_str(), 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Cannot create %s\n", options.out.c_str());
+        return 1;
+    }
+
+    cJSON *manifest = cJSON_CreateObject();
+    cJSON_AddNumberToObject(manifest, "version", 1);
+    cJSON_AddStringToObject(manifest, "seed", std::to_string(options.seed).c_str());
+    cJSON *samples = cJSON_CreateArray();
+    cJSON_AddItemToObject(manifest, "samples", samples);
+
+    int written = 0;
+    for (Symbology symbology : options.symbologies) {
+        for (int index = 0; index < options.count; index++) {
+            // Each sample has its own stream, so it does not change when other samples are added or removed
+            Random derive(options.seed ^ (static_cast<uint64_t>(symbology) << 56) ^ static_cast<uint64_t>(index) << 24);
+            uint64_t seed = derive.Next();
+            Random random(seed);
+
+            std::string text = RandomContent(symbology, random);
+            ModuleGrid grid;
+            if (!Encode(symbology, text, grid)) {
+                fprintf(stderr, "Cannot encode %s as %s\n", text.c_str(), SymbologyName(symbology));
+                cJSON_Delete(manifest);
+                return 1;
+            }
+
+            Degradation degradation;
+            degradation.moduleSize = Quantize(random.Uniform(options.minModuleSize, options.maxModuleSize));
+            degradation.rotation = Quantize(random.Uniform(-options.rotation, options.rotation));
+            degradation.perspective = Quantize(random.Uniform(0, options.perspective));
+            degradation.blur = Quantize(random.Uniform(0, options.blur));
+            degradation.noise = Quantize(random.Uniform(0, options.noise));
+            degradation.contrast = Quantize(random.Uniform(options.contrast, 1));
+
+            RenderedImage image;
+            Render(grid, degradation, random, image);
+
+            char name[64];
+            snprintf(name, sizeof(name), "%s_%04d.pgm", SymbologyName(symbology), index);
+            if (!WritePgm(options.out + "/" + name, image)) {
+                fprintf(stderr, "Cannot write %s/%s\n", options.out.c_str(), name);
+                cJSON_Delete(manifest);
+                return 1;
+            }
+            cJSON_AddItemToArray(samples, SampleJson(name, symbology, text, seed, degradation, image));
+            written++;
+        }
+    }
+
+    char *json = cJSON_Print(manifest);
+    std::string manifestPath = options.out + "/manifest.json";
+    FILE *file = fopen(manifestPath.c_str(), "wb");
+    bool saved = file && fputs(json, file) >= 0;
+    saved = file && fclose(file) == 0 && saved;
+    free(json);
+    cJSON_Delete(manifest);
+    if (!saved) {
+        fprintf(stderr, "Cannot write %s\n", manifestPath.c_str());
+        return 1;
+    }
+
+    printf("Wrote %d samples and manifest.json to %s\n", written, options.out.c_str());
+    return 0;
+}
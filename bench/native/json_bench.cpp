@@ -0,0 +1,329 @@
+/**
+ * Result JSON benchmark
+ *
+ * Builds, prints and deletes cJSON trees shaped like the decode results the
+ * addon returns (type, text, corners, polygon and extra keys per barcode),
+ * for several result counts and thread counts, once with plain malloc and
+ * once with the per-thread JsonArena. Reports ns/op and heap calls per op.
+ * Then times number formatting alone: the sprintf branches cJSON used to
+ * print numbers with against cJSON's current formatter, on corner
+ * coordinates and millisecond timings.
+ *
+ * Build: npm run bench:json (node-gyp rebuild --build_native_bench=true)
+ * Usage: build/Release/barkoder_json_bench [options]
+ *   --results LIST         Barcodes per result tree (default 1,10,100,500)
+ *   --threads LIST         Concurrent building threads (default 1 and the CPU count)
+ *   --iterations N         Trees per thread and case (default 2000)
+ *   --numbers N            Values in the number formatting run (default 100000, 0 skips it)
+ */
+
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "JsonArena.hpp"
+#include "json/cJSON.h"
+
+using namespace BKNode;
+
+typedef std::chrono::steady_clock Clock;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Heap call counting
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Per thread so counting adds no shared cache line to the multi-threaded cases
+static thread_local uint64_t heapCalls = 0;
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_THREAD__) && !defined(__SANITIZE_ADDRESS__)
+// Interpose the C allocator so cJSON's direct malloc calls are seen, not only operator new.
+// Sanitizers replace the allocator themselves, so counting is off under them.
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void __libc_free(void *pointer);
+
+void *malloc(size_t size) {
+    heapCalls++;
+    return __libc_malloc(size);
+}
+void *calloc(size_t count, size_t size) {
+    heapCalls++;
+    return __libc_calloc(count, size);
+}
+void *realloc(void *pointer, size_t size) {
+    heapCalls++;
+    return __libc_realloc(pointer, size);
+}
+void free(void *pointer) {
+    if (pointer) {
+        heapCalls++;
+    }
+    __libc_free(pointer);
+}
+}
+static const bool kCountsHeapCalls = true;
+#else
+static const bool kCountsHeapCalls = false;
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Workload
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void AddPoints(cJSON *object, const char *name, int count, int seed) {
+    cJSON *points = cJSON_CreateArray();
+    for (int i = 0; i < count; i++) {
+        cJSON *point = cJSON_CreateObject();
+        cJSON_AddNumberToObject(point, "x", 100.25 + seed * 3.5 + i * 17.125);
+        cJSON_AddNumberToObject(point, "y", 50.5 + seed * 2.25 + i * 9.75);
+        cJSON_AddItemToArray(points, point);
+    }
+    cJSON_AddItemToObject(object, name, points);
+}
+
+/**
+ * Same shape as ResultsToJson in barkoder_node.cpp for the given number of barcodes
+ */
+static std::string BuildResults(int resultCount) {
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddNumberToObject(root, "resultsCount", resultCount);
+    cJSON *results = cJSON_CreateArray();
+    for (int i = 0; i < resultCount; i++) {
+        cJSON *result = cJSON_CreateObject();
+        cJSON_AddStringToObject(result, "barcodeTypeName", "QR");
+        cJSON_AddStringToObject(result, "textualData", "https://barkoder.com/product/0123456789");
+        AddPoints(result, "location", 4, i);
+        AddPoints(result, "polygon", 4, i);
+        cJSON_AddStringToObject(result, "characterSet", "UTF-8");
+        cJSON_AddStringToObject(result, "symbologyIdentifier", "]Q1");
+        cJSON_AddStringToObject(result, "errorCorrectionLevel", "M");
+        cJSON_AddItemToArray(results, result);
+    }
+    cJSON_AddItemToObject(root, "results", results);
+
+    char *text = cJSON_Print(root);
+    std::string json(text);
+    cJSON_Delete(root);
+    JsonArena::Release(text);
+    return json;
+}
+
+struct CaseResult {
+    bool arena;
+    int results;
+    int threads;
+    double nsPerOp;
+    double heapCallsPerOp;
+};
+
+static CaseResult RunCase(bool useArena, int resultCount, int threadCount, int iterations) {
+    std::atomic<int> ready{0};
+    std::vector<uint64_t> elapsedNs(threadCount, 0);
+    std::vector<uint64_t> threadHeapCalls(threadCount, 0);
+
+    auto work = [&](int t) {
+        // Untimed warmup lets the arena reach its steady-state block size
+        for (int i = 0; useArena && i < 10; i++) {
+            JsonArena::Scope scope;
+            BuildResults(resultCount);
+        }
+        ready++;
+        while (ready.load() < threadCount + 1) {
+            std::this_thread::yield();
+        }
+
+        uint64_t heapBefore = heapCalls;
+        auto start = Clock::now();
+        for (int i = 0; i < iterations; i++) {
+            if (useArena) {
+                JsonArena::Scope scope;
+                BuildResults(resultCount);
+            } else {
+                BuildResults(resultCount);
+            }
+        }
+        elapsedNs[t] = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        threadHeapCalls[t] = heapCalls - heapBefore;
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        workers.emplace_back(work, t);
+    }
+    while (ready.load() < threadCount) {
+        std::this_thread::yield();
+    }
+    ready++;
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    CaseResult result;
+    result.arena = useArena;
+    result.results = resultCount;
+    result.threads = threadCount;
+    uint64_t totalNs = 0;
+    uint64_t totalHeapCalls = 0;
+    for (int t = 0; t < threadCount; t++) {
+        totalNs += elapsedNs[t];
+        totalHeapCalls += threadHeapCalls[t];
+    }
+    uint64_t operations = static_cast<uint64_t>(iterations) * threadCount;
+    result.nsPerOp = static_cast<double>(totalNs) / operations;
+    // Includes the std::string holding each printout, the same copy the addon makes
+    result.heapCallsPerOp = static_cast<double>(totalHeapCalls) / operations;
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Number formatting
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * How cJSON printed numbers before it had its own formatter, kept as the baseline
+ */
+static int SprintfNumber(char *str, double d) {
+    int valueint = static_cast<int>(d);
+    if (fabs(static_cast<double>(valueint) - d) <= DBL_EPSILON && d <= INT_MAX && d >= INT_MIN) {
+        return sprintf(str, "%d", valueint);
+    }
+    if (fabs(floor(d) - d) <= DBL_EPSILON && fabs(d) < 1.0e60) {
+        return sprintf(str, "%.0f", d);
+    }
+    if (fabs(d) < 1.0e-6 || fabs(d) > 1.0e9) {
+        return sprintf(str, "%e", d);
+    }
+    return sprintf(str, "%f", d);
+}
+
+static void RunNumbers(int count) {
+    // Corner coordinates of a 4K frame as the SDK reports them, and decode timings in milliseconds
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> coordinate(0.0f, 3840.0f);
+    std::uniform_real_distribution<double> milliseconds(0.05, 250.0);
+    std::vector<double> values(count);
+    for (int i = 0; i < count; i++) {
+        values[i] = i % 4 == 3 ? milliseconds(random) : coordinate(random);
+    }
+
+    char buffer[64];
+    size_t sprintfBytes = 0;
+    auto start = Clock::now();
+    for (double value : values) {
+        sprintfBytes += SprintfNumber(buffer, value);
+    }
+    double sprintfNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+    // One number item created and printed per value, as the addon adds coordinates through cJSON_CreateFloat,
+    // so this includes cJSON's (arena) allocations of each item and string
+    JsonArena::Scope scope;
+    std::vector<cJSON *> numbers(count);
+    std::vector<char *> printed(count);
+    start = Clock::now();
+    for (int i = 0; i < count; i++) {
+        numbers[i] = i % 4 == 3 ? cJSON_CreateNumber(values[i]) : cJSON_CreateFloat(static_cast<float>(values[i]));
+        printed[i] = cJSON_PrintUnformatted(numbers[i]);
+    }
+    double cjsonNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+    // Every printed value must read back as the value it came from: the same float for coordinates, the same double otherwise
+    size_t cjsonBytes = 0;
+    int mismatches = 0;
+    for (int i = 0; i < count; i++) {
+        double parsed = strtod(printed[i], nullptr);
+        if (i % 4 == 3 ? parsed != values[i] : static_cast<float>(parsed) != static_cast<float>(values[i])) {
+            mismatches++;
+        }
+        cJSON_Delete(numbers[i]);
+        cjsonBytes += strlen(printed[i]);
+        JsonArena::Release(printed[i]);
+    }
+
+    printf("\n%-10s %10s %12s %12s\n", "format", "values", "ns/value", "bytes/value");
+    printf("%-10s %10d %12.1f %12.2f\n", "sprintf", count, sprintfNs / count, static_cast<double>(sprintfBytes) / count);
+    printf("%-10s %10d %12.1f %12.2f\n", "cJSON", count, cjsonNs / count, static_cast<double>(cjsonBytes) / count);
+    if (mismatches) {
+        printf("%d values did not read back unchanged\n", mismatches);
+    }
+}
+
+static std::vector<int> ParseList(const char *text) {
+    std::vector<int> values;
+    std::string list(text);
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        if (end > start) {
+            values.push_back(std::max(1, atoi(list.substr(start, end - start).c_str())));
+        }
+        start = end + 1;
+    }
+    return values;
+}
+
+int main(int argc, char **argv) {
+    std::vector<int> resultCounts = { 1, 10, 100, 500 };
+    std::vector<int> threadCounts = { 1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) };
+    int iterations = 2000;
+    int numbers = 100000;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value) {
+            fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return 2;
+        }
+        i++;
+        if (arg == "--results") {
+            resultCounts = ParseList(value);
+        } else if (arg == "--threads") {
+            threadCounts = ParseList(value);
+        } else if (arg == "--iterations") {
+            iterations = std::max(1, atoi(value));
+        } else if (arg == "--numbers") {
+            numbers = std::max(0, atoi(value));
+        } else {
+            fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return 2;
+        }
+    }
+    threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+
+    JsonArena::Install();
+
+    printf("%-8s %-8s %-8s %14s %14s\n", "alloc", "results", "threads", "ns/op", "heap calls/op");
+    for (int resultCount : resultCounts) {
+        for (int threadCount : threadCounts) {
+            for (bool useArena : { false, true }) {
+                // Fewer iterations for large trees keep every case around the same duration
+                int caseIterations = std::max(10, iterations / std::max(1, resultCount / 10));
+                CaseResult result = RunCase(useArena, resultCount, threadCount, caseIterations);
+                char heap[32] = "n/a";
+                if (kCountsHeapCalls) {
+                    snprintf(heap, sizeof(heap), "%.1f", result.heapCallsPerOp);
+                }
+                printf("%-8s %-8d %-8d %14.0f %14s\n", result.arena ? "arena" : "malloc", result.results,
+                       result.threads, result.nsPerOp, heap);
+            }
+        }
+    }
+    if (numbers > 0) {
+        RunNumbers(numbers);
+    }
+    return 0;
+}
@@ -0,0 +1,346 @@
+#!/usr/bin/env node
+
+/**
+ * Replay of captured decode requests
+ *
+ * Feeds the frames of a capture file written by BarkoderSDK.startCapture
+ * back through the wrapper, with the settings each frame was decoded with,
+ * and reports results that differ from the recorded ones and how replayed
+ * latencies compare with the recorded latencies. Use it to reproduce
+ * production slowdowns locally and to check wrapper or SDK upgrades
+ * against real traffic.
+ *
+ * Usage: npm run replay -- CAPTURE [options]
+ *   --pace MODE            recorded: keep the recorded arrival times, max: back to back (default max)
+ *   --mode MODE            recorded: same call as captured, sync or async: force one (default recorded)
+ *   --limit N              Replay only the first N frames
+ *   --tolerance FRACTION   Allowed relative rise of p50 and p99 latency (default 0.25)
+ *   --max-diffs N          Result differences listed (default 10)
+ *   --json                 Print the report as JSON only
+ *   --out FILE             Also write the JSON report to FILE
+ *
+ * Exits with 1 when results differ or latency rose beyond the tolerance.
+ * The license key is read from BARKODER_LICENSE_KEY, or from config.json.
+ */
+
+const BarkoderSDK = require('../lib/index');
+const fs = require('fs');
+const path = require('path');
+
+const HEADER_BYTES = 16;
+const FRAME_FIXED_BYTES = 72;
+const FOOTER_BYTES = 16;
+
+function parseArgs(argv) {
+    const options = {
+        capture: null,
+        pace: 'max',
+        mode: 'recorded',
+        limit: Infinity,
+        tolerance: 0.25,
+        maxDiffs: 10,
+        json: false,
+        out: null
+    };
+
+    for (let i = 0; i < argv.length; i++) {
+        const arg = argv[i];
+        const value = argv[i + 1];
+        switch (arg) {
+            case '--pace': options.pace = value; i++; break;
+            case '--mode': options.mode = value; i++; break;
+            case '--limit': options.limit = Number(value); i++; break;
+            case '--tolerance': options.tolerance = Number(value); i++; break;
+            case '--max-diffs': options.maxDiffs = Number(value); i++; break;
+            case '--json': options.json = true; break;
+            case '--out': options.out = value; i++; break;
+            default:
+                if (arg.startsWith('--') || options.capture) {
+                    throw new Error(`Unknown option ${arg}`);
+                }
+                options.capture = arg;
+        }
+    }
+
+    if (!options.capture) {
+        throw new Error('Capture file expected');
+    }
+    if (!['recorded', 'max'].includes(options.pace)) {
+        throw new Error(`Invalid pace ${options.pace}, expected recorded or max`);
+    }
+    if (!['recorded', 'sync', 'async'].includes(options.mode)) {
+        throw new Error(`Invalid mode ${options.mode}, expected recorded, sync or async`);
+    }
+    return options;
+}
+
+function readExactly(fd, length, position) {
+    const buffer = Buffer.alloc(length);
+    if (fs.readSync(fd, buffer, 0, length, position) !== length) {
+        throw new Error(`Capture truncated at byte ${position}`);
+    }
+    return buffer;
+}
+
+/**
+ * Get the offsets of every frame, from the index or, when the capture was not stopped cleanly, by walking the frames
+ */
+function readFrameOffsets(fd) {
+    const size = fs.fstatSync(fd).size;
+    const header = readExactly(fd, HEADER_BYTES, 0);
+    if (header.toString('latin1', 0, 8) !== 'BKCAPTR1') {
+        throw new Error('Not a Barkoder capture file');
+    }
+    if (header.readUInt32LE(8) !== 1) {
+        throw new Error(`Unsupported capture version ${header.readUInt32LE(8)}`);
+    }
+
+    if (size >= HEADER_BYTES + FOOTER_BYTES) {
+        const footer = readExactly(fd, FOOTER_BYTES, size - FOOTER_BYTES);
+        if (footer.toString('latin1', 8) === 'BKCAPEND') {
+            const indexOffset = Number(footer.readBigUInt64LE(0));
+            const index = readExactly(fd, size - FOOTER_BYTES - indexOffset, indexOffset);
+            const count = index.readUInt32LE(8);
+            const offsets = [];
+            for (let i = 0; i < count; i++) {
+                offsets.push(Number(index.readBigUInt64LE(16 + i * 8)));
+            }
+            return { offsets, complete: true };
+        }
+    }
+
+    const offsets = [];
+    let position = HEADER_BYTES;
+    while (position + 4 <= size) {
+        const length = readExactly(fd, 4, position).readUInt32LE(0);
+        if (position + 4 + length > size) {
+            break; // Partially written last frame
+        }
+        offsets.push(position);
+        position += 4 + length;
+    }
+    return { offsets, complete: false };
+}
+
+function readFrame(fd, offset) {
+    const fixed = readExactly(fd, FRAME_FIXED_BYTES, offset);
+    const frame = {
+        timestampMs: Number(fixed.readBigUInt64LE(4)) / 1e6,
+        fingerprint: fixed.readBigUInt64LE(12).toString(16),
+        width: fixed.readUInt32LE(20),
+        height: fixed.readUInt32LE(24),
+        format: fixed.readUInt32LE(28),
+        async: (fixed.readUInt32LE(32) & 1) !== 0,
+        queueMs: Number(fixed.readBigUInt64LE(36)) / 1e6,
+        decodeMs: Number(fixed.readBigUInt64LE(44)) / 1e6,
+        totalMs: Number(fixed.readBigUInt64LE(52)) / 1e6
+    };
+    const settingsLength = fixed.readUInt32LE(60);
+    const resultLength = fixed.readUInt32LE(64);
+    const pixelsLength = fixed.readUInt32LE(68);
+
+    const variable = readExactly(fd, settingsLength + resultLength + pixelsLength, offset + FRAME_FIXED_BYTES);
+    frame.settings = variable.toString('utf8', 0, settingsLength);
+    frame.result = variable.toString('utf8', settingsLength, settingsLength + resultLength);
+    frame.pixels = variable.subarray(settingsLength + resultLength);
+
+    if (frame.format !== 0) {
+        throw new Error(`Unsupported pixel format ${frame.format} at byte ${offset}`);
+    }
+    return frame;
+}
+
+function initialize() {
+    if (process.env.BARKODER_LICENSE_KEY) {
+        const status = BarkoderSDK.initialize(process.env.BARKODER_LICENSE_KEY);
+        if (!status.startsWith('SUCCESS:')) {
+            throw new Error(status);
+        }
+        return;
+    }
+    const result = BarkoderSDK.initializeFromConfig(path.join(__dirname, '../config.json'));
+    if (!result.success) {
+        throw new Error(result.status);
+    }
+}
+
+function applySettings(settingsJson) {
+    const settings = JSON.parse(settingsJson);
+    const statuses = [
+        BarkoderSDK.setEnabledDecoders(settings.decoders),
+        BarkoderSDK.setDecodingSpeed(settings.decodingSpeed),
+        BarkoderSDK.setMaximumResultsCount(settings.maximumResultsCount),
+        BarkoderSDK.setRegionOfInterest(...settings.regionOfInterest),
+        BarkoderSDK.setDecodingCascade(settings.cascade.speeds, settings.cascade.timeBudgetMs),
+        BarkoderSDK.setPyramidMode(settings.pyramid.factor, settings.pyramid.minPixels, settings.pyramid.fullFrameFallback),
+        BarkoderSDK.setTileMode(settings.tiles.maxBarcodeSize, settings.tiles.minPixels)
+    ];
+    const failed = statuses.find(status => !status.ok);
+    if (failed) {
+        throw new Error(`Cannot apply captured settings: ${failed}`);
+    }
+}
+
+/**
+ * Reduce a decode result to its barcodes, ignoring locations and strategy details that may legitimately shift
+ */
+function resultKey(result) {
+    if (typeof result === 'string') {
+        if (result.startsWith('ERROR:')) {
+            return result;
+        }
+        result = JSON.parse(result);
+    }
+    const barcodes = result.resultsCount > 1 ? result.results : (result.resultsCount === 1 ? [result] : []);
+    return barcodes.map(barcode => `${barcode.barcodeTypeName}:${barcode.textualData}`).sort().join('\n');
+}
+
+function percentile(sorted, quantile) {
+    if (sorted.length === 0) {
+        return 0;
+    }
+    return sorted[Math.min(sorted.length - 1, Math.floor(quantile * sorted.length))];
+}
+
+function round(value, digits = 3) {
+    const factor = 10 ** digits;
+    return Math.round(value * factor) / factor;
+}
+
+function summarize(values) {
+    const sorted = [...values].sort((a, b) => a - b);
+    return {
+        p50: round(percentile(sorted, 0.5)),
+        p90: round(percentile(sorted, 0.9)),
+        p99: round(percentile(sorted, 0.99)),
+        max: round(sorted[sorted.length - 1] || 0)
+    };
+}
+
+/**
+ * Decode one frame and record how it compares with the capture
+ */
+async function replayFrame(frame, index, options, report) {
+    const async = options.mode === 'recorded' ? frame.async : options.mode === 'async';
+    const before = process.hrtime.bigint();
+    let result;
+    try {
+        result = async
+            ? await BarkoderSDK.decodeImageAsync(frame.pixels, frame.width, frame.height)
+            : BarkoderSDK.decodeImage(frame.pixels, frame.width, frame.height);
+    } catch (error) {
+        result = `ERROR: ${error.message}`;
+    }
+    const totalMs = Number(process.hrtime.bigint() - before) / 1e6;
+
+    report.recordedMs.push(frame.totalMs);
+    report.replayedMs.push(totalMs);
+
+    const expected = resultKey(frame.result);
+    const actual = resultKey(result);
+    if (expected !== actual) {
+        report.differences.push({ frame: index, width: frame.width, height: frame.height, expected, actual });
+    }
+}
+
+async function replay(fd, offsets, options) {
+    const report = { recordedMs: [], replayedMs: [], differences: [] };
+    const inFlight = [];
+    const start = process.hrtime.bigint();
+    let fingerprint = null;
+
+    for (let i = 0; i < offsets.length && i < options.limit; i++) {
+        const frame = readFrame(fd, offsets[i]);
+        if (frame.fingerprint !== fingerprint) {
+            applySettings(frame.settings);
+            fingerprint = frame.fingerprint;
+        }
+
+        if (options.pace === 'recorded') {
+            const waitMs = frame.timestampMs - Number(process.hrtime.bigint() - start) / 1e6;
+            if (waitMs > 0) {
+                await new Promise(resolve => setTimeout(resolve, waitMs));
+            }
+            // Overlapping requests stay overlapping, as they were in production
+            inFlight.push(replayFrame(frame, i, options, report));
+        } else {
+            await replayFrame(frame, i, options, report);
+        }
+    }
+    await Promise.all(inFlight);
+    return report;
+}
+
+async function main() {
+    const options = parseArgs(process.argv.slice(2));
+    const fd = fs.openSync(options.capture, 'r');
+    const { offsets, complete } = readFrameOffsets(fd);
+    if (offsets.length === 0) {
+        throw new Error('Capture holds no frames');
+    }
+    if (!complete && !options.json) {
+        console.error('Capture was not stopped cleanly, replaying the complete frames');
+    }
+
+    initialize();
+    if (!options.json) {
+        console.error(`Replaying ${Math.min(offsets.length, options.limit)} frames of ${options.capture} ` +
+                      `with Barkoder ${BarkoderSDK.getVersion()}, pace ${options.pace}, mode ${options.mode}`);
+    }
+
+    const report = await replay(fd, offsets, options);
+    fs.closeSync(fd);
+
+    const recorded = summarize(report.recordedMs);
+    const replayed = summarize(report.replayedMs);
+    const results = {
+        capture: options.capture,
+        sdkVersion: BarkoderSDK.getVersion(),
+        node: process.version,
+        pace: options.pace,
+        mode: options.mode,
+        frames: report.replayedMs.length,
+        matched: report.replayedMs.length - report.differences.length,
+        differences: report.differences.slice(0, options.maxDiffs),
+        differenceCount: report.differences.length,
+        latencyMs: { recorded, replayed }
+    };
+
+    const json = JSON.stringify(results, null, 2);
+    if (options.json) {
+        console.log(json);
+    }
+    if (options.out) {
+        fs.writeFileSync(options.out, json + '\n');
+    }
+
+    const problems = [];
+    if (report.differences.length > 0) {
+        problems.push(`${report.differences.length} of ${results.frames} frames decoded differently`);
+    }
+    for (const quantile of ['p50', 'p99']) {
+        const limit = recorded[quantile] * (1 + options.tolerance);
+        if (replayed[quantile] > limit) {
+            problems.push(`latency ${quantile} ${replayed[quantile]} ms vs recorded ${recorded[quantile]} ms (limit ${round(limit)})`);
+        }
+    }
+
+    if (!options.json) {
+        console.error(`Latency recorded p50 ${recorded.p50} ms, p99 ${recorded.p99} ms; replayed p50 ${replayed.p50} ms, p99 ${replayed.p99} ms`);
+        for (const difference of results.differences) {
+            console.error(`  frame ${difference.frame} (${difference.width}x${difference.height}): ` +
+                          `recorded [${difference.expected.replace(/\n/g, ', ')}], replayed [${difference.actual.replace(/\n/g, ', ')}]`);
+        }
+    }
+    if (problems.length > 0) {
+        console.error(`\n${problems.join('\n')}`);
+        return 1;
+    }
+    console.error(`\nAll ${results.frames} frames matched, latency within ${options.tolerance * 100}% of the capture`);
+    return 0;
+}
+
+main().then(code => process.exit(code), error => {
+    console.error(`Replay failed: ${error.message}`);
+    process.exit(2);
+});
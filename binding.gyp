@@ -1,8 +1,24 @@
 {
+  "variables": {
+    "build_native_bench%": "false",
+    "build_native_tests%": "false"
+  },
   "targets": [{
     "target_name": "barkoder",
     "sources": [
       "src/barkoder_node.cpp",
+      "src/DecodePool.cpp",
+      "src/DecodeStats.cpp",
+      "src/DecodeStrategies.cpp",
+      "src/FrameCapture.cpp",
+      "src/ImageOps.cpp",
+      "src/JsonArena.cpp",
+      "src/MemoryAccount.cpp",
+      "src/MetricsText.cpp",
+      "src/ResultRing.cpp",
+      "src/StartupTimeline.cpp",
+      "src/Tracer.cpp",
+      "src/Warmup.cpp",
       "src/json/cJSON.cpp"
     ],
     "libraries": [
@@ -35,5 +51,118 @@
       "VCCLCompilerTool": { "ExceptionHandling": 1 }
     },
     "defines": [ "NAPI_DISABLE_CPP_EXCEPTIONS" ]
-  }]
+  }],
+  "conditions": [
+    ["build_native_bench=='true'", {
+      "targets": [{
+        "target_name": "barkoder_bench",
+        "type": "executable",
+        "sources": [
+          "bench/native/decode_bench.cpp"
+        ],
+        "libraries": [
+          "-lcurl",
+          "-lpthread"
+        ],
+        "conditions": [
+          ["target_arch=='x64'", {
+            "libraries": ["<(module_root_dir)/lib/x86_64/libbarkoder.a"]
+          }],
+          ["target_arch=='arm64'", {
+            "libraries": ["<(module_root_dir)/lib/arm64/libbarkoder.a"]
+          }]
+        ],
+        "include_dirs": [
+          "src"
+        ],
+        "cflags!": [ "-fno-exceptions" ],
+        "cflags_cc!": [ "-fno-exceptions" ],
+        "xcode_settings": {
+          "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
+          "CLANG_CXX_LIBRARY": "libc++",
+          "MACOSX_DEPLOYMENT_TARGET": "10.7"
+        }
+      }, {
+        "target_name": "barkoder_corpus",
+        "type": "executable",
+        "sources": [
+          "bench/native/generate_corpus.cpp",
+          "bench/native/Degradation.cpp",
+          "bench/native/SyntheticBarcodes.cpp",
+          "src/json/cJSON.cpp"
+        ],
+        "include_dirs": [
+          "src"
+        ],
+        "xcode_settings": {
+          "CLANG_CXX_LIBRARY": "libc++",
+          "MACOSX_DEPLOYMENT_TARGET": "10.7"
+        }
+      }, {
+        "target_name": "barkoder_json_bench",
+        "type": "executable",
+        "sources": [
+          "bench/native/json_bench.cpp",
+          "src/JsonArena.cpp",
+          "src/MemoryAccount.cpp",
+          "src/json/cJSON.cpp"
+        ],
+        "include_dirs": [
+          "src"
+        ],
+        "libraries": [
+          "-lpthread"
+        ],
+        "xcode_settings": {
+          "CLANG_CXX_LIBRARY": "libc++",
+          "MACOSX_DEPLOYMENT_TARGET": "10.7"
+        }
+      }]
+    }],
+    ["build_native_tests=='true'", {
+      "targets": [{
+        "target_name": "barkoder_native_test",
+        "type": "executable",
+        "sources": [
+          "test/native/json.test.cpp",
+          "test/native/main.cpp",
+          "test/native/metrics.test.cpp",
+          "test/native/stats.test.cpp",
+          "test/native/tiles.test.cpp",
+          "test/native/trace.test.cpp",
+          "src/DecodePool.cpp",
+          "src/DecodeStats.cpp",
+          "src/DecodeStrategies.cpp",
+          "src/ImageOps.cpp",
+          "src/JsonArena.cpp",
+          "src/MemoryAccount.cpp",
+          "src/MetricsText.cpp",
+          "src/Tracer.cpp",
+          "src/json/cJSON.cpp"
+        ],
+        "libraries": [
+          "-lcurl",
+          "-lpthread"
+        ],
+        "conditions": [
+          ["target_arch=='x64'", {
+            "libraries": ["<(module_root_dir)/lib/x86_64/libbarkoder.a"]
+          }],
+          ["target_arch=='arm64'", {
+            "libraries": ["<(module_root_dir)/lib/arm64/libbarkoder.a"]
+          }]
+        ],
+        "include_dirs": [
+          "src"
+        ],
+        "cflags!": [ "-fno-exceptions" ],
+        "cflags_cc!": [ "-fno-exceptions" ],
+        "xcode_settings": {
+          "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
+          "CLANG_CXX_LIBRARY": "libc++",
+          "MACOSX_DEPLOYMENT_TARGET": "10.7"
+        }
+      }]
+    }]
+  ]
 }
\ No newline at end of file
@@ -166,6 +166,41 @@ const Formatting = {
     SADL: 4          // SADL standard formatting
 };
 
+/**
+ * Status Codes
+ * Returned by the setting methods as the code of a Status
+ */
+const Status = {
+    Ok: 0,                // Setting applied
+    NotInitialized: 1,    // initialize() has not succeeded yet
+    InvalidArgument: 2,   // Missing, mistyped or out-of-range argument
+    SdkError: 3,          // The SDK threw while applying the setting
+    IoError: 4,           // A file could not be opened or written
+    Aborted: 5            // An AbortSignal stopped the decode (result ring records)
+};
+
+/**
+ * Decode Priorities
+ * Native queue an async decode waits in
+ */
+const Priority = {
+    Interactive: 0,  // Someone is waiting for the result (default)
+    Bulk: 1          // Background work, e.g. batch reprocessing
+};
+
+/**
+ * Barcode Type Names
+ * Indexed by the barcode type numbers the SDK reports, e.g. in result ring records.
+ * This numbering differs from Decoders: it includes the ID document parts.
+ */
+const BarcodeTypes = [
+    'Aztec', 'AztecCompact', 'QR', 'QRMicro', 'Code128', 'Code93', 'Code39', 'Codabar', 'Code11', 'Msi',
+    'UpcA', 'UpcE', 'UpcE1', 'Ean13', 'Ean8', 'PDF417', 'PDF417Micro', 'Datamatrix', 'Code25', 'Interleaved25',
+    'ITF14', 'IATA25', 'Matrix25', 'Datalogic25', 'COOP25', 'Code32', 'Telepen', 'Dotcode', 'IDDocument', 'IDMRZ',
+    'IDPicture', 'IDSignature', 'Databar14', 'DatabarLimited', 'DatabarExpanded', 'PostalIMB', 'Postnet', 'Planet',
+    'AustralianPost', 'RoyalMail', 'KIX', 'JapanesePost', 'MaxiCode'
+];
+
 /**
  * All constants exported as a single object
  */
@@ -180,7 +215,10 @@ const constants = {
     MulticodeCachingEnabled,
     EnableMisshaped1D,
     EnableVINRestrictions,
-    Formatting
+    Formatting,
+    Status,
+    Priority,
+    BarcodeTypes
 };
 
 module.exports = constants;
\ No newline at end of file
@@ -0,0 +1,122 @@
+/**
+ * Barkoder SDK Frame Stream
+ *
+ * Object-mode Duplex for live video: frames written to it are decoded on
+ * the native workers and results come out of its readable side. Writes are
+ * accepted at once, so a camera never blocks on the decoder. While every
+ * decode slot is busy, or results are not being read, only the newest frame
+ * is kept; a frame replaced before it could start is dropped and counted, so
+ * latency stays at one decode instead of growing with a queue.
+ *
+ * @version 1.6.2
+ * @author barKoder
+ */
+
+const { Duplex } = require('stream');
+
+/**
+ * Decodes the newest frames written to it, dropping stale ones
+ */
+class FrameStream extends Duplex {
+    /**
+     * @param {Function} decode - decodeImageAsync(buffer, width, height, options)
+     * @param {Object} options - Stream options
+     * @param {number} options.concurrency - Frames decoded at the same time (default: 1)
+     * @param {Object} options.decodeOptions - Passed to every decode, e.g. timeout and priority
+     */
+    constructor(decode, { concurrency = 1, decodeOptions = {} } = {}) {
+        if (!Number.isInteger(concurrency) || concurrency < 1) {
+            throw new Error('Concurrency must be a positive integer');
+        }
+        super({ objectMode: true });
+        this.decode = decode;
+        this.concurrency = concurrency;
+        this.decodeOptions = decodeOptions;
+        this.aborter = new AbortController();
+        this.inFlight = 0;
+        this.waiting = null;
+        this.finishing = null;
+        this.readableFull = false;
+        /** Frames replaced by a newer one before they could be decoded */
+        this.dropped = 0;
+        /** Frames decoded */
+        this.decoded = 0;
+    }
+
+    _write(frame, encoding, callback) {
+        if (!frame || !Buffer.isBuffer(frame.buffer) || typeof frame.width !== 'number' || typeof frame.height !== 'number') {
+            callback(new Error('Frames must have a Buffer and numeric width and height'));
+            return;
+        }
+        if (this.inFlight < this.concurrency && !this.readableFull) {
+            this.start(frame);
+        } else {
+            if (this.waiting) {
+                this.dropped++;
+                this.emit('drop', this.waiting);
+            }
+            this.waiting = frame;
+        }
+        callback();
+    }
+
+    _final(callback) {
+        this.finishing = callback;
+        this.next();
+    }
+
+    _read() {
+        // The reader caught up, so decodes held back by a full readable side can start
+        this.readableFull = false;
+        this.next();
+    }
+
+    _destroy(error, callback) {
+        this.waiting = null;
+        this.aborter.abort();
+        callback(error);
+    }
+
+    /**
+     * Decode a frame in a free slot
+     * @param {Object} frame - Frame written by the caller
+     */
+    start(frame) {
+        this.inFlight++;
+        this.decode(frame.buffer, frame.width, frame.height, { ...this.decodeOptions, signal: this.aborter.signal })
+            .then(result => {
+                this.inFlight--;
+                if (this.destroyed) {
+                    return;
+                }
+                this.decoded++;
+                if (!this.push({ frame, result, dropped: this.dropped })) {
+                    this.readableFull = true;
+                }
+                this.next();
+            }, error => {
+                this.inFlight--;
+                if (!this.destroyed) {
+                    this.destroy(error);
+                }
+            });
+    }
+
+    /**
+     * Start the waiting frame once a slot is free and results are being read, or end the stream once the last decode finished
+     */
+    next() {
+        if (this.waiting && this.inFlight < this.concurrency && !this.readableFull) {
+            const frame = this.waiting;
+            this.waiting = null;
+            this.start(frame);
+        } else if (this.finishing && this.inFlight === 0 && !this.waiting) {
+            const callback = this.finishing;
+            this.finishing = null;
+            this.push(null);
+            callback();
+        }
+    }
+}
+
+module.exports = FrameStream;
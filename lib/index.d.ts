@@ -6,15 +6,111 @@
  * @author barKoder
  */
 
+import { Duplex } from 'stream';
+
+export interface Point {
+    x: number;
+    y: number;
+}
+
 export interface BarcodeResult {
     resultsCount: number;
     barcodeTypeName: string;
     textualData: string;
     character_set?: string;
+    /** Corners of the barcode in image pixels */
+    location?: Point[];
+    /** Outline of the barcode in image pixels, when the decoder provides one */
+    polygon?: Point[];
     results?: BarcodeResult[];
+    /** Speed that produced the results (cascade mode only) */
+    decodingSpeed?: DecodingSpeed;
+    /** Number of speeds tried (cascade mode only) */
+    cascadeAttempts?: number;
+    /** Escalation stopped because the time budget was spent (cascade mode only) */
+    cascadeBudgetExhausted?: boolean;
+    /** Downscale factor of the first pass (pyramid mode only) */
+    pyramidFactor?: number;
+    /** Number of tiles decoded (tile mode only) */
+    tiles?: number;
+    /** The time budget ran out, so later cascade levels, crops or tiles were skipped */
+    deadlineExceeded?: boolean;
     [key: string]: any;
 }
 
+export interface LatencySummary {
+    count: number;
+    meanMs: number;
+    p50Ms: number;
+    p90Ms: number;
+    p99Ms: number;
+    p999Ms: number;
+    maxMs: number;
+}
+
+export interface StageLatencies {
+    /** Waiting for a native worker (decodeImageAsync only) */
+    queueWait: LatencySummary;
+    /** Argument unpacking and input preparation */
+    conversion: LatencySummary;
+    /** Barkoder decoding, including every strategy pass */
+    decode: LatencySummary;
+    /** Building the result returned to JavaScript */
+    marshal: LatencySummary;
+    /** Call entry to result delivery */
+    total: LatencySummary;
+}
+
+export interface DecodeStats {
+    stages: StageLatencies;
+    breakdown: Array<{
+        decodingSpeed: DecodingSpeed;
+        imageSize: 'upTo1MP' | 'upTo4MP' | 'upTo16MP' | 'over16MP';
+        stages: StageLatencies;
+    }>;
+    results: {
+        /** Decoded results per barcode type */
+        byType: { [barcodeType: string]: number };
+        /** Decodes that returned no decoded barcode */
+        emptyDecodes: number;
+        /** Decode time of hits and misses for each set of enabled decoders that was used */
+        decoderSets: Array<{
+            /** Enabled decoder names, or 'other' once more sets were used than are tracked */
+            decoders: DecoderName[] | 'other';
+            hits: LatencySummary;
+            misses: LatencySummary;
+            results: { [barcodeType: string]: number };
+        }>;
+    };
+    queue: {
+        /** Tasks waiting for a native worker */
+        depth: number;
+        /** Native worker threads */
+        threads: number;
+        /** decodeImageAsync calls not settled yet */
+        pendingAsync: number;
+        /** Tasks waiting in each priority lane */
+        lanes: { interactive: number; bulk: number };
+        /** Interactive tasks run before a waiting bulk task gets a worker */
+        interactiveWeight: number;
+    };
+}
+
+export interface CaptureOptions {
+    /** Capture one of every this many decodes (default: 1) */
+    sampleEvery?: number;
+    /** File size after which frames are dropped (default: 0 = unlimited) */
+    maxBytes?: number;
+}
+
+export interface CaptureSummary {
+    frames: number;
+    /** Sampled frames discarded because the writer fell behind or the size limit was reached */
+    dropped: number;
+    bytes: number;
+    error?: string;
+}
+
 export interface ConfigObject {
     app_name: string;
     license_key: string;
@@ -144,10 +240,268 @@ export interface Constants {
         AAMVA: 3;
         SADL: 4;
     };
+    
+    Status: {
+        Ok: 0;
+        NotInitialized: 1;
+        InvalidArgument: 2;
+        SdkError: 3;
+        IoError: 4;
+        Aborted: 5;
+    };
+    
+    Priority: {
+        Interactive: 0;
+        Bulk: 1;
+    };
+    
+    /** Barcode type names indexed by the SDK's barcode type numbers */
+    BarcodeTypes: string[];
 }
 
 export type DecoderName = keyof Constants['Decoders'];
 export type DecodingSpeed = 0 | 1 | 2 | 3;
+export type StatusCode = 0 | 1 | 2 | 3 | 4 | 5;
+export type Priority = 0 | 1;
+
+/**
+ * Outcome of a setting call. Successful calls return shared instances, and a
+ * message is only built when a call fails.
+ */
+export declare class BarkoderStatus {
+    readonly code: StatusCode;
+    readonly message: string;
+    /** True when the setting was applied */
+    readonly ok: boolean;
+    /** Throw a BarkoderError if the call failed */
+    throwIfError(): this;
+    /** "SUCCESS: ..." or "ERROR: ...", as earlier versions returned */
+    toString(): string;
+    /** Same as toString().startsWith(prefix), for code written against the string results */
+    startsWith(prefix: string): boolean;
+}
+
+/**
+ * Error thrown by BarkoderStatus.throwIfError()
+ */
+export declare class BarkoderError extends Error {
+    readonly code: StatusCode;
+}
+
+export interface InitializeOptions {
+    /** Let the SDK finish setting up in the background after license validation (default: false) */
+    lazyInit?: boolean;
+}
+
+export interface DecodeOptions {
+    /** Time budget in ms; once it runs out the remaining cascade levels, crops and tiles are skipped */
+    timeout?: number;
+    /** Same as timeout, as an absolute Date.now() time; the earlier of the two applies */
+    deadline?: number;
+}
+
+export interface AsyncDecodeOptions extends DecodeOptions {
+    /**
+     * Stops the decode: a queued decode is dropped and its buffer released at once,
+     * a running one stops at its next cascade level, crop or tile
+     */
+    signal?: AbortSignal;
+    /** Native queue to wait in (default: constants.Priority.Interactive) */
+    priority?: Priority;
+}
+
+export interface WarmupOptions {
+    /** Decoder names or constants, each warmed on its own (default: the enabled decoders) */
+    decoders?: Array<DecoderName | number>;
+    /** [width, height] of the synthetic images (default: [[640, 480], [1920, 1080]]) */
+    resolutions?: Array<[number, number]>;
+    /** Decoding speeds (default: the configured speed and the cascade speeds) */
+    speeds?: DecodingSpeed[];
+    /** Decodes per combination and thread, the last one is reported as warm (default: 2) */
+    repeats?: number;
+}
+
+export interface WarmupPass {
+    decoder: number;
+    decoderName: string;
+    width: number;
+    height: number;
+    speed: DecodingSpeed;
+    /** Slowest first decode across threads */
+    firstMs: number;
+    /** Slowest last decode across threads */
+    warmMs: number;
+}
+
+export interface WarmupReport {
+    totalMs: number;
+    threads: number;
+    decodes: number;
+    passes: WarmupPass[];
+}
+
+export interface StartupEvents {
+    requireStart: number;
+    moduleLoaded: number | null;
+    exportsStart: number | null;
+    exportsDone: number | null;
+    requireDone: number;
+    licenseStart: number | null;
+    licenseDone: number | null;
+    optionsDone: number | null;
+    warmupStart: number | null;
+    warmupDone: number | null;
+    firstDecodeStart: number | null;
+    firstDecodeDone: number | null;
+}
+
+export interface StartupReport {
+    /** Milliseconds since process start, null when not reached yet */
+    events: StartupEvents;
+    /** Milliseconds per phase, null when not complete */
+    durations: {
+        beforeRequire: number;
+        /** Mapping and relocating the addon with the static SDK, and running its static initializers */
+        loadLibrary: number | null;
+        registerExports: number | null;
+        require: number;
+        license: number | null;
+        options: number | null;
+        warmup: number | null;
+        firstDecode: number | null;
+        untilFirstDecode: number | null;
+    };
+}
+
+export interface MemoryCategoryUsage {
+    bytes: number;
+    peakBytes: number;
+}
+
+export interface MemoryUsage {
+    categories: {
+        /** Image buffers kept alive by queued async decodes, already counted by V8 */
+        pinnedFrames: MemoryCategoryUsage;
+        /** Downscaled copies, crops and warm-up images */
+        conversionScratch: MemoryCategoryUsage;
+        /** JSON arena blocks and result strings not handed back yet */
+        resultBuffers: MemoryCategoryUsage;
+        /** Frames queued for the capture writer */
+        capture: MemoryCategoryUsage;
+        /** Config copies per decoding speed */
+        caches: MemoryCategoryUsage;
+        /** Trace event rings */
+        tracing: MemoryCategoryUsage;
+    };
+    /** Bytes allocated by the wrapper itself, every category except pinnedFrames */
+    ownedBytes: number;
+    /** Bytes reported to V8 with napi_adjust_external_memory */
+    reportedToV8: number;
+}
+
+export interface ResultRingLayout {
+    /** Records kept before the oldest is overwritten (default: 64) */
+    slots?: number;
+    /** Barcodes stored per record (default: 16) */
+    maxResults?: number;
+    /** UTF-8 text bytes stored per record (default: 4096) */
+    textBytes?: number;
+}
+
+/**
+ * Reader over decode records the native side writes into a SharedArrayBuffer.
+ * next() moves to the oldest unread record; the getters read it in place.
+ */
+export declare class ResultRing {
+    /** Record flag: more barcodes were found than the record stores */
+    static readonly RESULTS_DROPPED: 1;
+    /** Record flag: barcode text was cut, at a character boundary, to fit the record's text area */
+    static readonly TEXT_TRUNCATED: 2;
+    /** Record flag: the decode ran out of time and returned what it had found */
+    static readonly DEADLINE_EXCEEDED: 4;
+    /** Bytes a ring with these sizes needs */
+    static byteLength(layout?: ResultRingLayout): number;
+    /** Reader over a ring that is already attached, e.g. in a worker thread */
+    static fromBuffer(buffer: SharedArrayBuffer): ResultRing;
+    
+    constructor(layout?: ResultRingLayout, buffer?: SharedArrayBuffer);
+    
+    readonly buffer: SharedArrayBuffer;
+    readonly slots: number;
+    readonly maxResults: number;
+    readonly textBytes: number;
+    /** Records overwritten before they were read */
+    readonly dropped: number;
+    /** Records written since the ring was attached, modulo 2^32 */
+    readonly published: number;
+    
+    /** Forget the read position */
+    reset(): void;
+    /** Move to the oldest unread record, false when all have been read */
+    next(): boolean;
+    /** Whether the current record is still intact, check after reading it */
+    valid(): boolean;
+    
+    readonly frameId: number;
+    readonly status: StatusCode;
+    readonly resultsCount: number;
+    readonly storedCount: number;
+    readonly width: number;
+    readonly height: number;
+    readonly decodingSpeed: DecodingSpeed;
+    readonly flags: number;
+    readonly receivedMs: number;
+    readonly decodeMs: number;
+    readonly totalMs: number;
+    
+    barcodeType(index: number): number;
+    barcodeTypeName(index: number): string;
+    text(index: number): string;
+    cornerX(index: number, corner: 0 | 1 | 2 | 3): number;
+    cornerY(index: number, corner: 0 | 1 | 2 | 3): number;
+}
+
+/** Video frame written to a FrameStream; other fields are passed through to its result */
+export interface Frame {
+    /** Grayscale pixels, must not be modified until the frame's result is read or it is dropped */
+    buffer: Buffer;
+    width: number;
+    height: number;
+    [key: string]: any;
+}
+
+export interface FrameResult {
+    /** Frame as it was written */
+    frame: Frame;
+    result: BarcodeResult;
+    /** Frames dropped by the stream so far */
+    dropped: number;
+}
+
+export interface FrameStreamOptions extends DecodeOptions {
+    /** Frames decoded at the same time (default: 1) */
+    concurrency?: number;
+    /** Native queue the decodes wait in (default: constants.Priority.Interactive) */
+    priority?: Priority;
+}
+
+/**
+ * Object-mode Duplex that decodes frames written to it. While every decode slot
+ * is busy only the newest frame waits; older waiting frames are dropped.
+ */
+export declare class FrameStream extends Duplex implements AsyncIterable<FrameResult> {
+    /** Frames replaced by a newer one before they could be decoded */
+    readonly dropped: number;
+    /** Frames decoded */
+    readonly decoded: number;
+    readonly concurrency: number;
+    
+    read(size?: number): FrameResult | null;
+    on(event: 'data', listener: (result: FrameResult) => void): this;
+    on(event: 'drop', listener: (frame: Frame) => void): this;
+    on(event: string | symbol, listener: (...args: any[]) => void): this;
+    [Symbol.asyncIterator](): AsyncIterableIterator<FrameResult>;
+}
 
 /**
  * Main Barkoder SDK class
@@ -158,6 +512,22 @@ export declare class BarkoderSDK {
      */
     static readonly constants: Constants;
     
+    /**
+     * Status returned by the setting methods, and the error its throwIfError() throws
+     */
+    static readonly BarkoderStatus: typeof BarkoderStatus;
+    static readonly BarkoderError: typeof BarkoderError;
+    
+    /**
+     * Shared-memory reader for decodeToRing() results
+     */
+    static readonly ResultRing: typeof ResultRing;
+    
+    /**
+     * Duplex returned by frameStream()
+     */
+    static readonly FrameStream: typeof FrameStream;
+    
     /**
      * Get the SDK library version
      */
@@ -166,9 +536,25 @@ export declare class BarkoderSDK {
     /**
      * Initialize the SDK with a license key
      * @param licenseKey Valid Barkoder license key
+     * @returns "SUCCESS: ..." or "ERROR: ..." with the SDK's license response. Unlike the setting methods, this stays a string
      */
     static initialize(licenseKey: string): string;
     
+    /**
+     * Initialize the SDK with a license key on a separate thread. Async decodes issued
+     * meanwhile wait for it instead of failing.
+     * @param licenseKey Valid Barkoder license key
+     * @param options Set lazyInit to let the SDK finish setting up in the background
+     */
+    static initializeAsync(licenseKey: string, options?: InitializeOptions): Promise<string>;
+    
+    /**
+     * Run synthetic decodes on every native decode thread before serving traffic
+     * Warm-ups run one at a time, a call made while one runs starts after it
+     * @param options Decoders, resolutions and speeds to warm
+     */
+    static warmup(options?: WarmupOptions): Promise<WarmupReport>;
+    
     /**
      * Check if the SDK is initialized
      */
@@ -190,13 +576,53 @@ export declare class BarkoderSDK {
      * Set which decoders are enabled for scanning
      * @param decoders Array of decoder type constants
      */
-    static setEnabledDecoders(decoders: number[]): string;
+    static setEnabledDecoders(decoders: number[]): BarkoderStatus;
     
     /**
      * Set the decoding speed
      * @param speed Speed constant (Fast=0, Normal=1, Slow=2, Rigorous=3)
      */
-    static setDecodingSpeed(speed: DecodingSpeed): string;
+    static setDecodingSpeed(speed: DecodingSpeed): BarkoderStatus;
+    
+    /**
+     * Set the speeds tried in turn when a decode finds nothing
+     * @param speeds Speed constants to escalate through, fastest first (empty array disables)
+     * @param timeBudgetMs Per-request time after which no further speed is tried (0 = unlimited)
+     */
+    static setDecodingCascade(speeds: DecodingSpeed[], timeBudgetMs?: number): BarkoderStatus;
+    
+    /**
+     * Decode large images coarse-to-fine
+     * @param factor Downscale factor of the first pass, 2 or 4 (1 disables)
+     * @param minPixels Images with fewer pixels are decoded directly (default: 4000000)
+     * @param fullFrameFallback Decode the full image when the downscaled pass finds nothing (default: false)
+     */
+    static setPyramidMode(factor: 1 | 2 | 4, minPixels?: number, fullFrameFallback?: boolean): BarkoderStatus;
+    
+    /**
+     * Decode huge images as overlapping tiles on the native thread pool
+     * @param maxBarcodeSize Largest expected barcode side in pixels (0 disables)
+     * @param minPixels Images with fewer pixels are not tiled (default: 4000000)
+     */
+    static setTileMode(maxBarcodeSize: number, minPixels?: number): BarkoderStatus;
+    
+    /**
+     * Set the number of native threads used for parallel decoding
+     * @param threads Thread count (0 = one per CPU core)
+     */
+    static setDecodeThreads(threads: number): BarkoderStatus;
+    
+    /**
+     * Set how many interactive decodes run before a waiting bulk decode gets a worker
+     * @param weight Interactive decodes per bulk decode (at least 1, default: 8)
+     */
+    static setInteractiveWeight(weight: number): BarkoderStatus;
+    
+    /**
+     * Set the maximum number of barcodes returned per image
+     * @param count Maximum results count
+     */
+    static setMaximumResultsCount(count: number): BarkoderStatus;
     
     /**
      * Set the region of interest for scanning
@@ -205,21 +631,126 @@ export declare class BarkoderSDK {
      * @param width Width (0-100)
      * @param height Height (0-100)
      */
-    static setRegionOfInterest(left: number, top: number, width: number, height: number): string;
+    static setRegionOfInterest(left: number, top: number, width: number, height: number): BarkoderStatus;
     
     /**
      * Decode barcode from image buffer
      * @param imageBuffer Buffer containing grayscale image data
      * @param width Image width in pixels
      * @param height Image height in pixels
+     * @param options Time budget of the decode
+     */
+    static decodeImage(imageBuffer: Buffer, width: number, height: number, options?: DecodeOptions): BarcodeResult;
+    
+    /**
+     * Decode barcode from image buffer on a native worker thread
+     * @param imageBuffer Buffer containing grayscale image data, must not be modified until the promise settles
+     * @param width Image width in pixels
+     * @param height Image height in pixels
+     * @param options Abort signal, whose abort rejects the promise with its reason, and time budget,
+     *                which counts time spent queued
+     */
+    static decodeImageAsync(imageBuffer: Buffer, width: number, height: number, options?: AsyncDecodeOptions): Promise<BarcodeResult>;
+    
+    /**
+     * Start publishing decodeToRing() results into a ring, replacing any attached ring
+     * @param ring Ring to write into, cleared and rewound
+     */
+    static attachResultRing(ring: ResultRing): BarkoderStatus;
+    
+    /**
+     * Stop publishing into the attached ring
+     */
+    static detachResultRing(): BarkoderStatus;
+    
+    /**
+     * Decode barcode from image buffer and publish the results to the attached ring
+     * @param imageBuffer Buffer containing grayscale image data
+     * @param width Image width in pixels
+     * @param height Image height in pixels
+     * @param frameId Tag copied into the record (default: 0)
+     * @param options Time budget of the decode
+     */
+    static decodeToRing(imageBuffer: Buffer, width: number, height: number, frameId?: number,
+                        options?: DecodeOptions): BarkoderStatus;
+    
+    /**
+     * Decode on a native worker thread and publish the results to the attached ring
+     * @param imageBuffer Buffer containing grayscale image data, must not be modified until its record is published
+     * @param width Image width in pixels
+     * @param height Image height in pixels
+     * @param frameId Tag copied into the record (default: 0)
+     * @param options Abort signal, whose abort publishes the record with status Aborted, and time budget
+     */
+    static decodeToRingAsync(imageBuffer: Buffer, width: number, height: number, frameId?: number,
+                             options?: AsyncDecodeOptions): BarkoderStatus;
+    
+    /**
+     * Create a stream that decodes frames written to it, keeping only the newest frame while the decoders are busy
+     * @param options Decodes at a time, and time budget and priority of each decode
+     */
+    static frameStream(options?: FrameStreamOptions): FrameStream;
+    
+    /**
+     * Decode frames from an iterable, e.g. a camera source, dropping stale ones like frameStream()
+     * @param frames Frames to decode
+     * @param options Same as frameStream()
+     */
+    static decodeFrames(frames: AsyncIterable<Frame> | Iterable<Frame>, options?: FrameStreamOptions): FrameStream;
+    
+    /**
+     * Get decode latency statistics since the last reset
+     */
+    static getStats(): DecodeStats;
+    
+    /**
+     * Start decode latency statistics from zero
+     */
+    static resetStats(): void;
+    
+    /**
+     * Start recording a timeline of decode stages
+     * @param capacity Number of most recent events kept (default: 65536)
+     */
+    static startTracing(capacity?: number): BarkoderStatus;
+    
+    /**
+     * Stop recording and get the timeline as Chrome trace-event JSON
+     */
+    static stopTracing(): string;
+    
+    /**
+     * Start recording sampled decode requests to a capture file for bench/replay.js
+     * @param path Capture file, replaced if it exists
+     * @param options Sampling interval and size limit
+     */
+    static startCapture(path: string, options?: CaptureOptions): BarkoderStatus;
+    
+    /**
+     * Stop capturing and finish the capture file
+     */
+    static stopCapture(): CaptureSummary;
+    
+    /**
+     * Render decode metrics in the OpenMetrics (Prometheus) text format
+     */
+    static metricsText(): string;
+    
+    /**
+     * Get the startup milestones of this process and the time spent in each phase
+     */
+    static startupReport(): StartupReport;
+    
+    /**
+     * Get the native memory held by the wrapper, per category
      */
-    static decodeImage(imageBuffer: Buffer, width: number, height: number): BarcodeResult;
+    static memoryUsage(): MemoryUsage;
     
     /**
      * Helper method to enable only specific decoder types
      * @param decoderNames Array of decoder names (e.g., ['QR', 'PDF417'])
      */
-    static enableDecoders(decoderNames: DecoderName[]): string;
+    static enableDecoders(decoderNames: DecoderName[]): BarkoderStatus;
 }
 
 export default BarkoderSDK;
\ No newline at end of file
@@ -8,8 +8,128 @@
  * @author barKoder
  */
 
+// Loading the addon maps the statically linked SDK, timed for startupReport()
+const requireStart = performance.now();
 const BarkoderNative = require('../build/Release/barkoder');
+const requireDone = performance.now();
 const constants = require('./constants');
+const { BarkoderStatus, BarkoderError } = require('./status');
+const ResultRing = require('./resultRing');
+const FrameStream = require('./frameStream');
+const { Readable, pipeline } = require('stream');
+
+/**
+ * Statuses of successful setting calls, shared so the common case allocates nothing
+ */
+const Applied = {
+    enabledDecoders: new BarkoderStatus(constants.Status.Ok, 'Enabled decoders set'),
+    decodingSpeed: new BarkoderStatus(constants.Status.Ok, 'Decoding speed set'),
+    decodingCascade: new BarkoderStatus(constants.Status.Ok, 'Decoding cascade set'),
+    pyramidMode: new BarkoderStatus(constants.Status.Ok, 'Pyramid mode set'),
+    tileMode: new BarkoderStatus(constants.Status.Ok, 'Tile mode set'),
+    decodeThreads: new BarkoderStatus(constants.Status.Ok, 'Decode threads set'),
+    interactiveWeight: new BarkoderStatus(constants.Status.Ok, 'Interactive weight set'),
+    maximumResultsCount: new BarkoderStatus(constants.Status.Ok, 'Maximum results count set'),
+    regionOfInterest: new BarkoderStatus(constants.Status.Ok, 'Region of interest set'),
+    tracing: new BarkoderStatus(constants.Status.Ok, 'Tracing started'),
+    capture: new BarkoderStatus(constants.Status.Ok, 'Capture started'),
+    resultRingAttached: new BarkoderStatus(constants.Status.Ok, 'Result ring attached'),
+    resultRingDetached: new BarkoderStatus(constants.Status.Ok, 'Result ring detached'),
+    decodedToRing: new BarkoderStatus(constants.Status.Ok, 'Decode published to the result ring'),
+    queuedToRing: new BarkoderStatus(constants.Status.Ok, 'Decode queued for the result ring')
+};
+
+/**
+ * Turn a native status code into a status, fetching the message only when the call failed
+ * @param {number} code - Status code returned by the native call
+ * @param {BarkoderStatus} applied - Status to return on success
+ * @returns {BarkoderStatus}
+ */
+function toStatus(code, applied) {
+    return code === constants.Status.Ok ? applied : new BarkoderStatus(code, BarkoderNative.getLastError());
+}
+
+// Native ids of the AbortSignals passed to async decodes, so each signal gets one 'abort' listener
+const signalIds = new WeakMap();
+let lastSignalId = 0;
+
+/**
+ * Reason a signal was aborted with, or an AbortError on Node versions without signal.reason
+ * @param {AbortSignal} signal - Aborted signal
+ * @returns {*}
+ */
+function abortReason(signal) {
+    if (signal.reason !== undefined) {
+        return signal.reason;
+    }
+    const error = new Error('The operation was aborted');
+    error.name = 'AbortError';
+    error.code = 'ABORT_ERR';
+    return error;
+}
+
+/**
+ * Get the id native decodes are tied to a signal with, registering its abort listener on first use
+ * @param {AbortSignal} signal - Signal passed by the caller, not aborted yet
+ * @returns {number} Id for the native async decode calls
+ */
+function signalId(signal) {
+    let id = signalIds.get(signal);
+    if (id === undefined) {
+        lastSignalId = lastSignalId % 0xFFFFFFFF + 1;
+        id = lastSignalId;
+        signalIds.set(signal, id);
+        signal.addEventListener('abort', () => BarkoderNative.abortDecode(id), { once: true });
+    }
+    return id;
+}
+
+/**
+ * Check the signal option of an async decode
+ * @param {Object} options - Options passed by the caller
+ * @returns {AbortSignal|undefined}
+ */
+function signalOption(options) {
+    const { signal } = options;
+    if (signal !== undefined && !(signal instanceof AbortSignal)) {
+        throw new Error('Signal must be an AbortSignal');
+    }
+    return signal;
+}
+
+/**
+ * Check the timeout and deadline options of a decode and turn them into the time left for it
+ * @param {Object} options - Options passed by the caller
+ * @returns {number} Budget in ms from now, 0 once the deadline has passed, -1 without a limit
+ */
+function budgetOption(options) {
+    const { timeout, deadline } = options;
+    if ((timeout !== undefined && typeof timeout !== 'number') || (deadline !== undefined && typeof deadline !== 'number')) {
+        throw new Error('Timeout and deadline must be numbers');
+    }
+    let budgetMs = -1;
+    if (timeout !== undefined) {
+        budgetMs = Math.max(timeout, 0);
+    }
+    if (deadline !== undefined) {
+        const left = Math.max(deadline - Date.now(), 0);
+        budgetMs = budgetMs < 0 ? left : Math.min(budgetMs, left);
+    }
+    return budgetMs;
+}
+
+/**
+ * Check the priority option of an async decode
+ * @param {Object} options - Options passed by the caller
+ * @returns {number} constants.Priority value, Interactive by default
+ */
+function priorityOption(options) {
+    const { priority = constants.Priority.Interactive } = options;
+    if (priority !== constants.Priority.Interactive && priority !== constants.Priority.Bulk) {
+        throw new Error('Priority must be a constants.Priority value');
+    }
+    return priority;
+}
 
 /**
  * Main BarkoderSDK class
@@ -19,6 +139,19 @@ class BarkoderSDK {
      * Constants for decoder types, speeds, etc.
      */
     static constants = constants;
+    /**
+     * Status returned by the setting methods, and the error its throwIfError() throws
+     */
+    static BarkoderStatus = BarkoderStatus;
+    static BarkoderError = BarkoderError;
+    /**
+     * Shared-memory reader for decodeToRing() results
+     */
+    static ResultRing = ResultRing;
+    /**
+     * Duplex returned by frameStream()
+     */
+    static FrameStream = FrameStream;
     /**
      * Get the SDK library version
      * @returns {string} SDK version string
@@ -30,7 +163,7 @@ class BarkoderSDK {
     /**
      * Initialize the SDK with a license key
      * @param {string} licenseKey - Valid Barkoder license key
-     * @returns {string} Initialization result message
+     * @returns {string} "SUCCESS: ..." or "ERROR: ..." with the SDK's license response; unlike the setting methods, not a BarkoderStatus
      */
     static initialize(licenseKey) {
         if (typeof licenseKey !== 'string') {
@@ -39,6 +172,77 @@ class BarkoderSDK {
         return BarkoderNative.initialize(licenseKey);
     }
 
+    /**
+     * Initialize the SDK with a license key without blocking the event loop.
+     * License validation runs on its own thread. decodeImageAsync and decodeToRingAsync
+     * calls made meanwhile wait for it and then decode with the settings in effect at that point;
+     * other calls fail as before initialization.
+     * @param {string} licenseKey - Valid Barkoder license key
+     * @param {Object} options - Initialization options
+     * @param {boolean} options.lazyInit - Let the SDK finish setting up in the background after validation,
+     *                                     so the first decodes may be slower (default: false)
+     * @returns {Promise<string>} Initialization result message, as initialize() returns it
+     */
+    static async initializeAsync(licenseKey, options = {}) {
+        if (typeof licenseKey !== 'string') {
+            throw new Error('License key must be a string');
+        }
+        const { lazyInit = false } = options;
+        return BarkoderNative.initializeAsync(licenseKey, Boolean(lazyInit));
+    }
+
+    /**
+     * Run synthetic decodes on every native decode thread so the first real decodes
+     * are not slowed by cold code, lazily built tables and unfaulted buffers.
+     * Await it before reporting the process ready. Waits for initializeAsync() if it is running,
+     * and for warm-ups started before it: they run one at a time.
+     * @param {Object} options - What to warm
+     * @param {Array<string|number>} options.decoders - Decoder names or constants, each warmed on its own (default: the enabled decoders)
+     * @param {Array<Array<number>>} options.resolutions - [width, height] of the synthetic images (default: [[640, 480], [1920, 1080]])
+     * @param {Array<number>} options.speeds - Decoding speeds (default: the configured speed and the cascade speeds)
+     * @param {number} options.repeats - Decodes per combination and thread, the last one is reported as warm (default: 2)
+     * @returns {Promise<Object>} Time spent, thread and decode counts, and per-combination first and warm decode times
+     */
+    static async warmup(options = {}) {
+        const { decoders = [], resolutions = [], speeds = [], repeats = 2 } = options;
+        if (!Array.isArray(decoders) || !Array.isArray(resolutions) || !Array.isArray(speeds)) {
+            throw new Error('Decoders, resolutions and speeds must be arrays');
+        }
+        if (typeof repeats !== 'number') {
+            throw new Error('Repeats must be a number');
+        }
+        const decoderValues = decoders.map(decoder => {
+            if (typeof decoder === 'number') {
+                return decoder;
+            }
+            if (!(decoder in constants.Decoders)) {
+                throw new Error(`Unknown decoder: ${decoder}`);
+            }
+            return constants.Decoders[decoder];
+        });
+        const sizes = [];
+        for (const resolution of resolutions) {
+            if (!Array.isArray(resolution) || resolution.length !== 2) {
+                throw new Error('Resolutions must be [width, height] pairs');
+            }
+            sizes.push(resolution[0], resolution[1]);
+        }
+
+        const reportJson = await BarkoderNative.warmup(decoderValues, sizes, speeds, repeats);
+        if (reportJson.startsWith('ERROR:')) {
+            throw new Error(reportJson.substring(6).trim());
+        }
+        const report = JSON.parse(reportJson);
+        if (report.error) {
+            throw new Error('Warm-up decode failed: ' + report.error);
+        }
+        const decoderNames = Object.keys(constants.Decoders);
+        for (const pass of report.passes) {
+            pass.decoderName = decoderNames.find(name => constants.Decoders[name] === pass.decoder) || '';
+        }
+        return report;
+    }
+
     /**
      * Check if the SDK is initialized
      * @returns {boolean} True if initialized, false otherwise
@@ -91,25 +295,113 @@ class BarkoderSDK {
     /**
      * Set which decoders are enabled for scanning
      * @param {Array<number>} decoders - Array of decoder type constants
-     * @returns {string} Result message
+     * @returns {BarkoderStatus} Status of the call
      */
     static setEnabledDecoders(decoders) {
         if (!Array.isArray(decoders)) {
             throw new Error('Decoders must be an array');
         }
-        return BarkoderNative.setEnabledDecoders(decoders);
+        return toStatus(BarkoderNative.setEnabledDecoders(decoders), Applied.enabledDecoders);
     }
 
     /**
      * Set the decoding speed
      * @param {number} speed - Speed constant (Fast=0, Normal=1, Slow=2, Rigorous=3)
-     * @returns {string} Result message
+     * @returns {BarkoderStatus} Status of the call
      */
     static setDecodingSpeed(speed) {
         if (typeof speed !== 'number') {
             throw new Error('Speed must be a number');
         }
-        return BarkoderNative.setDecodingSpeed(speed);
+        if (!Object.values(constants.DecodingSpeed).includes(speed)) {
+            throw new Error(`Unknown decoding speed: ${speed}`);
+        }
+        return toStatus(BarkoderNative.setDecodingSpeed(speed), Applied.decodingSpeed);
+    }
+
+    /**
+     * Set the speeds tried in turn when a decode finds nothing.
+     * Each decode starts at the fastest speed and escalates only on a miss.
+     * @param {Array<number>} speeds - Speed constants to escalate through (empty array disables)
+     * @param {number} timeBudgetMs - Per-request time after which no further speed is tried (0 = unlimited)
+     * @returns {BarkoderStatus} Status of the call
+     */
+    static setDecodingCascade(speeds, timeBudgetMs = 0) {
+        if (!Array.isArray(speeds)) {
+            throw new Error('Speeds must be an array');
+        }
+        if (typeof timeBudgetMs !== 'number') {
+            throw new Error('Time budget must be a number');
+        }
+        return toStatus(BarkoderNative.setDecodingCascade(speeds, timeBudgetMs), Applied.decodingCascade);
+    }
+
+    /**
+     * Decode large images coarse-to-fine.
+     * A downscaled copy is decoded first, then full-resolution crops around what it found.
+     * Result coordinates always refer to the original image.
+     * @param {number} factor - Downscale factor of the first pass, 2 or 4 (1 disables)
+     * @param {number} minPixels - Images with fewer pixels are decoded directly
+     * @param {boolean} fullFrameFallback - Decode the full image when the downscaled pass finds nothing
+     * @returns {BarkoderStatus} Status of the call
+     */
+    static setPyramidMode(factor, minPixels = 4000000, fullFrameFallback = false) {
+        if (typeof factor !== 'number' || typeof minPixels !== 'number') {
+            throw new Error('Factor and minimum pixels must be numbers');
+        }
+        return toStatus(BarkoderNative.setPyramidMode(factor, minPixels, Boolean(fullFrameFallback)), Applied.pyramidMode);
+    }
+
+    /**
+     * Decode huge images as overlapping tiles on the native thread pool.
+     * Tiles overlap by the largest expected barcode size, and barcodes found in two tiles are merged.
+     * Decoding stops early once the maximum results count is reached.
+     * Takes precedence over pyramid mode for images both apply to.
+     * @param {number} maxBarcodeSize - Largest expected barcode side in pixels (0 disables)
+     * @param {number} minPixels - Images with fewer pixels are not tiled
+     * @returns {BarkoderStatus} Status of the call
+     */
+    static setTileMode(maxBarcodeSize, minPixels = 4000000) {
+        if (typeof maxBarcodeSize !== 'number' || typeof minPixels !== 'number') {
+            throw new Error('Maximum barcode size and minimum pixels must be numbers');
+        }
+        return toStatus(BarkoderNative.setTileMode(maxBarcodeSize, minPixels), Applied.tileMode);
+    }
+
+    /**
+     * Set the number of native threads used for parallel decoding
+     * @param {number} threads - Thread count (0 = one per CPU core)
+     * @returns {BarkoderStatus} Status of the call
+     */
+    static setDecodeThreads(threads) {
+        if (typeof threads !== 'number') {
+            throw new Error('Thread count must be a number');
+        }
+        return toStatus(BarkoderNative.setDecodeThreads(threads), Applied.decodeThreads);
+    }
+
+    /**
+     * Set how many interactive decodes run before a waiting bulk decode gets a worker
+     * @param {number} weight - Interactive decodes per bulk decode (at least 1, default: 8)
+     * @returns {BarkoderStatus} Status of the call
+     */
+    static setInteractiveWeight(weight) {
+        if (typeof weight !== 'number') {
+            throw new Error('Weight must be a number');
+        }
+        return toStatus(BarkoderNative.setInteractiveWeight(weight), Applied.interactiveWeight);
+    }
+
+    /**
+     * Set the maximum number of barcodes returned per image
+     * @param {number} count - Maximum results count (default after initialization: 1)
+     * @returns {BarkoderStatus} Status of the call
+     */
+    static setMaximumResultsCount(count) {
+        if (typeof count !== 'number') {
+            throw new Error('Results count must be a number');
+        }
+        return toStatus(BarkoderNative.setMaximumResultsCount(count), Applied.maximumResultsCount);
     }
 
     /**
@@ -118,14 +410,14 @@ class BarkoderSDK {
      * @param {number} top - Top coordinate (0-100) 
      * @param {number} width - Width (0-100)
      * @param {number} height - Height (0-100)
-     * @returns {string} Result message
+     * @returns {BarkoderStatus} Status of the call
      */
     static setRegionOfInterest(left, top, width, height) {
         if (typeof left !== 'number' || typeof top !== 'number' || 
             typeof width !== 'number' || typeof height !== 'number') {
             throw new Error('All ROI parameters must be numbers');
         }
-        return BarkoderNative.setRegionOfInterest(left, top, width, height);
+        return toStatus(BarkoderNative.setRegionOfInterest(left, top, width, height), Applied.regionOfInterest);
     }
 
     /**
@@ -133,17 +425,76 @@ class BarkoderSDK {
      * @param {Buffer} imageBuffer - Buffer containing grayscale image data
      * @param {number} width - Image width in pixels
      * @param {number} height - Image height in pixels
+     * @param {Object} options - Decode options
+     * @param {number} options.timeout - Time budget in ms; once it runs out the remaining cascade levels, crops and
+     *                                   tiles are skipped and the result is marked deadlineExceeded
+     * @param {number} options.deadline - Same as timeout, as an absolute Date.now() time; the earlier of the two applies
      * @returns {Object} Decoded barcode result(s) as JSON object
      */
-    static decodeImage(imageBuffer, width, height) {
+    static decodeImage(imageBuffer, width, height, options = {}) {
+        if (!Buffer.isBuffer(imageBuffer)) {
+            throw new Error('First parameter must be a Buffer');
+        }
+        if (typeof width !== 'number' || typeof height !== 'number') {
+            throw new Error('Width and height must be numbers');
+        }
+        
+        const resultJson = BarkoderNative.decodeImage(imageBuffer, width, height, budgetOption(options));
+        
+        try {
+            return JSON.parse(resultJson);
+        } catch (error) {
+            throw new Error('Failed to parse decode result: ' + error.message);
+        }
+    }
+
+    /**
+     * Decode barcode from image buffer on a native worker thread
+     * @param {Buffer} imageBuffer - Buffer containing grayscale image data, must not be modified until the promise settles
+     * @param {number} width - Image width in pixels
+     * @param {number} height - Image height in pixels
+     * @param {Object} options - Decode options
+     * @param {AbortSignal} options.signal - Rejects the promise with the abort reason; a queued decode is dropped
+     *                                       and its buffer released, a running one stops at its next cascade level, crop or tile
+     * @param {number} options.timeout - Time budget in ms, counting time spent queued; a decode still queued when it
+     *                                   runs out resolves with no results, marked deadlineExceeded
+     * @param {number} options.deadline - Same as timeout, as an absolute Date.now() time; the earlier of the two applies
+     * @param {number} options.priority - constants.Priority queue to wait in (default: Interactive)
+     * @returns {Promise<Object>} Decoded barcode result(s) as JSON object
+     */
+    static async decodeImageAsync(imageBuffer, width, height, options = {}) {
         if (!Buffer.isBuffer(imageBuffer)) {
             throw new Error('First parameter must be a Buffer');
         }
         if (typeof width !== 'number' || typeof height !== 'number') {
             throw new Error('Width and height must be numbers');
         }
+        const signal = signalOption(options);
+        const budgetMs = budgetOption(options);
+        const priority = priorityOption(options);
         
-        const resultJson = BarkoderNative.decodeImage(imageBuffer, width, height);
+        let resultJson;
+        if (signal === undefined) {
+            resultJson = await BarkoderNative.decodeImageAsync(imageBuffer, width, height, 0, budgetMs, priority);
+        } else {
+            if (signal.aborted) {
+                throw abortReason(signal);
+            }
+            const pending = BarkoderNative.decodeImageAsync(imageBuffer, width, height, signalId(signal), budgetMs, priority);
+            let onAbort;
+            const aborted = new Promise((resolve, reject) => {
+                onAbort = () => reject(abortReason(signal));
+                signal.addEventListener('abort', onAbort, { once: true });
+            });
+            try {
+                resultJson = await Promise.race([pending, aborted]);
+            } finally {
+                signal.removeEventListener('abort', onAbort);
+            }
+        }
+        if (resultJson.startsWith('ERROR:')) {
+            throw new Error(resultJson.substring(6).trim());
+        }
         
         try {
             return JSON.parse(resultJson);
@@ -152,10 +503,258 @@ class BarkoderSDK {
         }
     }
 
+    /**
+     * Start publishing decodeToRing() results into a ring's SharedArrayBuffer,
+     * replacing any attached ring. Clears the ring and rewinds its reader.
+     * @param {ResultRing} ring - Ring to write into
+     * @returns {BarkoderStatus} Status of the call
+     */
+    static attachResultRing(ring) {
+        if (!(ring instanceof ResultRing)) {
+            throw new Error('Ring must be a ResultRing');
+        }
+        const status = toStatus(BarkoderNative.attachResultRing(new Uint8Array(ring.buffer), ring.slots, ring.maxResults,
+                                                                ring.textBytes), Applied.resultRingAttached);
+        if (status.ok) {
+            ring.reset();
+        }
+        return status;
+    }
+
+    /**
+     * Stop publishing into the attached ring. Queued decodes finishing later are not published.
+     * @returns {BarkoderStatus} Status of the call
+     */
+    static detachResultRing() {
+        return toStatus(BarkoderNative.detachResultRing(), Applied.resultRingDetached);
+    }
+
+    /**
+     * Decode barcode from image buffer and publish the results to the attached ring
+     * instead of returning them, so the call creates no result objects.
+     * Failed decodes are published too, with their status code.
+     * @param {Buffer} imageBuffer - Buffer containing grayscale image data
+     * @param {number} width - Image width in pixels
+     * @param {number} height - Image height in pixels
+     * @param {number} frameId - Tag copied into the record (32-bit integer, default: 0)
+     * @param {Object} options - Decode options
+     * @param {number} options.timeout - Time budget in ms; a record cut short has ResultRing.DEADLINE_EXCEEDED set
+     * @param {number} options.deadline - Same as timeout, as an absolute Date.now() time; the earlier of the two applies
+     * @returns {BarkoderStatus} Status of the call
+     */
+    static decodeToRing(imageBuffer, width, height, frameId = 0, options = {}) {
+        if (!Buffer.isBuffer(imageBuffer)) {
+            throw new Error('First parameter must be a Buffer');
+        }
+        if (typeof width !== 'number' || typeof height !== 'number' || typeof frameId !== 'number') {
+            throw new Error('Width, height and frame id must be numbers');
+        }
+        return toStatus(BarkoderNative.decodeToRing(imageBuffer, width, height, frameId, budgetOption(options)),
+                        Applied.decodedToRing);
+    }
+
+    /**
+     * Decode barcode from image buffer on a native worker thread and publish the
+     * results to the attached ring. Returns once the decode is queued.
+     * @param {Buffer} imageBuffer - Buffer containing grayscale image data, must not be modified until its record is published
+     * @param {number} width - Image width in pixels
+     * @param {number} height - Image height in pixels
+     * @param {number} frameId - Tag copied into the record (32-bit integer, default: 0)
+     * @param {Object} options - Decode options
+     * @param {AbortSignal} options.signal - Publishes the record with status Aborted instead; a queued decode is
+     *                                       dropped and its buffer released, a running one stops at its next step
+     * @param {number} options.timeout - Time budget in ms, counting time spent queued; a record cut short or
+     *                                   skipped has ResultRing.DEADLINE_EXCEEDED set
+     * @param {number} options.deadline - Same as timeout, as an absolute Date.now() time; the earlier of the two applies
+     * @param {number} options.priority - constants.Priority queue to wait in (default: Interactive)
+     * @returns {BarkoderStatus} Status of queuing the decode
+     */
+    static decodeToRingAsync(imageBuffer, width, height, frameId = 0, options = {}) {
+        if (!Buffer.isBuffer(imageBuffer)) {
+            throw new Error('First parameter must be a Buffer');
+        }
+        if (typeof width !== 'number' || typeof height !== 'number' || typeof frameId !== 'number') {
+            throw new Error('Width, height and frame id must be numbers');
+        }
+        const signal = signalOption(options);
+        const budgetMs = budgetOption(options);
+        const priority = priorityOption(options);
+        if (signal === undefined) {
+            return toStatus(BarkoderNative.decodeToRingAsync(imageBuffer, width, height, frameId, 0, budgetMs, priority),
+                            Applied.queuedToRing);
+        }
+        if (signal.aborted) {
+            return new BarkoderStatus(constants.Status.Aborted, 'Decode aborted');
+        }
+        return toStatus(BarkoderNative.decodeToRingAsync(imageBuffer, width, height, frameId, signalId(signal), budgetMs,
+                                                         priority),
+                        Applied.queuedToRing);
+    }
+
+    /**
+     * Create a stream that decodes frames written to it, keeping only the newest frame while the decoders are busy
+     * @param {Object} options - Stream options
+     * @param {number} options.concurrency - Frames decoded at the same time (default: 1)
+     * @param {number} options.timeout - Time budget of each decode in ms
+     * @param {number} options.priority - constants.Priority queue the decodes wait in (default: Interactive)
+     * @returns {FrameStream} Object-mode Duplex: write { buffer, width, height, ... } frames,
+     *                        read { frame, result, dropped } objects
+     */
+    static frameStream(options = {}) {
+        const { concurrency, ...decodeOptions } = options;
+        if (decodeOptions.signal !== undefined) {
+            throw new Error('Destroy the stream to stop its decodes');
+        }
+        budgetOption(decodeOptions);
+        priorityOption(decodeOptions);
+        return new FrameStream(BarkoderSDK.decodeImageAsync, { concurrency, decodeOptions });
+    }
+
+    /**
+     * Decode frames from an iterable, e.g. a camera source, dropping stale ones like frameStream()
+     * @param {AsyncIterable<Object>|Iterable<Object>} frames - { buffer, width, height, ... } frames
+     * @param {Object} options - Same as frameStream()
+     * @returns {FrameStream} Async iterable of { frame, result, dropped } objects
+     */
+    static decodeFrames(frames, options = {}) {
+        if (frames == null || (typeof frames[Symbol.asyncIterator] !== 'function' && typeof frames[Symbol.iterator] !== 'function')) {
+            throw new Error('Frames must be iterable');
+        }
+        const stream = BarkoderSDK.frameStream(options);
+        // Errors reach the caller through the stream, which pipeline destroys with them
+        pipeline(Readable.from(frames), stream, () => {});
+        return stream;
+    }
+
+    /**
+     * Get decode latency statistics since the last reset
+     * @returns {Object} Per-stage latency percentiles, broken down by decoding speed and image size
+     */
+    static getStats() {
+        return JSON.parse(BarkoderNative.getStats());
+    }
+
+    /**
+     * Start decode latency statistics from zero
+     */
+    static resetStats() {
+        BarkoderNative.resetStats();
+    }
+
+    /**
+     * Start recording a timeline of decode stages (argument unpacking, buffer pinning,
+     * image conversion, SDK decoding, result building, queue handoffs)
+     * @param {number} capacity - Number of most recent events kept (default: 65536)
+     * @returns {BarkoderStatus} Status of the call
+     */
+    static startTracing(capacity = 65536) {
+        if (typeof capacity !== 'number') {
+            throw new Error('Capacity must be a number');
+        }
+        return toStatus(BarkoderNative.startTracing(capacity), Applied.tracing);
+    }
+
+    /**
+     * Stop recording and get the timeline
+     * @returns {string} Chrome trace-event JSON, loadable in chrome://tracing or ui.perfetto.dev
+     */
+    static stopTracing() {
+        return BarkoderNative.stopTracing();
+    }
+
+    /**
+     * Start recording sampled decode requests (pixels, dimensions, settings, results and timings)
+     * to a capture file that bench/replay.js can feed back
+     * @param {string} path - Capture file, replaced if it exists
+     * @param {Object} options - Capture options
+     * @param {number} options.sampleEvery - Capture one of every this many decodes (default: 1)
+     * @param {number} options.maxBytes - File size after which frames are dropped (default: 0 = unlimited)
+     * @returns {BarkoderStatus} Status of the call
+     */
+    static startCapture(path, options = {}) {
+        if (typeof path !== 'string') {
+            throw new Error('Capture path must be a string');
+        }
+        const { sampleEvery = 1, maxBytes = 0 } = options;
+        if (typeof sampleEvery !== 'number' || typeof maxBytes !== 'number') {
+            throw new Error('Sampling interval and maximum bytes must be numbers');
+        }
+        return toStatus(BarkoderNative.startCapture(path, sampleEvery, maxBytes), Applied.capture);
+    }
+
+    /**
+     * Stop capturing and finish the capture file
+     * @returns {Object} Frames written, frames dropped, file size in bytes, and the first write error if any
+     */
+    static stopCapture() {
+        return JSON.parse(BarkoderNative.stopCapture());
+    }
+
+    /**
+     * Render decode metrics in the OpenMetrics (Prometheus) text format
+     * @returns {string} Exposition text, ready to serve from a /metrics endpoint
+     */
+    static metricsText() {
+        return BarkoderNative.metricsText();
+    }
+
+    /**
+     * Get the startup milestones of this process: loading the addon, license check,
+     * option setup, warm-up and first completed decode. Each milestone is its first occurrence.
+     * @returns {Object} events: milliseconds since process start (null when not reached yet),
+     *                   durations: milliseconds spent in each phase (null when not complete)
+     */
+    static startupReport() {
+        const now = performance.now();
+        const ago = JSON.parse(BarkoderNative.startupTimeline());
+        const at = name => (ago[name] === null ? null : now - ago[name]);
+        const span = (from, to) => (from === null || to === null ? null : to - from);
+
+        const events = {
+            requireStart,
+            moduleLoaded: at('moduleLoaded'),
+            exportsStart: at('exportsStart'),
+            exportsDone: at('exportsDone'),
+            requireDone,
+            licenseStart: at('licenseStart'),
+            licenseDone: at('licenseDone'),
+            optionsDone: at('optionsDone'),
+            warmupStart: at('warmupStart'),
+            warmupDone: at('warmupDone'),
+            firstDecodeStart: at('firstDecodeStart'),
+            firstDecodeDone: at('firstDecodeDone')
+        };
+        return {
+            events,
+            durations: {
+                beforeRequire: requireStart,
+                loadLibrary: span(requireStart, events.moduleLoaded),
+                registerExports: span(events.exportsStart, events.exportsDone),
+                require: span(requireStart, requireDone),
+                license: span(events.licenseStart, events.licenseDone),
+                options: span(events.licenseDone, events.optionsDone),
+                warmup: span(events.warmupStart, events.warmupDone),
+                firstDecode: span(events.firstDecodeStart, events.firstDecodeDone),
+                untilFirstDecode: events.firstDecodeDone
+            }
+        };
+    }
+
+    /**
+     * Get the native memory held by the wrapper, outside the SDK. Everything except
+     * pinned frames is also reported to V8 as external memory, so GC pressure tracks it.
+     * @returns {Object} categories: current and peak bytes of pinnedFrames, conversionScratch,
+     *                   resultBuffers, capture, caches and tracing; ownedBytes: bytes allocated by
+     *                   the wrapper itself; reportedToV8: the part V8 has been told about
+     */
+    static memoryUsage() {
+        return JSON.parse(BarkoderNative.memoryUsage());
+    }
+
     /**
      * Helper method to enable only specific decoder types
      * @param {Array<string>} decoderNames - Array of decoder names (e.g., ['QR', 'PDF417'])
-     * @returns {string} Result message
+     * @returns {BarkoderStatus} Status of the call
      */
     static enableDecoders(decoderNames) {
         if (!Array.isArray(decoderNames)) {
@@ -0,0 +1,255 @@
+/**
+ * Barkoder SDK Result Ring
+ *
+ * Decode results written by the native side into a SharedArrayBuffer, for
+ * frame loops that should not create JavaScript objects per frame. Each
+ * decode fills one fixed-layout record (see src/ResultRing.hpp for the byte
+ * layout) and then bumps a published counter with release ordering; the
+ * reader polls that counter with Atomics.load and reads fields in place.
+ *
+ * The buffer can be handed to a worker thread, which reads it with its own
+ * ResultRing.fromBuffer() view while the main thread keeps decoding.
+ *
+ * @version 1.6.2
+ * @author barKoder
+ */
+
+const { BarcodeTypes } = require('./constants');
+
+const MAGIC = 0x52524B42;
+const HEADER_BYTES = 64;
+const RECORD_HEADER_BYTES = 64;
+const RESULT_BYTES = 48;
+
+// Header fields, as Int32Array indices
+const H_MAGIC = 0;
+const H_SLOTS = 2;
+const H_SLOT_BYTES = 3;
+const H_MAX_RESULTS = 4;
+const H_TEXT_BYTES = 5;
+const H_PUBLISHED = 6;
+
+// Record fields, as Int32Array indices from the start of the slot
+const R_STAMP = 0;
+const R_FRAME_ID = 1;
+const R_STATUS = 2;
+const R_FOUND = 3;
+const R_STORED = 4;
+const R_WIDTH = 5;
+const R_HEIGHT = 6;
+const R_SPEED = 7;
+const R_FLAGS = 8;
+const R_TIMES = 40;
+
+/**
+ * Stamp of a complete record: sequence + 1 modulo 2^32, skipping 0, which marks a record being written
+ * @param {number} sequence - Record sequence, modulo 2^32
+ * @returns {number}
+ */
+function stampOf(sequence) {
+    return ((sequence + 1) >>> 0) || 1;
+}
+
+/**
+ * Reader over a ring of decode records
+ */
+class ResultRing {
+    /**
+     * Record flag: more barcodes were found than the record stores
+     */
+    static RESULTS_DROPPED = 1;
+    /**
+     * Record flag: barcode text was cut, at a character boundary, to fit the record's text area
+     */
+    static TEXT_TRUNCATED = 2;
+    /**
+     * Record flag: the decode ran out of time and returned what it had found
+     */
+    static DEADLINE_EXCEEDED = 4;
+
+    /**
+     * Bytes a ring with these sizes needs
+     * @param {Object} layout - Ring sizes
+     * @returns {number} SharedArrayBuffer length
+     */
+    static byteLength({ slots = 64, maxResults = 16, textBytes = 4096 } = {}) {
+        return HEADER_BYTES + slots * ResultRing.slotBytes(maxResults, textBytes);
+    }
+
+    /**
+     * Bytes of one record, a multiple of 8 so the Float64 timings stay aligned
+     */
+    static slotBytes(maxResults, textBytes) {
+        return (RECORD_HEADER_BYTES + maxResults * RESULT_BYTES + textBytes + 7) & ~7;
+    }
+
+    /**
+     * Reader over a ring that is already attached, e.g. in a worker thread
+     * @param {SharedArrayBuffer} buffer - Buffer of a ResultRing attached with attachResultRing()
+     * @returns {ResultRing}
+     */
+    static fromBuffer(buffer) {
+        const header = new Int32Array(buffer, 0, HEADER_BYTES / 4);
+        if (Atomics.load(header, H_MAGIC) !== MAGIC) {
+            throw new Error('Buffer is not an attached result ring');
+        }
+        const layout = {
+            slots: header[H_SLOTS],
+            maxResults: header[H_MAX_RESULTS],
+            textBytes: header[H_TEXT_BYTES]
+        };
+        return new ResultRing(layout, buffer);
+    }
+
+    /**
+     * @param {Object} layout - Ring sizes
+     * @param {number} layout.slots - Records kept before the oldest is overwritten (default: 64)
+     * @param {number} layout.maxResults - Barcodes stored per record (default: 16)
+     * @param {number} layout.textBytes - UTF-8 text bytes stored per record (default: 4096)
+     * @param {SharedArrayBuffer} buffer - Existing buffer to read (default: a new one)
+     */
+    constructor({ slots = 64, maxResults = 16, textBytes = 4096 } = {}, buffer = undefined) {
+        if (!Number.isInteger(slots) || !Number.isInteger(maxResults) || !Number.isInteger(textBytes) ||
+            slots < 2 || maxResults < 1 || textBytes < 0) {
+            throw new Error('Ring needs at least 2 slots, 1 result per record and no negative text bytes');
+        }
+        this.slots = slots;
+        this.maxResults = maxResults;
+        this.textBytes = textBytes;
+        this.recordBytes = ResultRing.slotBytes(maxResults, textBytes);
+        this.buffer = buffer || new SharedArrayBuffer(ResultRing.byteLength({ slots, maxResults, textBytes }));
+
+        this.int32 = new Int32Array(this.buffer);
+        this.float32 = new Float32Array(this.buffer);
+        this.float64 = new Float64Array(this.buffer);
+        this.bytes = Buffer.from(this.buffer);
+
+        this.reset();
+    }
+
+    /**
+     * Forget the read position. Attaching clears the ring, so attachResultRing() calls this.
+     */
+    reset() {
+        this.sequence = -1;   // Sequence of the current record
+        this.cursor = 0;      // Sequence of the next record to read
+        this.cursorSlot = 0;  // Slot of the next record, advanced with the cursor since the sequence wraps at 2^32
+        this.dropped = 0;     // Records overwritten before they were read
+        this.base = 0;        // Byte offset of the current record
+    }
+
+    /**
+     * Records written since the ring was attached, modulo 2^32
+     */
+    get published() {
+        return Atomics.load(this.int32, H_PUBLISHED) >>> 0;
+    }
+
+    /**
+     * Move to the oldest unread record
+     * @returns {boolean} False when every published record has been read
+     */
+    next() {
+        for (;;) {
+            const published = this.published;
+            const behind = (published - this.cursor) >>> 0;
+            if (behind === 0) {
+                return false;
+            }
+            // The slot after the newest record may be half-written, so at most slots - 1 are readable
+            if (behind > this.slots - 1) {
+                const skipped = behind - (this.slots - 1);
+                this.dropped += skipped;
+                this.cursor = (this.cursor + skipped) >>> 0;
+                this.cursorSlot = (this.cursorSlot + skipped) % this.slots;
+            }
+            this.base = HEADER_BYTES + this.cursorSlot * this.recordBytes;
+            this.sequence = this.cursor;
+            this.cursor = (this.cursor + 1) >>> 0;
+            this.cursorSlot = this.cursorSlot + 1 === this.slots ? 0 : this.cursorSlot + 1;
+            if (this.valid()) {
+                return true;
+            }
+            this.dropped++;
+        }
+    }
+
+    /**
+     * Whether the current record is still intact. Check after reading its fields:
+     * false means the writer lapped the reader and the values read may be mixed.
+     * @returns {boolean}
+     */
+    valid() {
+        return this.sequence >= 0 && (Atomics.load(this.int32, this.base / 4 + R_STAMP) >>> 0) === stampOf(this.sequence);
+    }
+
+    /** Caller's frame id passed to decodeToRing() */
+    get frameId() { return this.int32[this.base / 4 + R_FRAME_ID]; }
+    /** Status code of the decode (see constants.Status) */
+    get status() { return this.int32[this.base / 4 + R_STATUS]; }
+    /** Barcodes found, possibly more than stored */
+    get resultsCount() { return this.int32[this.base / 4 + R_FOUND]; }
+    /** Barcodes stored in the record */
+    get storedCount() { return this.int32[this.base / 4 + R_STORED]; }
+    get width() { return this.int32[this.base / 4 + R_WIDTH]; }
+    get height() { return this.int32[this.base / 4 + R_HEIGHT]; }
+    /** Decoding speed that produced the results */
+    get decodingSpeed() { return this.int32[this.base / 4 + R_SPEED]; }
+    /** ResultRing.RESULTS_DROPPED, TEXT_TRUNCATED and DEADLINE_EXCEEDED bits */
+    get flags() { return this.int32[this.base / 4 + R_FLAGS]; }
+    /** Time the request arrived, in ms since the ring was attached */
+    get receivedMs() { return this.float64[(this.base + R_TIMES) / 8]; }
+    get decodeMs() { return this.float64[(this.base + R_TIMES) / 8 + 1]; }
+    /** Time from arrival to publication */
+    get totalMs() { return this.float64[(this.base + R_TIMES) / 8 + 2]; }
+
+    /**
+     * Barcode type of a stored result, the SDK's numbering (see constants.BarcodeTypes)
+     * @param {number} index - Result index, below storedCount
+     */
+    barcodeType(index) {
+        return this.int32[this.resultBase(index) / 4];
+    }
+
+    /**
+     * Barcode type name of a stored result
+     * @param {number} index - Result index, below storedCount
+     */
+    barcodeTypeName(index) {
+        return BarcodeTypes[this.barcodeType(index)] || '';
+    }
+
+    /**
+     * Text of a stored result, decoded from the record's text area
+     * @param {number} index - Result index, below storedCount
+     */
+    text(index) {
+        const field = this.resultBase(index) / 4;
+        const start = this.base + RECORD_HEADER_BYTES + this.maxResults * RESULT_BYTES + this.int32[field + 1];
+        return this.bytes.toString('utf8', start, start + this.int32[field + 2]);
+    }
+
+    /**
+     * Corner x coordinate of a stored result
+     * @param {number} index - Result index, below storedCount
+     * @param {number} corner - Corner 0 to 3
+     */
+    cornerX(index, corner) {
+        return this.float32[this.resultBase(index) / 4 + 4 + corner * 2];
+    }
+
+    /**
+     * Corner y coordinate of a stored result
+     * @param {number} index - Result index, below storedCount
+     * @param {number} corner - Corner 0 to 3
+     */
+    cornerY(index, corner) {
+        return this.float32[this.resultBase(index) / 4 + 5 + corner * 2];
+    }
+
+    resultBase(index) {
+        return this.base + RECORD_HEADER_BYTES + index * RESULT_BYTES;
+    }
+}
+
+module.exports = ResultRing;
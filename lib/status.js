@@ -0,0 +1,80 @@
+/**
+ * Barkoder SDK Status
+ *
+ * Result of the setting methods. The native side returns a numeric code and
+ * only builds a message when a call fails, so successful calls cost no
+ * string formatting and can be checked without parsing.
+ *
+ * @version 1.6.2
+ * @author barKoder
+ */
+
+const { Status } = require('./constants');
+
+/**
+ * Error thrown by Status.throwIfError(), carrying the status code
+ */
+class BarkoderError extends Error {
+    /**
+     * @param {number} code - Status code (see constants.Status)
+     * @param {string} message - What failed
+     */
+    constructor(code, message) {
+        super(message);
+        this.name = 'BarkoderError';
+        this.code = code;
+    }
+}
+
+/**
+ * Outcome of a setting call
+ */
+class BarkoderStatus {
+    /**
+     * @param {number} code - Status code (see constants.Status)
+     * @param {string} message - What was done, or what failed
+     */
+    constructor(code, message) {
+        this.code = code;
+        this.message = message;
+        Object.freeze(this);
+    }
+
+    /**
+     * True when the setting was applied
+     * @returns {boolean}
+     */
+    get ok() {
+        return this.code === Status.Ok;
+    }
+
+    /**
+     * Throw a BarkoderError if the call failed
+     * @returns {BarkoderStatus} This status, for chaining
+     */
+    throwIfError() {
+        if (this.code !== Status.Ok) {
+            throw new BarkoderError(this.code, this.message);
+        }
+        return this;
+    }
+
+    /**
+     * The message in the "SUCCESS: ..." / "ERROR: ..." form earlier versions returned
+     * @returns {string}
+     */
+    toString() {
+        return (this.code === Status.Ok ? 'SUCCESS: ' : 'ERROR: ') + this.message;
+    }
+
+    /**
+     * Kept so code written against the string results, e.g. status.startsWith('SUCCESS:'), still works
+     * @param {string} prefix
+     * @returns {boolean}
+     */
+    startsWith(prefix) {
+        return this.toString().startsWith(prefix);
+    }
+}
+
+module.exports = { BarkoderStatus, BarkoderError };
@@ -0,0 +1,181 @@
+#include "DecodePool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+
+namespace BKNode {
+
+std::atomic<uint64_t> DecodePool::totalBusyNs{0};
+
+static const char *const kLaneNames[] = { "interactive", "bulk" };
+
+// Lane of the task the current worker runs, so ParallelFor helpers inherit it
+static thread_local DecodeLane currentLane = DecodeLane::Interactive;
+
+DecodePool::DecodePool(int threadCount, int interactiveWeight) : interactiveWeight(std::max(1, interactiveWeight)) {
+    threadCount = std::max(1, threadCount);
+    for (int i = 0; i < threadCount; i++) {
+        threads.emplace_back(&DecodePool::WorkerLoop, this);
+    }
+}
+
+DecodePool::~DecodePool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+void DecodePool::Submit(Task task, DecodeLane lane) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queues[static_cast<int>(lane)].push_back(std::move(task));
+    }
+    available.notify_one();
+}
+
+void DecodePool::SetInteractiveWeight(int weight) {
+    std::lock_guard<std::mutex> lock(mutex);
+    interactiveWeight = std::max(1, weight);
+}
+
+size_t DecodePool::QueueDepth() {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t depth = 0;
+    for (const std::deque<Task> &queue : queues) {
+        depth += queue.size();
+    }
+    return depth;
+}
+
+size_t DecodePool::QueueDepth(DecodeLane lane) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queues[static_cast<int>(lane)].size();
+}
+
+const char *DecodePool::LaneName(DecodeLane lane) {
+    return kLaneNames[static_cast<int>(lane)];
+}
+
+/**
+ * Whether any lane has a task, called with the mutex held
+ */
+bool DecodePool::HasQueuedTasks() const {
+    for (const std::deque<Task> &queue : queues) {
+        if (!queue.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Pops the next task, called with the mutex held. Returns false when both lanes are empty.
+ */
+bool DecodePool::TakeTask(Task &task, DecodeLane &lane) {
+    std::deque<Task> &interactive = queues[static_cast<int>(DecodeLane::Interactive)];
+    std::deque<Task> &bulk = queues[static_cast<int>(DecodeLane::Bulk)];
+    if (interactive.empty() && bulk.empty()) {
+        return false;
+    }
+
+    // The streak only counts interactive tasks taken while bulk work was waiting
+    if (!interactive.empty() && (bulk.empty() || interactiveStreak < interactiveWeight)) {
+        lane = DecodeLane::Interactive;
+        interactiveStreak = bulk.empty() ? 0 : interactiveStreak + 1;
+    } else {
+        lane = DecodeLane::Bulk;
+        interactiveStreak = 0;
+    }
+    std::deque<Task> &queue = queues[static_cast<int>(lane)];
+    task = std::move(queue.front());
+    queue.pop_front();
+    return true;
+}
+
+void DecodePool::WorkerLoop() {
+    for (;;) {
+        Task task;
+        DecodeLane lane;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            available.wait(lock, [this] { return stopping || HasQueuedTasks(); });
+            if (!TakeTask(task, lane)) {
+                return;
+            }
+        }
+
+        currentLane = lane;
+        busyThreads++;
+        auto start = std::chrono::steady_clock::now();
+        task();
+        totalBusyNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        busyThreads--;
+    }
+}
+
+/**
+ * Shared between the caller of ParallelFor and the helper tasks it submits.
+ * Helpers may start after the caller returned, so they only touch body
+ * while holding an index that is not finished yet.
+ */
+struct ParallelForState {
+    const std::function<void(int)> *body = nullptr;
+    int count = 0;
+    std::atomic<int> next{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+    int done = 0;
+    std::exception_ptr error;
+
+    void Work() {
+        for (int index = next++; index < count; index = next++) {
+            std::exception_ptr caught;
+            try {
+                (*body)(index);
+            } catch (...) {
+                caught = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (caught && !error) {
+                error = caught;
+            }
+            if (++done == count) {
+                finished.notify_all();
+            }
+        }
+    }
+};
+
+void DecodePool::ParallelFor(int count, const std::function<void(int)> &body) {
+    if (count <= 0) {
+        return;
+    }
+
+    auto state = std::make_shared<ParallelForState>();
+    state->body = &body;
+    state->count = count;
+
+    int helpers = std::min(count - 1, ThreadCount());
+    for (int i = 0; i < helpers; i++) {
+        Submit([state] { state->Work(); }, currentLane);
+    }
+
+    state->Work();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&] { return state->done == count; });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+}
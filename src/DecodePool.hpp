@@ -0,0 +1,127 @@
+#ifndef DecodePool_hpp
+#define DecodePool_hpp
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace BKNode {
+
+/**
+ * @brief Queue a decode task waits in.
+ */
+enum class DecodeLane {
+    Interactive = 0,  /**< Someone is waiting for the result. */
+    Bulk,             /**< Background work that only needs to finish eventually. */
+    Count
+};
+
+/**
+ * @brief Fixed set of native worker threads that run decode tasks.
+ *
+ * Each lane is a FIFO queue. Free workers take interactive tasks first, but
+ * while bulk tasks wait, every interactiveWeight interactive tasks are
+ * followed by one bulk task, so a steady interactive load cannot starve
+ * bulk work.
+ */
+class DecodePool {
+public:
+    typedef std::function<void()> Task;
+
+    /**
+     * @brief Starts the worker threads.
+     * @param threadCount Number of workers, at least 1.
+     */
+    explicit DecodePool(int threadCount, int interactiveWeight = kDefaultInteractiveWeight);
+
+    static const int kDefaultInteractiveWeight = 8;
+
+    /**
+     * @brief Lets queued tasks finish and joins the workers.
+     */
+    ~DecodePool();
+
+    DecodePool(const DecodePool &) = delete;
+    DecodePool &operator=(const DecodePool &) = delete;
+
+    /**
+     * @brief Queues a task for the next free worker.
+     * @param task The task to run.
+     * @param lane Queue the task waits in.
+     */
+    void Submit(Task task, DecodeLane lane = DecodeLane::Interactive);
+
+    /**
+     * @brief Sets how many interactive tasks run before a waiting bulk task gets a turn.
+     * @param weight Interactive tasks per bulk task, at least 1.
+     */
+    void SetInteractiveWeight(int weight);
+
+    /**
+     * @brief Runs body(0) ... body(count - 1) on the workers and the calling thread.
+     *
+     * The calling thread works through the indexes too, so this never waits on a
+     * busy pool and may be called from a pool task. Helpers queue in the lane of
+     * the pool task calling this, or the interactive lane from other threads. Rethrows the first exception
+     * thrown by body once every started index has finished.
+     * @param count Number of indexes.
+     * @param body Function called once per index.
+     */
+    void ParallelFor(int count, const std::function<void(int)> &body);
+
+    /**
+     * @brief Gets the number of worker threads.
+     */
+    int ThreadCount() const { return static_cast<int>(threads.size()); }
+
+    /**
+     * @brief Gets the number of tasks waiting for a worker.
+     */
+    size_t QueueDepth();
+
+    /**
+     * @brief Gets the number of tasks waiting for a worker in one lane.
+     */
+    size_t QueueDepth(DecodeLane lane);
+
+    /**
+     * @brief Name of a lane as it appears in JSON and metrics labels.
+     */
+    static const char *LaneName(DecodeLane lane);
+
+    /**
+     * @brief Gets the number of workers running a task.
+     */
+    int BusyThreads() const { return busyThreads.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Gets the time workers of every pool, current or destroyed, have spent running tasks, in nanoseconds.
+     */
+    static uint64_t TotalBusyNs() { return totalBusyNs.load(std::memory_order_relaxed); }
+
+private:
+    void WorkerLoop();
+    bool HasQueuedTasks() const;
+    bool TakeTask(Task &task, DecodeLane &lane);
+
+    static const int kLaneCount = static_cast<int>(DecodeLane::Count);
+
+    std::mutex mutex;
+    std::condition_variable available;
+    std::deque<Task> queues[kLaneCount];
+    int interactiveWeight;
+    int interactiveStreak = 0;
+    std::vector<std::thread> threads;
+    bool stopping = false;
+    std::atomic<int> busyThreads{0};
+    static std::atomic<uint64_t> totalBusyNs;
+};
+
+}
+
+#endif /* DecodePool_hpp */
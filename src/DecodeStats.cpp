@@ -0,0 +1,594 @@
+#include "DecodeStats.hpp"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdio.h>
+#include "BarkoderClasses.hpp"
+#include "MetricsText.hpp"
+#include "json/cJSON.h"
+
+using namespace NSBarkoder;
+
+namespace BKNode {
+
+static const int kStageCount = static_cast<int>(DecodeStage::Count);
+static const int kSpeedCount = 4;
+static const int kSizeCount = static_cast<int>(SizeBucket::Count);
+
+static const char *const kStageNames[kStageCount] = { "queueWait", "conversion", "decode", "marshal", "total" };
+static const char *const kSizeNames[kSizeCount] = { "upTo1MP", "upTo4MP", "upTo16MP", "over16MP" };
+static const char *const kSpeedNames[kSpeedCount] = { "fast", "normal", "slow", "rigorous" };
+
+static const int kBarcodeTypeCount = static_cast<int>(BarcodeType::MaxiCode) + 1;
+static const int kDecoderTypeCount = static_cast<int>(DecoderType::MaxiCode) + 1;
+static const int kSetCount = DecodeStats::kMaxDecoderSets;
+
+static const char *const kBarcodeTypeNames[kBarcodeTypeCount] = {
+    "Aztec", "AztecCompact", "QR", "QRMicro", "Code128", "Code93", "Code39", "Codabar", "Code11", "Msi",
+    "UpcA", "UpcE", "UpcE1", "Ean13", "Ean8", "PDF417", "PDF417Micro", "Datamatrix", "Code25", "Interleaved25",
+    "ITF14", "IATA25", "Matrix25", "Datalogic25", "COOP25", "Code32", "Telepen", "Dotcode", "IDDocument", "IDMRZ",
+    "IDPicture", "IDSignature", "Databar14", "DatabarLimited", "DatabarExpanded", "PostalIMB", "Postnet", "Planet",
+    "AustralianPost", "RoyalMail", "KIX", "JapanesePost", "MaxiCode"
+};
+
+static const char *const kDecoderTypeNames[kDecoderTypeCount] = {
+    "Aztec", "AztecCompact", "QR", "QRMicro", "Code128", "Code93", "Code39", "Codabar", "Code11", "Msi",
+    "UpcA", "UpcE", "UpcE1", "Ean13", "Ean8", "PDF417", "PDF417Micro", "Datamatrix", "Code25", "Interleaved25",
+    "ITF14", "IATA25", "Matrix25", "Datalogic25", "COOP25", "Code32", "Telepen", "Dotcode", "IDDocument",
+    "Databar14", "DatabarLimited", "DatabarExpanded", "PostalIMB", "Postnet", "Planet", "AustralianPost",
+    "RoyalMail", "KIX", "JapanesePost", "MaxiCode"
+};
+
+int HistogramSnapshot::BucketIndex(uint64_t ns) {
+    const uint64_t maxValue = (uint64_t(1) << kMaxValueBits) - 1;
+    if (ns > maxValue) {
+        ns = maxValue;
+    }
+    if (ns < (uint64_t(2) << kSubBucketBits)) {
+        return static_cast<int>(ns);
+    }
+
+    int topBit = 63 - __builtin_clzll(ns);
+    int shift = topBit - kSubBucketBits;
+    int mantissa = static_cast<int>(ns >> shift);
+    return ((shift + 1) << kSubBucketBits) + mantissa - (1 << kSubBucketBits);
+}
+
+uint64_t HistogramSnapshot::BucketLowerBound(int index) {
+    if (index < (2 << kSubBucketBits)) {
+        return static_cast<uint64_t>(index);
+    }
+
+    int shift = (index >> kSubBucketBits) - 1;
+    uint64_t mantissa = static_cast<uint64_t>((index & ((1 << kSubBucketBits) - 1)) + (1 << kSubBucketBits));
+    return mantissa << shift;
+}
+
+uint64_t HistogramSnapshot::ValueAtQuantile(double quantile) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(quantile * count);
+    if (rank >= count) {
+        rank = count - 1;
+    }
+
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; i++) {
+        seen += buckets[i];
+        if (seen > rank) {
+            uint64_t lower = BucketLowerBound(i);
+            uint64_t upper = i + 1 < kBucketCount ? BucketLowerBound(i + 1) : lower;
+            return lower + (upper - lower) / 2;
+        }
+    }
+    return BucketLowerBound(kBucketCount - 1);
+}
+
+void HistogramSnapshot::Add(const HistogramSnapshot &other) {
+    for (int i = 0; i < kBucketCount; i++) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    sumNs += other.sumNs;
+}
+
+void HistogramSnapshot::Subtract(const HistogramSnapshot &other) {
+    for (int i = 0; i < kBucketCount; i++) {
+        buckets[i] -= other.buckets[i];
+    }
+    count -= other.count;
+    sumNs -= other.sumNs;
+}
+
+void HistogramSnapshot::Clear() {
+    std::fill(buckets.begin(), buckets.end(), 0);
+    count = 0;
+    sumNs = 0;
+}
+
+/**
+ * Histogram written by a single thread and read by any.
+ * Value-initialized with new AtomicHistogram() so every counter starts at zero.
+ */
+struct AtomicHistogram {
+    std::atomic<uint64_t> buckets[HistogramSnapshot::kBucketCount];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sumNs;
+
+    static void Increment(std::atomic<uint64_t> &counter, uint64_t value) {
+        // Only the owning thread writes, so a plain load and store cannot lose updates
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    void Record(uint64_t ns) {
+        Increment(buckets[HistogramSnapshot::BucketIndex(ns)], 1);
+        Increment(count, 1);
+        Increment(sumNs, ns);
+    }
+
+    void AddTo(HistogramSnapshot &snapshot) const {
+        for (int i = 0; i < HistogramSnapshot::kBucketCount; i++) {
+            snapshot.buckets[i] += buckets[i].load(std::memory_order_relaxed);
+        }
+        snapshot.count += count.load(std::memory_order_relaxed);
+        snapshot.sumNs += sumNs.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * One thread's counts for one enabled-decoder set.
+ * Value-initialized like AtomicHistogram.
+ */
+struct OutcomeCounters {
+    AtomicHistogram hits;
+    AtomicHistogram misses;
+    std::atomic<uint64_t> results[kBarcodeTypeCount];
+};
+
+/**
+ * Totals of OutcomeCounters over all threads
+ */
+struct OutcomeSnapshot {
+    HistogramSnapshot hits;
+    HistogramSnapshot misses;
+    uint64_t results[kBarcodeTypeCount] = {};
+
+    void Subtract(const OutcomeSnapshot &other) {
+        hits.Subtract(other.hits);
+        misses.Subtract(other.misses);
+        for (int type = 0; type < kBarcodeTypeCount; type++) {
+            results[type] -= other.results[type];
+        }
+    }
+};
+
+/**
+ * One thread's histograms, created on first use of each stage, speed and size,
+ * and its outcome counters, created on first use of each decoder set
+ */
+struct StatsShard {
+    std::atomic<AtomicHistogram *> histograms[kStageCount][kSpeedCount][kSizeCount];
+    std::atomic<OutcomeCounters *> outcomes[kSetCount];
+
+    StatsShard() {
+        for (auto &stage : histograms) {
+            for (auto &speed : stage) {
+                for (auto &size : speed) {
+                    size.store(nullptr, std::memory_order_relaxed);
+                }
+            }
+        }
+        for (auto &outcome : outcomes) {
+            outcome.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+};
+
+/**
+ * All shards ever created and the snapshot taken at the last reset.
+ * Shards are never freed, threads that exit keep their counts.
+ */
+struct StatsRegistry {
+    std::mutex mutex;
+    std::vector<StatsShard *> shards;
+    HistogramSnapshot baseline[kStageCount][kSpeedCount][kSizeCount];
+    std::vector<std::vector<DecoderType>> decoderSets; // The last slot, once used, holds every further set
+    OutcomeSnapshot outcomeBaseline[kSetCount];
+
+    static StatsRegistry &Instance() {
+        static StatsRegistry *registry = new StatsRegistry();
+        return *registry;
+    }
+};
+
+static StatsShard &LocalShard() {
+    thread_local StatsShard *shard = nullptr;
+    if (!shard) {
+        shard = new StatsShard();
+        StatsRegistry &registry = StatsRegistry::Instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.shards.push_back(shard);
+    }
+    return *shard;
+}
+
+SizeBucket DecodeStats::SizeBucketFor(int width, int height) {
+    int64_t pixels = static_cast<int64_t>(width) * height;
+    if (pixels <= 1000000) {
+        return SizeBucket::UpTo1MP;
+    }
+    if (pixels <= 4000000) {
+        return SizeBucket::UpTo4MP;
+    }
+    if (pixels <= 16000000) {
+        return SizeBucket::UpTo16MP;
+    }
+    return SizeBucket::Over16MP;
+}
+
+void DecodeStats::Record(DecodeStage stage, DecodingSpeed speed, SizeBucket size, uint64_t ns) {
+    int speedIndex = static_cast<int>(speed);
+    if (speedIndex < 0 || speedIndex >= kSpeedCount) {
+        return;
+    }
+    std::atomic<AtomicHistogram *> &slot =
+        LocalShard().histograms[static_cast<int>(stage)][speedIndex][static_cast<int>(size)];
+
+    AtomicHistogram *histogram = slot.load(std::memory_order_relaxed);
+    if (!histogram) {
+        histogram = new AtomicHistogram();
+        slot.store(histogram, std::memory_order_release);
+    }
+    histogram->Record(ns);
+}
+
+void DecodeStats::Record(DecodeStage stage, DecodingSpeed speed, SizeBucket size, Clock::time_point from, Clock::time_point to) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+    Record(stage, speed, size, ns > 0 ? static_cast<uint64_t>(ns) : 0);
+}
+
+int DecodeStats::DecoderSetIndex(const std::vector<DecoderType> &decoders) {
+    std::vector<DecoderType> sorted(decoders);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    StatsRegistry &registry = StatsRegistry::Instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    for (size_t i = 0; i < registry.decoderSets.size(); i++) {
+        if (registry.decoderSets[i] == sorted) {
+            return static_cast<int>(i);
+        }
+    }
+    if (registry.decoderSets.size() < kSetCount - 1) {
+        registry.decoderSets.push_back(sorted);
+        return static_cast<int>(registry.decoderSets.size() - 1);
+    }
+    return kSetCount - 1;
+}
+
+void DecodeStats::RecordOutcome(int decoderSet, const std::vector<BaseResult> &results, uint64_t decodeNs) {
+    std::atomic<OutcomeCounters *> &slot = LocalShard().outcomes[decoderSet];
+
+    OutcomeCounters *counters = slot.load(std::memory_order_relaxed);
+    if (!counters) {
+        counters = new OutcomeCounters();
+        slot.store(counters, std::memory_order_release);
+    }
+
+    bool hit = false;
+    for (const BaseResult &result : results) {
+        int type = static_cast<int>(result.barcodeType);
+        if ((result.textualData.empty() && result.binaryData.empty()) || type < 0 || type >= kBarcodeTypeCount) {
+            continue;
+        }
+        AtomicHistogram::Increment(counters->results[type], 1);
+        hit = true;
+    }
+    (hit ? counters->hits : counters->misses).Record(decodeNs);
+}
+
+/**
+ * Sum one decoder set's outcome counters over all shards, without subtracting the baseline.
+ * Caller holds the registry mutex.
+ */
+static OutcomeSnapshot SumOutcomes(StatsRegistry &registry, int decoderSet) {
+    OutcomeSnapshot snapshot;
+    for (StatsShard *shard : registry.shards) {
+        OutcomeCounters *counters = shard->outcomes[decoderSet].load(std::memory_order_acquire);
+        if (counters) {
+            counters->hits.AddTo(snapshot.hits);
+            counters->misses.AddTo(snapshot.misses);
+            for (int type = 0; type < kBarcodeTypeCount; type++) {
+                snapshot.results[type] += counters->results[type].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    return snapshot;
+}
+
+/**
+ * Add one histogram of every shard to a snapshot, without subtracting the baseline.
+ * Caller holds the registry mutex.
+ */
+static void AccumulateShards(StatsRegistry &registry, int stage, int speed, int size, HistogramSnapshot &snapshot) {
+    for (StatsShard *shard : registry.shards) {
+        AtomicHistogram *histogram = shard->histograms[stage][speed][size].load(std::memory_order_acquire);
+        if (histogram) {
+            histogram->AddTo(snapshot);
+        }
+    }
+}
+
+/**
+ * Sum one histogram over all shards, without subtracting the baseline.
+ * Caller holds the registry mutex.
+ */
+static HistogramSnapshot SumShards(StatsRegistry &registry, int stage, int speed, int size) {
+    HistogramSnapshot snapshot;
+    AccumulateShards(registry, stage, speed, size, snapshot);
+    return snapshot;
+}
+
+HistogramSnapshot DecodeStats::Snapshot(DecodeStage stage, DecodingSpeed speed, SizeBucket size) {
+    StatsRegistry &registry = StatsRegistry::Instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    int stageIndex = static_cast<int>(stage);
+    int speedIndex = static_cast<int>(speed);
+    int sizeIndex = static_cast<int>(size);
+    if (speedIndex < 0 || speedIndex >= kSpeedCount) {
+        return HistogramSnapshot();
+    }
+
+    HistogramSnapshot snapshot = SumShards(registry, stageIndex, speedIndex, sizeIndex);
+    snapshot.Subtract(registry.baseline[stageIndex][speedIndex][sizeIndex]);
+    return snapshot;
+}
+
+void DecodeStats::Reset() {
+    StatsRegistry &registry = StatsRegistry::Instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    for (int stage = 0; stage < kStageCount; stage++) {
+        for (int speed = 0; speed < kSpeedCount; speed++) {
+            for (int size = 0; size < kSizeCount; size++) {
+                registry.baseline[stage][speed][size] = SumShards(registry, stage, speed, size);
+            }
+        }
+    }
+    for (int set = 0; set < kSetCount; set++) {
+        registry.outcomeBaseline[set] = SumOutcomes(registry, set);
+    }
+}
+
+/**
+ * Summary of one histogram in milliseconds
+ */
+static cJSON *HistogramToJson(const HistogramSnapshot &histogram) {
+    const double nsPerMs = 1e6;
+    cJSON *object = cJSON_CreateObject();
+    cJSON_AddNumberToObject(object, "count", static_cast<double>(histogram.Count()));
+    cJSON_AddNumberToObject(object, "meanMs", histogram.Count() ? histogram.SumNs() / nsPerMs / histogram.Count() : 0);
+    cJSON_AddNumberToObject(object, "p50Ms", histogram.ValueAtQuantile(0.5) / nsPerMs);
+    cJSON_AddNumberToObject(object, "p90Ms", histogram.ValueAtQuantile(0.9) / nsPerMs);
+    cJSON_AddNumberToObject(object, "p99Ms", histogram.ValueAtQuantile(0.99) / nsPerMs);
+    cJSON_AddNumberToObject(object, "p999Ms", histogram.ValueAtQuantile(0.999) / nsPerMs);
+    cJSON_AddNumberToObject(object, "maxMs", histogram.ValueAtQuantile(1.0) / nsPerMs);
+    return object;
+}
+
+/**
+ * Nonzero result counts keyed by barcode type name
+ */
+static cJSON *ResultCountsToJson(const uint64_t (&results)[kBarcodeTypeCount]) {
+    cJSON *object = cJSON_CreateObject();
+    for (int type = 0; type < kBarcodeTypeCount; type++) {
+        if (results[type] > 0) {
+            cJSON_AddNumberToObject(object, kBarcodeTypeNames[type], static_cast<double>(results[type]));
+        }
+    }
+    return object;
+}
+
+cJSON *DecodeStats::ToJson() {
+    HistogramSnapshot all[kStageCount];
+    HistogramSnapshot split[kStageCount][kSpeedCount][kSizeCount];
+    OutcomeSnapshot outcomes[kSetCount];
+    std::vector<std::vector<DecoderType>> decoderSets;
+    {
+        StatsRegistry &registry = StatsRegistry::Instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        for (int stage = 0; stage < kStageCount; stage++) {
+            for (int speed = 0; speed < kSpeedCount; speed++) {
+                for (int size = 0; size < kSizeCount; size++) {
+                    split[stage][speed][size] = SumShards(registry, stage, speed, size);
+                    split[stage][speed][size].Subtract(registry.baseline[stage][speed][size]);
+                    all[stage].Add(split[stage][speed][size]);
+                }
+            }
+        }
+        for (int set = 0; set < kSetCount; set++) {
+            outcomes[set] = SumOutcomes(registry, set);
+            outcomes[set].Subtract(registry.outcomeBaseline[set]);
+        }
+        decoderSets = registry.decoderSets;
+    }
+
+    cJSON *root = cJSON_CreateObject();
+
+    cJSON *stages = cJSON_CreateObject();
+    for (int stage = 0; stage < kStageCount; stage++) {
+        cJSON_AddItemToObject(stages, kStageNames[stage], HistogramToJson(all[stage]));
+    }
+    cJSON_AddItemToObject(root, "stages", stages);
+
+    cJSON *breakdown = cJSON_CreateArray();
+    for (int speed = 0; speed < kSpeedCount; speed++) {
+        for (int size = 0; size < kSizeCount; size++) {
+            bool used = false;
+            for (int stage = 0; stage < kStageCount; stage++) {
+                used = used || split[stage][speed][size].Count() > 0;
+            }
+            if (!used) {
+                continue;
+            }
+
+            cJSON *entry = cJSON_CreateObject();
+            cJSON_AddNumberToObject(entry, "decodingSpeed", speed);
+            cJSON_AddStringToObject(entry, "imageSize", kSizeNames[size]);
+            cJSON *entryStages = cJSON_CreateObject();
+            for (int stage = 0; stage < kStageCount; stage++) {
+                cJSON_AddItemToObject(entryStages, kStageNames[stage], HistogramToJson(split[stage][speed][size]));
+            }
+            cJSON_AddItemToObject(entry, "stages", entryStages);
+            cJSON_AddItemToArray(breakdown, entry);
+        }
+    }
+    cJSON_AddItemToObject(root, "breakdown", breakdown);
+
+    uint64_t totals[kBarcodeTypeCount] = {};
+    uint64_t emptyDecodes = 0;
+    cJSON *sets = cJSON_CreateArray();
+    for (int set = 0; set < kSetCount; set++) {
+        const OutcomeSnapshot &outcome = outcomes[set];
+        if (outcome.hits.Count() == 0 && outcome.misses.Count() == 0) {
+            continue;
+        }
+        for (int type = 0; type < kBarcodeTypeCount; type++) {
+            totals[type] += outcome.results[type];
+        }
+        emptyDecodes += outcome.misses.Count();
+
+        cJSON *entry = cJSON_CreateObject();
+        if (set < static_cast<int>(decoderSets.size())) {
+            cJSON *decoders = cJSON_CreateArray();
+            for (DecoderType decoder : decoderSets[set]) {
+                int index = static_cast<int>(decoder);
+                bool known = index >= 0 && index < kDecoderTypeCount;
+                cJSON_AddItemToArray(decoders, known ? cJSON_CreateString(kDecoderTypeNames[index]) : cJSON_CreateNumber(index));
+            }
+            cJSON_AddItemToObject(entry, "decoders", decoders);
+        } else {
+            cJSON_AddStringToObject(entry, "decoders", "other");
+        }
+        cJSON_AddItemToObject(entry, "hits", HistogramToJson(outcome.hits));
+        cJSON_AddItemToObject(entry, "misses", HistogramToJson(outcome.misses));
+        cJSON_AddItemToObject(entry, "results", ResultCountsToJson(outcome.results));
+        cJSON_AddItemToArray(sets, entry);
+    }
+
+    cJSON *results = cJSON_CreateObject();
+    cJSON_AddItemToObject(results, "byType", ResultCountsToJson(totals));
+    cJSON_AddNumberToObject(results, "emptyDecodes", static_cast<double>(emptyDecodes));
+    cJSON_AddItemToObject(results, "decoderSets", sets);
+    cJSON_AddItemToObject(root, "results", results);
+
+    return root;
+}
+
+// Upper bounds of the exported latency buckets, in seconds
+static const double kMetricBounds[] = { 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10 };
+static const int kMetricBoundCount = sizeof(kMetricBounds) / sizeof(kMetricBounds[0]);
+
+// Longest label set of a metrics sample, and room for the le label a bucket adds to it
+static const size_t kLabelBytes = 512;
+static const size_t kBucketLabelBytes = kLabelBytes + 32;
+
+/**
+ * Write the cumulative OpenMetrics buckets of a histogram. Internal buckets
+ * are counted under the first bound at or above their upper end, so one that
+ * straddles a bound only shows up under a later one: counts may lag behind the
+ * true value at a bound, but never exceed it.
+ */
+static void WriteHistogram(MetricsText &metrics, const char *name, const char *labels, const HistogramSnapshot &histogram) {
+    char sampleName[96];
+    char bucketLabels[kBucketLabelBytes];
+    const std::vector<uint64_t> &buckets = histogram.Buckets();
+
+    snprintf(sampleName, sizeof(sampleName), "%s_bucket", name);
+    uint64_t cumulative = 0;
+    int index = 0;
+    for (int bound = 0; bound < kMetricBoundCount; bound++) {
+        const uint64_t boundNs = static_cast<uint64_t>(kMetricBounds[bound] * 1e9);
+        while (index < HistogramSnapshot::kBucketCount - 1 && HistogramSnapshot::BucketLowerBound(index + 1) <= boundNs) {
+            cumulative += buckets[index++];
+        }
+        snprintf(bucketLabels, sizeof(bucketLabels), "%s,le=\"%g\"", labels, kMetricBounds[bound]);
+        metrics.Sample(sampleName, bucketLabels, cumulative);
+    }
+    snprintf(bucketLabels, sizeof(bucketLabels), "%s,le=\"+Inf\"", labels);
+    metrics.Sample(sampleName, bucketLabels, histogram.Count());
+
+    snprintf(sampleName, sizeof(sampleName), "%s_count", name);
+    metrics.Sample(sampleName, labels, histogram.Count());
+    snprintf(sampleName, sizeof(sampleName), "%s_sum", name);
+    metrics.Sample(sampleName, labels, histogram.SumNs() / 1e9);
+}
+
+void DecodeStats::WriteMetrics(MetricsText &metrics) {
+    StatsRegistry &registry = StatsRegistry::Instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    // Reused between scrapes, guarded by the registry mutex
+    static HistogramSnapshot scratch;
+    char labels[kLabelBytes];
+
+    metrics.Family("barkoder_decode_stage_seconds", "histogram", "Time spent in each stage of a decode request.");
+    for (int stage = 0; stage < kStageCount; stage++) {
+        for (int speed = 0; speed < kSpeedCount; speed++) {
+            for (int size = 0; size < kSizeCount; size++) {
+                scratch.Clear();
+                AccumulateShards(registry, stage, speed, size, scratch);
+                if (scratch.Count() == 0) {
+                    continue;
+                }
+                snprintf(labels, sizeof(labels), "stage=\"%s\",speed=\"%s\",size=\"%s\"",
+                         kStageNames[stage], kSpeedNames[speed], kSizeNames[size]);
+                WriteHistogram(metrics, "barkoder_decode_stage_seconds", labels, scratch);
+            }
+        }
+    }
+
+    uint64_t results[kBarcodeTypeCount] = {};
+    metrics.Family("barkoder_decodes", "counter", "Decodes by enabled decoder set and whether anything was decoded.");
+    for (int set = 0; set < kSetCount; set++) {
+        OutcomeSnapshot outcome = SumOutcomes(registry, set);
+        if (outcome.hits.Count() == 0 && outcome.misses.Count() == 0) {
+            continue;
+        }
+        for (int type = 0; type < kBarcodeTypeCount; type++) {
+            results[type] += outcome.results[type];
+        }
+
+        int length = snprintf(labels, sizeof(labels), "decoders=\"");
+        if (set < static_cast<int>(registry.decoderSets.size())) {
+            const std::vector<DecoderType> &decoders = registry.decoderSets[set];
+            for (size_t i = 0; i < decoders.size() && length < static_cast<int>(sizeof(labels)) - 64; i++) {
+                int index = static_cast<int>(decoders[i]);
+                const char *name = index >= 0 && index < kDecoderTypeCount ? kDecoderTypeNames[index] : "unknown";
+                length += snprintf(labels + length, sizeof(labels) - length, "%s%s", i ? "," : "", name);
+            }
+        } else {
+            length += snprintf(labels + length, sizeof(labels) - length, "other");
+        }
+
+        snprintf(labels + length, sizeof(labels) - length, "\",outcome=\"hit\"");
+        metrics.Sample("barkoder_decodes_total", labels, outcome.hits.Count());
+        snprintf(labels + length, sizeof(labels) - length, "\",outcome=\"miss\"");
+        metrics.Sample("barkoder_decodes_total", labels, outcome.misses.Count());
+    }
+
+    metrics.Family("barkoder_results", "counter", "Decoded barcodes by type.");
+    for (int type = 0; type < kBarcodeTypeCount; type++) {
+        if (results[type] > 0) {
+            snprintf(labels, sizeof(labels), "type=\"%s\"", kBarcodeTypeNames[type]);
+            metrics.Sample("barkoder_results_total", labels, results[type]);
+        }
+    }
+}
+
+}
@@ -0,0 +1,167 @@
+#ifndef DecodeStats_hpp
+#define DecodeStats_hpp
+
+#include <stdint.h>
+#include <chrono>
+#include <vector>
+#include "SpecificConfigs.hpp"
+
+struct cJSON;
+class BaseResult;
+
+namespace BKNode {
+class MetricsText;
+}
+
+namespace BKNode {
+
+/**
+ * @brief Stages of a decode request that are timed separately.
+ */
+enum class DecodeStage {
+    QueueWait = 0,  /**< Waiting for a pool worker. */
+    Conversion,     /**< Argument unpacking and input preparation. */
+    Decode,         /**< Barkoder::DecodeImageMemory, including every strategy pass. */
+    Marshal,        /**< Building the result returned to JavaScript. */
+    Total,          /**< Call entry to result delivery. */
+    Count
+};
+
+/**
+ * @brief Image size classes latencies are broken down by.
+ */
+enum class SizeBucket {
+    UpTo1MP = 0,
+    UpTo4MP,
+    UpTo16MP,
+    Over16MP,
+    Count
+};
+
+/**
+ * @brief Log-linear latency histogram merged from all threads.
+ *
+ * Bucket width is 1/16 of the power of two a value falls in, so any
+ * percentile is within about 3% of the recorded value.
+ */
+class HistogramSnapshot {
+public:
+    static const int kSubBucketBits = 4;
+    static const int kMaxValueBits = 36; /**< Values are clamped to about 68 s. */
+    static const int kBucketCount = (kMaxValueBits - kSubBucketBits + 1) << kSubBucketBits;
+
+    /**
+     * @brief Gets the bucket a nanosecond value is counted in.
+     */
+    static int BucketIndex(uint64_t ns);
+
+    /**
+     * @brief Gets the smallest value counted in a bucket.
+     */
+    static uint64_t BucketLowerBound(int index);
+
+    HistogramSnapshot() : buckets(kBucketCount, 0) {}
+
+    uint64_t Count() const { return count; }
+    uint64_t SumNs() const { return sumNs; }
+
+    /**
+     * @brief Gets the value below which the given fraction of samples falls.
+     * @param quantile Fraction between 0 and 1.
+     * @return Midpoint of the bucket holding the quantile, in nanoseconds.
+     */
+    uint64_t ValueAtQuantile(double quantile) const;
+
+    const std::vector<uint64_t> &Buckets() const { return buckets; }
+
+    void Add(const HistogramSnapshot &other);
+    void Subtract(const HistogramSnapshot &other);
+    void Clear();
+
+private:
+    friend struct AtomicHistogram;
+
+    std::vector<uint64_t> buckets;
+    uint64_t count = 0;
+    uint64_t sumNs = 0;
+};
+
+/**
+ * @brief Decode latency statistics, recorded without locks by any thread.
+ *
+ * Every thread writes its own histograms. They are only summed when
+ * statistics are read, so recording never contends between threads.
+ */
+class DecodeStats {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * @brief Gets the size class of an image.
+     */
+    static SizeBucket SizeBucketFor(int width, int height);
+
+    /**
+     * @brief Records the duration of one stage.
+     * @param stage The stage timed.
+     * @param speed Decoding speed of the request.
+     * @param size Size class of the image.
+     * @param ns Duration in nanoseconds.
+     */
+    static void Record(DecodeStage stage, NSBarkoder::DecodingSpeed speed, SizeBucket size, uint64_t ns);
+
+    /**
+     * @brief Records the time elapsed between two points.
+     */
+    static void Record(DecodeStage stage, NSBarkoder::DecodingSpeed speed, SizeBucket size,
+                       Clock::time_point from, Clock::time_point to);
+
+    /**
+     * @brief Decoder sets counted separately. Sets registered after these are all counted in the last one.
+     */
+    static const int kMaxDecoderSets = 16;
+
+    /**
+     * @brief Gets the slot outcomes of an enabled-decoder set are counted in, registering new sets.
+     * @param decoders The enabled decoders.
+     * @return Index to pass to RecordOutcome.
+     */
+    static int DecoderSetIndex(const std::vector<NSBarkoder::DecoderType> &decoders);
+
+    /**
+     * @brief Counts the results of one decode by barcode type and records its decode time as a hit or a miss.
+     * @param decoderSet Index from DecoderSetIndex for the decoders enabled during the decode.
+     * @param results The decoded results. Undecoded location candidates are not counted as hits.
+     * @param decodeNs Decode stage duration in nanoseconds.
+     */
+    static void RecordOutcome(int decoderSet, const std::vector<BaseResult> &results, uint64_t decodeNs);
+
+    /**
+     * @brief Sums every thread's histogram for one stage, speed and size, minus the last reset.
+     */
+    static HistogramSnapshot Snapshot(DecodeStage stage, NSBarkoder::DecodingSpeed speed, SizeBucket size);
+
+    /**
+     * @brief Renders all statistics since the last reset as JSON.
+     * @return New cJSON object owned by the caller.
+     */
+    static cJSON *ToJson();
+
+    /**
+     * @brief Writes all counters and histograms as OpenMetrics families.
+     *
+     * Values count from process start and are not affected by Reset, so
+     * scrapers always see monotonic counters.
+     * @param metrics Writer between Begin and End.
+     */
+    static void WriteMetrics(MetricsText &metrics);
+
+    /**
+     * @brief Starts counting from zero again.
+     */
+    static void Reset();
+};
+
+}
+
+#endif /* DecodeStats_hpp */
@@ -0,0 +1,631 @@
+#include "DecodeStrategies.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <stdexcept>
+#include "DecodePool.hpp"
+#include "DecodeStats.hpp"
+#include "ImageOps.hpp"
+#include "Tracer.hpp"
+
+using namespace NSBarkoder;
+
+namespace BKNode {
+
+typedef std::chrono::steady_clock Clock;
+
+// Tiles are never smaller than this, so small barcode sizes do not produce thousands of tiles
+static const int kMinTileSize = 512;
+
+// Same data found in two tiles is one barcode when the corner outlines overlap at least this much
+static const float kDuplicateIoU = 0.3f;
+
+/**
+ * Copy the settings the Config copy constructor leaves at their defaults;
+ * it only carries over the per-decoder configuration
+ */
+static void CopySettings(Config &from, Config &to) {
+    to.decodingSpeed = from.decodingSpeed;
+    to.encodingCharacterSet = from.encodingCharacterSet;
+    to.maximumResultsCount = from.maximumResultsCount;
+    to.duplicatesDelayMs = from.duplicatesDelayMs;
+    to.upcEanDeblur = from.upcEanDeblur;
+    to.enableMisshaped1D = from.enableMisshaped1D;
+    to.enableVINRestrictions = from.enableVINRestrictions;
+    to.enableComposite = from.enableComposite;
+    to.customParams = from.customParams;
+    to.formatting = from.formatting;
+
+    float left, top, width, height;
+    from.GetRegionOfInterest(left, top, width, height);
+    to.SetRegionOfInterest(left, top, width, height);
+}
+
+ConfigVariants::ConfigVariants(Config &source) : base(source) {
+    CopySettings(source, base);
+    base.GetRegionOfInterest(regionOfInterest.left, regionOfInterest.top, regionOfInterest.width, regionOfInterest.height);
+    enabledDecoders = source.GetEnabledDecoders();
+    decoderSet = DecodeStats::DecoderSetIndex(enabledDecoders);
+    charge.Set(sizeof(ConfigVariants));
+}
+
+Config *ConfigVariants::Get(DecodingSpeed speed, bool fullFrame) {
+    if (speed == base.decodingSpeed && !fullFrame) {
+        return &base;
+    }
+    if (speed < DecodingSpeed::Fast || speed > DecodingSpeed::Rigorous) {
+        throw std::invalid_argument("Invalid decoding speed " + std::to_string(static_cast<int>(speed)));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<Config> &variant = variants[static_cast<int>(speed)][fullFrame ? 1 : 0];
+    if (!variant) {
+        variant.reset(new Config(base));
+        CopySettings(base, *variant);
+        variant->decodingSpeed = speed;
+        if (fullFrame) {
+            variant->SetRegionOfInterest(0, 0, 100, 100);
+        }
+        charge.Set(charge.Bytes() + sizeof(Config));
+    }
+    return variant.get();
+}
+
+std::unique_ptr<Config> ConfigVariants::WithDecoders(const std::vector<DecoderType> &decoders, DecodingSpeed speed) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<Config> copy(new Config(base));
+    CopySettings(base, *copy);
+    copy->SetEnabledDecoders(decoders);
+    copy->decodingSpeed = speed;
+    return copy;
+}
+
+/**
+ * Results of decoding one image, and the speed of its last attempt
+ */
+struct PassResult {
+    std::vector<BaseResult> results;
+    DecodingSpeed speed = DecodingSpeed::Normal;
+};
+
+/**
+ * Whether a result carries data, as opposed to a located but undecoded candidate
+ */
+static bool IsDecoded(const BaseResult &result) {
+    return !result.textualData.empty() || !result.binaryData.empty();
+}
+
+static bool AnyDecoded(const std::vector<BaseResult> &results) {
+    return std::any_of(results.begin(), results.end(), IsDecoded);
+}
+
+void TransformResult(BaseResult &result, float scale, float dx, float dy) {
+    auto transform = [&](BKPoint &point) {
+        point.x = point.x * scale + dx;
+        point.y = point.y * scale + dy;
+    };
+
+    for (BKPoint &point : result.location) {
+        transform(point);
+    }
+    for (BKPoint &point : result.polygonLocation) {
+        transform(point);
+    }
+    transform(result.locationCenter);
+}
+
+/**
+ * Bounding box of a result's corners, grown by half its size so quiet zones are kept
+ */
+static ImageRect PaddedBounds(const BaseResult &result) {
+    float minX = result.location[0].x, maxX = minX;
+    float minY = result.location[0].y, maxY = minY;
+    for (const BKPoint &point : result.location) {
+        minX = std::min(minX, point.x);
+        maxX = std::max(maxX, point.x);
+        minY = std::min(minY, point.y);
+        maxY = std::max(maxY, point.y);
+    }
+
+    ImageRect rect;
+    if (maxX <= minX || maxY <= minY) {
+        return rect;
+    }
+
+    int padding = std::max(16, static_cast<int>(std::max(maxX - minX, maxY - minY) / 2));
+    rect.left = static_cast<int>(minX) - padding;
+    rect.top = static_cast<int>(minY) - padding;
+    rect.width = static_cast<int>(maxX - minX) + 2 * padding;
+    rect.height = static_cast<int>(maxY - minY) + 2 * padding;
+    return rect;
+}
+
+static std::atomic<uint64_t> deadlineSkipped{0};
+static std::atomic<uint64_t> deadlineCutShort{0};
+
+/**
+ * Whether the caller asked to stop before the next step
+ */
+static bool AbortRequested(const DecodeOptions &options) {
+    return options.abort && options.abort->load(std::memory_order_relaxed);
+}
+
+/**
+ * Whether to start another step. Stops when the caller aborted, or when less time is
+ * left before the deadline than the previous step took: escalation steps cost at least
+ * as much as the one before, and a result after the deadline is worthless.
+ */
+static bool MayContinue(const DecodeOptions &options, Clock::duration lastStep, DecodeOutcome &outcome) {
+    if (AbortRequested(options)) {
+        outcome.aborted = true;
+        return false;
+    }
+    if (options.deadline != Clock::time_point::max() && Clock::now() + lastStep > options.deadline) {
+        outcome.deadlineExceeded = true;
+        return false;
+    }
+    return true;
+}
+
+// Location preview setting last applied to the SDK (-1 = not set yet), and the decodes using and waiting for it
+static std::mutex previewMutex;
+static std::condition_variable previewChanged;
+static int previewSetting = -1;
+static int previewDecodes = 0;
+static int previewWaiting[2] = {0, 0};
+
+std::vector<BaseResult> DecodeWithSdk(Config *config, uint8_t *pixels, int width, int height, bool locationPreview) {
+    const int wanted = locationPreview ? 1 : 0;
+    {
+        std::unique_lock<std::mutex> lock(previewMutex);
+        previewWaiting[wanted]++;
+        previewChanged.wait(lock, [wanted] {
+            return previewSetting == wanted ? previewWaiting[1 - wanted] == 0 : previewDecodes == 0;
+        });
+        previewWaiting[wanted]--;
+        if (previewSetting != wanted) {
+            Config::SetGlobalOption(BKGlobalOption_RestultLocationPreview, wanted);
+            previewSetting = wanted;
+            previewChanged.notify_all();
+        }
+        previewDecodes++;
+    }
+
+    struct Release {
+        ~Release() {
+            std::lock_guard<std::mutex> lock(previewMutex);
+            if (--previewDecodes == 0) {
+                previewChanged.notify_all();
+            }
+        }
+    } release;
+    return Barkoder::DecodeImageMemory(config, pixels, width, height);
+}
+
+/**
+ * Run the SDK decoder on one image at one speed
+ */
+static std::vector<BaseResult> DecodeAtSpeed(ConfigVariants &variants, DecodingSpeed speed, bool fullFrame, bool locationPreview,
+                                             uint8_t *pixels, int width, int height) {
+    TraceSpan span("DecodeImageMemory", "speed", static_cast<int64_t>(speed));
+    return DecodeWithSdk(variants.Get(speed, fullFrame), pixels, width, height, locationPreview);
+}
+
+/**
+ * Decode one image at each cascade speed until something is decoded,
+ * or once at the configured speed when no cascade is set
+ */
+static PassResult DecodePass(ConfigVariants &variants, const DecodeOptions &options, bool fullFrame, bool locationPreview,
+                             Clock::time_point start, uint8_t *pixels, int width, int height, DecodeOutcome &outcome) {
+    const CascadeOptions &cascade = options.cascade;
+    PassResult pass;
+
+    if (cascade.speeds.empty()) {
+        pass.speed = variants.BaseSpeed();
+        outcome.attempts++;
+        pass.results = DecodeAtSpeed(variants, pass.speed, fullFrame, locationPreview, pixels, width, height);
+        return pass;
+    }
+
+    Clock::time_point levelStart = Clock::now();
+    for (size_t i = 0; i < cascade.speeds.size(); i++) {
+        Clock::time_point now = Clock::now();
+        if (i > 0 && !MayContinue(options, now - levelStart, outcome)) {
+            break;
+        }
+        levelStart = now;
+        if (i > 0 && cascade.timeBudgetMs > 0) {
+            auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+            if (elapsedMs >= cascade.timeBudgetMs) {
+                outcome.budgetExhausted = true;
+                break;
+            }
+        }
+
+        pass.speed = cascade.speeds[i];
+        outcome.attempts++;
+        pass.results = DecodeAtSpeed(variants, pass.speed, fullFrame, locationPreview, pixels, width, height);
+
+        if (AnyDecoded(pass.results)) {
+            break;
+        }
+    }
+
+    return pass;
+}
+
+/**
+ * Full-resolution crop to decode again, and the coarse results it was made for
+ */
+struct Refinement {
+    ImageRect rect;
+    std::vector<BaseResult> coarseResults;
+};
+
+/**
+ * Merge overlapping crops so no area is decoded twice
+ */
+static void MergeOverlapping(std::vector<Refinement> &refinements) {
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < refinements.size() && !merged; i++) {
+            for (size_t j = i + 1; j < refinements.size(); j++) {
+                if (refinements[i].rect.Intersects(refinements[j].rect)) {
+                    refinements[i].rect = refinements[i].rect.United(refinements[j].rect);
+                    refinements[i].coarseResults.insert(refinements[i].coarseResults.end(),
+                                                        refinements[j].coarseResults.begin(), refinements[j].coarseResults.end());
+                    refinements.erase(refinements.begin() + j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Decode a downscaled copy, then full-resolution crops around what it found
+ */
+static void DecodePyramid(ConfigVariants &variants, const DecodeOptions &options, Clock::time_point start,
+                          uint8_t *pixels, int width, int height, DecodeOutcome &outcome) {
+    const int factor = options.pyramid.factor;
+    bool found = false;
+    auto record = [&](const PassResult &pass) {
+        outcome.decodingSpeed = found ? std::max(outcome.decodingSpeed, pass.speed) : pass.speed;
+        found = true;
+    };
+
+    int coarseWidth = 0;
+    int coarseHeight = 0;
+    std::vector<uint8_t> coarse = Downscale(pixels, width, height, factor, coarseWidth, coarseHeight);
+    MemoryCharge coarseCharge(MemoryCategory::ConversionScratch, coarse.size());
+    Clock::time_point passStart = Clock::now();
+    // Barcodes too small to read at this scale are still located, so their crops get decoded at full resolution
+    PassResult coarsePass = DecodePass(variants, options, false, true, start, coarse.data(), coarseWidth, coarseHeight, outcome);
+    const Clock::duration coarseDuration = Clock::now() - passStart;
+    Clock::duration lastPass = coarseDuration;
+    outcome.decodingSpeed = coarsePass.speed;
+    coarse = std::vector<uint8_t>();
+    coarseCharge.Set(0);
+
+    std::vector<Refinement> refinements;
+    for (BaseResult &result : coarsePass.results) {
+        TransformResult(result, static_cast<float>(factor), 0, 0);
+        ImageRect rect = PaddedBounds(result).Clamped(width, height);
+
+        if (!rect.Empty()) {
+            refinements.push_back({rect, {result}});
+        } else if (IsDecoded(result)) {
+            // Nothing to crop around, keep the coarse result as is
+            outcome.results.push_back(result);
+            record(coarsePass);
+        }
+    }
+    MergeOverlapping(refinements);
+
+    bool stopped = outcome.aborted || outcome.deadlineExceeded;
+    for (const Refinement &refinement : refinements) {
+        const ImageRect &rect = refinement.rect;
+        PassResult finePass;
+        stopped = stopped || !MayContinue(options, lastPass, outcome);
+        if (!stopped) {
+            std::vector<uint8_t> crop = Crop(pixels, width, rect);
+            MemoryCharge cropCharge(MemoryCategory::ConversionScratch, crop.size());
+            passStart = Clock::now();
+            finePass = DecodePass(variants, options, true, false, start, crop.data(), rect.width, rect.height, outcome);
+            lastPass = Clock::now() - passStart;
+        }
+
+        if (AnyDecoded(finePass.results)) {
+            for (BaseResult &result : finePass.results) {
+                TransformResult(result, 1.0f, static_cast<float>(rect.left), static_cast<float>(rect.top));
+                outcome.results.push_back(result);
+            }
+            record(finePass);
+        } else if (AnyDecoded(refinement.coarseResults)) {
+            // The full-resolution crop did not decode or was skipped, fall back to what the coarse pass read
+            outcome.results.insert(outcome.results.end(), refinement.coarseResults.begin(), refinement.coarseResults.end());
+            record(coarsePass);
+        }
+    }
+
+    // The full frame has factor squared as many pixels as the coarse pass
+    if (!found && options.pyramid.fullFrameFallback && !stopped &&
+        MayContinue(options, coarseDuration * (factor * factor), outcome)) {
+        PassResult fullPass = DecodePass(variants, options, false, false, start, pixels, width, height, outcome);
+        outcome.results = fullPass.results;
+        outcome.decodingSpeed = fullPass.speed;
+    }
+}
+
+/**
+ * Signed area of a polygon, positive for counter-clockwise vertices
+ */
+static float SignedArea(const std::vector<BKPoint> &polygon) {
+    float area = 0;
+    for (size_t i = 0; i < polygon.size(); i++) {
+        const BKPoint &a = polygon[i];
+        const BKPoint &b = polygon[(i + 1) % polygon.size()];
+        area += a.x * b.y - b.x * a.y;
+    }
+    return area / 2;
+}
+
+/**
+ * Corners of a result as a counter-clockwise quadrilateral
+ */
+static std::vector<BKPoint> CornerOutline(const BaseResult &result) {
+    std::vector<BKPoint> outline(result.location, result.location + 4);
+    if (SignedArea(outline) < 0) {
+        std::reverse(outline.begin(), outline.end());
+    }
+    return outline;
+}
+
+/**
+ * Clip a polygon by a convex counter-clockwise polygon (Sutherland-Hodgman)
+ */
+static std::vector<BKPoint> ClipPolygon(std::vector<BKPoint> subject, const std::vector<BKPoint> &clip) {
+    for (size_t i = 0; i < clip.size() && !subject.empty(); i++) {
+        const BKPoint &edgeStart = clip[i];
+        const BKPoint &edgeEnd = clip[(i + 1) % clip.size()];
+        auto side = [&](const BKPoint &p) {
+            return (edgeEnd.x - edgeStart.x) * (p.y - edgeStart.y) - (edgeEnd.y - edgeStart.y) * (p.x - edgeStart.x);
+        };
+
+        std::vector<BKPoint> input;
+        input.swap(subject);
+        for (size_t j = 0; j < input.size(); j++) {
+            const BKPoint &current = input[j];
+            const BKPoint &previous = input[(j + input.size() - 1) % input.size()];
+            float currentSide = side(current);
+            float previousSide = side(previous);
+
+            if ((currentSide >= 0) != (previousSide >= 0)) {
+                float t = previousSide / (previousSide - currentSide);
+                BKPoint crossing;
+                crossing.x = previous.x + t * (current.x - previous.x);
+                crossing.y = previous.y + t * (current.y - previous.y);
+                subject.push_back(crossing);
+            }
+            if (currentSide >= 0) {
+                subject.push_back(current);
+            }
+        }
+    }
+    return subject;
+}
+
+/**
+ * Whether two results are the same barcode seen from two overlapping tiles
+ */
+static bool IsSameBarcode(const BaseResult &a, const BaseResult &b) {
+    if (a.barcodeType != b.barcodeType || a.textualData != b.textualData) {
+        return false;
+    }
+
+    std::vector<BKPoint> outlineA = CornerOutline(a);
+    std::vector<BKPoint> outlineB = CornerOutline(b);
+    float areaA = SignedArea(outlineA);
+    float areaB = SignedArea(outlineB);
+    if (areaA <= 0 || areaB <= 0) {
+        // No geometry to tell them apart
+        return true;
+    }
+
+    float intersection = std::fabs(SignedArea(ClipPolygon(outlineA, outlineB)));
+    return intersection / (areaA + areaB - intersection) >= kDuplicateIoU;
+}
+
+bool MergeResult(std::vector<BaseResult> &results, const BaseResult &result) {
+    for (BaseResult &existing : results) {
+        if (IsSameBarcode(existing, result)) {
+            if (SignedArea(CornerOutline(result)) > SignedArea(CornerOutline(existing))) {
+                existing = result;
+            }
+            return false;
+        }
+    }
+    results.push_back(result);
+    return true;
+}
+
+/**
+ * Start offsets of tiles covering a length, the last one aligned to the end
+ */
+static std::vector<int> TileOffsets(int length, int tileSize, int stride) {
+    std::vector<int> offsets;
+    for (int offset = 0; ; offset += stride) {
+        if (offset + tileSize >= length) {
+            offsets.push_back(std::max(0, length - tileSize));
+            break;
+        }
+        offsets.push_back(offset);
+    }
+    return offsets;
+}
+
+std::vector<ImageRect> PlanTiles(const ImageRect &area, int maxBarcodeSize) {
+    const int overlap = maxBarcodeSize;
+    const int tileSize = std::max(kMinTileSize, 4 * overlap);
+
+    std::vector<ImageRect> tiles;
+    for (int top : TileOffsets(area.height, tileSize, tileSize - overlap)) {
+        for (int left : TileOffsets(area.width, tileSize, tileSize - overlap)) {
+            ImageRect tile;
+            tile.left = area.left + left;
+            tile.top = area.top + top;
+            tile.width = std::min(tileSize, area.width);
+            tile.height = std::min(tileSize, area.height);
+            tiles.push_back(tile);
+        }
+    }
+    return tiles;
+}
+
+/**
+ * Decode overlapping tiles of the region of interest in parallel and merge their results
+ */
+static void DecodeTiles(ConfigVariants &variants, const DecodeOptions &options, DecodePool *pool, Clock::time_point start,
+                        uint8_t *pixels, int width, int height, DecodeOutcome &outcome) {
+    const Rect &roi = variants.RegionOfInterest();
+    ImageRect area;
+    area.left = static_cast<int>(roi.left * width / 100);
+    area.top = static_cast<int>(roi.top * height / 100);
+    area.width = static_cast<int>(std::ceil(roi.width * width / 100));
+    area.height = static_cast<int>(std::ceil(roi.height * height / 100));
+    area = area.Clamped(width, height);
+    std::vector<ImageRect> tiles = PlanTiles(area, options.tiles.maxBarcodeSize);
+
+    const int maximumResults = variants.MaximumResultsCount();
+    std::vector<std::vector<BaseResult>> tileResults(tiles.size());
+    std::vector<BaseResult> distinct;
+    std::atomic<bool> enough{false};
+    std::atomic<int64_t> lastTileNs{0};
+    std::mutex mutex;
+    bool found = false;
+
+    auto decodeTile = [&](int index) {
+        if (enough) {
+            return;
+        }
+        DecodeOutcome tileOutcome;
+        if (!MayContinue(options, std::chrono::nanoseconds(lastTileNs.load(std::memory_order_relaxed)), tileOutcome)) {
+            std::lock_guard<std::mutex> lock(mutex);
+            outcome.aborted = outcome.aborted || tileOutcome.aborted;
+            outcome.deadlineExceeded = outcome.deadlineExceeded || tileOutcome.deadlineExceeded;
+            return;
+        }
+        Clock::time_point tileStart = Clock::now();
+
+        const ImageRect &tile = tiles[index];
+        std::vector<uint8_t> crop = Crop(pixels, width, tile);
+        MemoryCharge cropCharge(MemoryCategory::ConversionScratch, crop.size());
+        PassResult pass = DecodePass(variants, options, true, false, start, crop.data(), tile.width, tile.height, tileOutcome);
+        lastTileNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - tileStart).count(),
+                         std::memory_order_relaxed);
+        for (BaseResult &result : pass.results) {
+            TransformResult(result, 1.0f, static_cast<float>(tile.left), static_cast<float>(tile.top));
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        outcome.attempts += tileOutcome.attempts;
+        outcome.budgetExhausted = outcome.budgetExhausted || tileOutcome.budgetExhausted;
+        outcome.aborted = outcome.aborted || tileOutcome.aborted;
+        outcome.deadlineExceeded = outcome.deadlineExceeded || tileOutcome.deadlineExceeded;
+        outcome.tiles++;
+
+        if (AnyDecoded(pass.results)) {
+            outcome.decodingSpeed = found ? std::max(outcome.decodingSpeed, pass.speed) : pass.speed;
+            found = true;
+        } else if (!found) {
+            outcome.decodingSpeed = pass.speed;
+        }
+
+        for (const BaseResult &result : pass.results) {
+            if (IsDecoded(result)) {
+                MergeResult(distinct, result);
+            }
+        }
+        if (maximumResults > 0 && static_cast<int>(distinct.size()) >= maximumResults) {
+            enough = true;
+        }
+        tileResults[index] = std::move(pass.results);
+    };
+
+    if (pool) {
+        pool->ParallelFor(static_cast<int>(tiles.size()), decodeTile);
+    } else {
+        for (size_t i = 0; i < tiles.size(); i++) {
+            decodeTile(static_cast<int>(i));
+        }
+    }
+
+    // Merge again in tile order so the output does not depend on thread timing. Tiles already
+    // running when the limit was reached still add results, so cap here: earlier tiles win.
+    for (const std::vector<BaseResult> &results : tileResults) {
+        for (const BaseResult &result : results) {
+            if (maximumResults > 0 && static_cast<int>(outcome.results.size()) >= maximumResults) {
+                return;
+            }
+            if (IsDecoded(result)) {
+                MergeResult(outcome.results, result);
+            }
+        }
+    }
+}
+
+DecodeOutcome Decode(ConfigVariants &variants, const DecodeOptions &options, DecodePool *pool, uint8_t *pixels, int width, int height) {
+    DecodeOutcome outcome;
+    auto start = Clock::now();
+    const PyramidOptions &pyramid = options.pyramid;
+    const TileOptions &tiles = options.tiles;
+
+    if (start >= options.deadline) {
+        // Too late to be of use, answer at once without decoding
+        outcome.decodingSpeed = variants.BaseSpeed();
+        outcome.deadlineExceeded = true;
+        deadlineSkipped.fetch_add(1, std::memory_order_relaxed);
+        return outcome;
+    }
+
+    if (tiles.maxBarcodeSize > 0 && static_cast<int64_t>(width) * height >= tiles.minPixels) {
+        DecodeTiles(variants, options, pool, start, pixels, width, height, outcome);
+    } else if (pyramid.factor > 1 && static_cast<int64_t>(width) * height >= pyramid.minPixels &&
+        width >= 2 * pyramid.factor && height >= 2 * pyramid.factor) {
+        outcome.pyramidFactor = pyramid.factor;
+        DecodePyramid(variants, options, start, pixels, width, height, outcome);
+    } else {
+        PassResult pass = DecodePass(variants, options, false, false, start, pixels, width, height, outcome);
+        outcome.results = pass.results;
+        outcome.decodingSpeed = pass.speed;
+    }
+
+    if (pyramid.factor > 1) {
+        // Location preview is on for the pyramid, never return its undecoded candidates
+        outcome.results.erase(std::remove_if(outcome.results.begin(), outcome.results.end(),
+                                             [](const BaseResult &result) { return !IsDecoded(result); }),
+                              outcome.results.end());
+    }
+
+    if (variants.MaximumResultsCount() > 0 && static_cast<int>(outcome.results.size()) > variants.MaximumResultsCount()) {
+        outcome.results.resize(variants.MaximumResultsCount());
+    }
+    if (outcome.deadlineExceeded) {
+        deadlineCutShort.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return outcome;
+}
+
+DeadlineMisses DeadlineMissCounts() {
+    DeadlineMisses misses;
+    misses.skipped = deadlineSkipped.load(std::memory_order_relaxed);
+    misses.cutShort = deadlineCutShort.load(std::memory_order_relaxed);
+    return misses;
+}
+
+}
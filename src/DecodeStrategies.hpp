@@ -0,0 +1,221 @@
+#ifndef DecodeStrategies_hpp
+#define DecodeStrategies_hpp
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Barkoder.hpp"
+#include "ImageOps.hpp"
+#include "MemoryAccount.hpp"
+
+namespace BKNode {
+
+class DecodePool;
+
+/**
+ * @brief Copies of the user configuration that differ only in decoding speed or region of interest.
+ *
+ * Strategies that change the speed per attempt, or decode crops that must not be
+ * restricted by the region of interest, use these copies so the shared configuration
+ * is never mutated during a decode. Copies are built on first use.
+ */
+class ConfigVariants {
+public:
+    /**
+     * @brief Snapshots the user configuration.
+     * @param source Configuration to copy, not referenced afterwards.
+     */
+    explicit ConfigVariants(NSBarkoder::Config &source);
+
+    /**
+     * @brief Gets the configuration to use for the given decoding speed.
+     * @param speed The decoding speed.
+     * @param fullFrame Whether the region of interest is reset to the whole image.
+     * @return Configuration owned by this object.
+     * @throws std::invalid_argument The speed is not one of the DecodingSpeed values.
+     */
+    NSBarkoder::Config *Get(NSBarkoder::DecodingSpeed speed, bool fullFrame = false);
+
+    /**
+     * @brief Copies the user configuration with other decoders enabled and another speed.
+     * @param decoders The only decoders enabled in the copy.
+     * @param speed The decoding speed of the copy.
+     * @return Configuration owned by the caller.
+     */
+    std::unique_ptr<NSBarkoder::Config> WithDecoders(const std::vector<NSBarkoder::DecoderType> &decoders,
+                                                     NSBarkoder::DecodingSpeed speed);
+
+    /**
+     * @brief Gets the decoding speed of the user configuration.
+     */
+    NSBarkoder::DecodingSpeed BaseSpeed() const { return base.decodingSpeed; }
+
+    /**
+     * @brief Gets the maximum results count of the user configuration.
+     */
+    int MaximumResultsCount() const { return base.maximumResultsCount; }
+
+    /**
+     * @brief Gets the region of interest of the user configuration, in percent.
+     */
+    const NSBarkoder::Rect &RegionOfInterest() const { return regionOfInterest; }
+
+    /**
+     * @brief Gets the enabled decoders of the user configuration.
+     */
+    const std::vector<NSBarkoder::DecoderType> &EnabledDecoders() const { return enabledDecoders; }
+
+    /**
+     * @brief Gets the DecodeStats slot of the enabled decoders of the user configuration.
+     */
+    int DecoderSet() const { return decoderSet; }
+
+private:
+    std::mutex mutex;
+    NSBarkoder::Config base;
+    NSBarkoder::Rect regionOfInterest;
+    std::vector<NSBarkoder::DecoderType> enabledDecoders;
+    int decoderSet;
+    std::unique_ptr<NSBarkoder::Config> variants[4][2];
+    MemoryCharge charge{MemoryCategory::Caches};
+};
+
+/**
+ * @brief Speeds tried by the cascade, in escalation order, and the per-request time budget.
+ */
+struct CascadeOptions {
+    std::vector<NSBarkoder::DecodingSpeed> speeds; /**< Empty disables the cascade. */
+    int timeBudgetMs = 0; /**< No further level is started once this is spent. 0 means unlimited. */
+};
+
+/**
+ * @brief Coarse-to-fine decoding of large images.
+ *
+ * The image is first decoded downscaled. Full-resolution crops around everything
+ * found (or located but not decoded) are then decoded again.
+ */
+struct PyramidOptions {
+    int factor = 1; /**< Downscale factor of the coarse pass, 2 or 4. 1 disables the pyramid. */
+    int minPixels = 4000000; /**< Images with fewer pixels are decoded directly. */
+    bool fullFrameFallback = false; /**< Decode the full image when the coarse pass finds nothing. */
+};
+
+/**
+ * @brief Decoding of huge images as overlapping tiles in parallel.
+ *
+ * Tiles overlap by the largest expected barcode size, so every barcode lies
+ * completely inside at least one tile. Results found twice in overlap zones are merged.
+ */
+struct TileOptions {
+    int maxBarcodeSize = 0; /**< Largest expected barcode side in pixels. 0 disables tiling. */
+    int minPixels = 4000000; /**< Images with fewer pixels are not tiled. */
+};
+
+/**
+ * @brief All strategies applied to a decode request.
+ *
+ * Tiling takes precedence over the pyramid when both apply to an image.
+ */
+struct DecodeOptions {
+    CascadeOptions cascade;
+    PyramidOptions pyramid;
+    TileOptions tiles;
+    const std::atomic<bool> *abort = nullptr; /**< Once true, no further cascade level, crop or tile is started. */
+    /** Nothing is decoded after this. A step is not started when less time is left than the previous step took. */
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+};
+
+/**
+ * @brief Results of a decode together with how they were obtained.
+ */
+struct DecodeOutcome {
+    std::vector<BaseResult> results;
+    NSBarkoder::DecodingSpeed decodingSpeed = NSBarkoder::DecodingSpeed::Normal; /**< Slowest speed that produced results, or the last speed tried. */
+    int attempts = 0; /**< Number of DecodeImageMemory calls made. */
+    bool budgetExhausted = false; /**< Escalation stopped because the time budget was spent. */
+    bool aborted = false; /**< The caller aborted the decode before every step ran, results are partial. */
+    bool deadlineExceeded = false; /**< The deadline left too little time for every step, results are the best found so far. */
+    int pyramidFactor = 1; /**< Downscale factor of the coarse pass, 1 when the pyramid was not used. */
+    int tiles = 0; /**< Number of tiles decoded, 0 when the image was not tiled. */
+};
+
+/**
+ * @brief Decodes an image with every enabled strategy.
+ * @param variants Configuration copies to decode with.
+ * @param options Strategies to apply.
+ * @param pool Pool that decodes tiles in parallel, or nullptr to decode them on the calling thread.
+ * @param pixels Pointer to the grayscale image pixels.
+ * @param width Width of the image.
+ * @param height Height of the image.
+ * @return Results with coordinates in the original image.
+ */
+DecodeOutcome Decode(ConfigVariants &variants, const DecodeOptions &options, DecodePool *pool, uint8_t *pixels, int width, int height);
+
+/**
+ * @brief Splits an area into the tiles decoded for it.
+ *
+ * Tiles are at least 512 pixels and four barcode sizes wide and overlap their
+ * neighbours by maxBarcodeSize. The last tile of a row or column is aligned to
+ * the end of the area, so it may overlap more.
+ * @param area Region of the image to cover.
+ * @param maxBarcodeSize Largest expected barcode side in pixels.
+ * @return Tiles in row-major order, in image coordinates.
+ */
+std::vector<ImageRect> PlanTiles(const ImageRect &area, int maxBarcodeSize);
+
+/**
+ * @brief Maps result coordinates with x' = x * scale + dx, y' = y * scale + dy.
+ *
+ * Moves results found in a downscaled image or a crop back to the original image.
+ */
+void TransformResult(BaseResult &result, float scale, float dx, float dy);
+
+/**
+ * @brief Adds a result unless it duplicates one already present.
+ *
+ * Two results are the same barcode when type and text match and their corner
+ * outlines overlap with an IoU of at least 0.3, or either has no outline. The
+ * larger outline is kept, since a barcode cut by a tile edge may still decode
+ * with partial corners.
+ * @return Whether the result was new.
+ */
+bool MergeResult(std::vector<BaseResult> &results, const BaseResult &result);
+
+/**
+ * @brief Runs one SDK decode with the SDK's location preview on or off.
+ *
+ * Location preview is a process-wide SDK option that makes decodes also return
+ * barcodes they located but could not read. Only coarse pyramid passes want it,
+ * so every SDK decode goes through here: calls wanting the current setting run
+ * together, and a call wanting the other one waits until they have finished.
+ * Calls wanting the current setting that arrive meanwhile queue behind it, so
+ * neither side starves.
+ * @param config Configuration to decode with.
+ * @param pixels Pointer to the grayscale image pixels.
+ * @param width Width of the image.
+ * @param height Height of the image.
+ * @param locationPreview Whether located but unread barcodes are returned too.
+ * @return Results of the SDK.
+ */
+std::vector<BaseResult> DecodeWithSdk(NSBarkoder::Config *config, uint8_t *pixels, int width, int height,
+                                      bool locationPreview = false);
+
+/**
+ * @brief Decodes that missed their deadline since process start.
+ */
+struct DeadlineMisses {
+    uint64_t skipped = 0;  /**< The deadline had passed before decoding started. */
+    uint64_t cutShort = 0; /**< Some steps ran, later ones were skipped. */
+};
+
+/**
+ * @brief Gets the deadline misses of every Decode call so far.
+ */
+DeadlineMisses DeadlineMissCounts();
+
+}
+
+#endif /* DecodeStrategies_hpp */
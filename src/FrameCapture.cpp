@@ -0,0 +1,249 @@
+#include "FrameCapture.hpp"
+#include <stdio.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "MemoryAccount.hpp"
+
+namespace BKNode {
+
+std::atomic<bool> FrameCapture::active{false};
+
+// Frames waiting for the writer are bounded by this many bytes, later frames are dropped
+static const uint64_t kMaxQueuedBytes = 64ull << 20;
+
+static const size_t kFrameHeaderBytes = 4 + 8 + 8 + 4 * 4 + 8 * 3 + 4 * 3;
+
+/**
+ * A running capture. Owned by the control functions, written by its writer thread.
+ */
+struct CaptureSession {
+    FILE *file = nullptr;
+    std::thread writer;
+    std::chrono::steady_clock::time_point origin;
+    uint64_t maxBytes = 0;
+
+    // Guarded by queueMutex
+    std::deque<CapturedFrame> queue;
+    uint64_t queuedBytes = 0;
+    uint64_t reservedBytes = 0; // File size once every queued frame is written
+    bool stopping = false;
+
+    // Only touched by the writer thread until it is joined
+    std::vector<uint64_t> offsets;
+    uint64_t writtenBytes = 0;
+    std::string error;
+    std::string buffer;
+};
+
+static std::mutex controlMutex;
+static std::mutex queueMutex;
+static std::condition_variable queueChanged;
+static std::unique_ptr<CaptureSession> session;
+static std::atomic<uint64_t> sampleCounter{0};
+static std::atomic<uint32_t> sampleInterval{1};
+static std::atomic<uint64_t> droppedFrames{0};
+
+static void Append(std::string &buffer, const void *data, size_t length) {
+    buffer.append(static_cast<const char *>(data), length);
+}
+
+template <typename T>
+static void AppendValue(std::string &buffer, T value) {
+    Append(buffer, &value, sizeof(value)); // Supported targets are little-endian
+}
+
+static size_t FrameBytes(const CapturedFrame &frame) {
+    return kFrameHeaderBytes + frame.settings.size() + frame.result.size() + frame.pixels.size();
+}
+
+/**
+ * Write raw bytes, remembering the first failure
+ */
+static void WriteBytes(CaptureSession &capture, const std::string &bytes) {
+    if (!capture.error.empty()) {
+        return;
+    }
+    if (fwrite(bytes.data(), 1, bytes.size(), capture.file) != bytes.size()) {
+        capture.error = "Write to capture file failed";
+        return;
+    }
+    capture.writtenBytes += bytes.size();
+}
+
+static void WriteFrame(CaptureSession &capture, const CapturedFrame &frame) {
+    auto since = std::chrono::duration_cast<std::chrono::nanoseconds>(frame.received - capture.origin).count();
+
+    std::string &buffer = capture.buffer;
+    buffer.clear();
+    AppendValue<uint32_t>(buffer, static_cast<uint32_t>(FrameBytes(frame) - 4));
+    AppendValue<uint64_t>(buffer, since > 0 ? static_cast<uint64_t>(since) : 0);
+    AppendValue<uint64_t>(buffer, FrameCapture::Fingerprint(frame.settings));
+    AppendValue<uint32_t>(buffer, static_cast<uint32_t>(frame.width));
+    AppendValue<uint32_t>(buffer, static_cast<uint32_t>(frame.height));
+    AppendValue<uint32_t>(buffer, static_cast<uint32_t>(frame.format));
+    AppendValue<uint32_t>(buffer, frame.async ? 1 : 0);
+    AppendValue<uint64_t>(buffer, frame.queueNs);
+    AppendValue<uint64_t>(buffer, frame.decodeNs);
+    AppendValue<uint64_t>(buffer, frame.totalNs);
+    AppendValue<uint32_t>(buffer, static_cast<uint32_t>(frame.settings.size()));
+    AppendValue<uint32_t>(buffer, static_cast<uint32_t>(frame.result.size()));
+    AppendValue<uint32_t>(buffer, static_cast<uint32_t>(frame.pixels.size()));
+    buffer += frame.settings;
+    buffer += frame.result;
+    WriteBytes(capture, buffer);
+
+    // Pixels are written from the frame directly rather than copied into the buffer
+    if (capture.error.empty()) {
+        if (fwrite(frame.pixels.data(), 1, frame.pixels.size(), capture.file) != frame.pixels.size()) {
+            capture.error = "Write to capture file failed";
+            return;
+        }
+        capture.writtenBytes += frame.pixels.size();
+    }
+}
+
+static void WriterLoop(CaptureSession *capture) {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true) {
+        queueChanged.wait(lock, [capture] { return capture->stopping || !capture->queue.empty(); });
+        if (capture->queue.empty()) {
+            return; // Stopping with nothing left to write
+        }
+
+        CapturedFrame frame = std::move(capture->queue.front());
+        capture->queue.pop_front();
+        lock.unlock();
+
+        uint64_t offset = capture->writtenBytes;
+        WriteFrame(*capture, frame);
+        if (capture->error.empty()) {
+            capture->offsets.push_back(offset);
+        }
+
+        lock.lock();
+        capture->queuedBytes -= FrameBytes(frame);
+        MemoryAccount::Add(MemoryCategory::Capture, -static_cast<int64_t>(FrameBytes(frame)));
+    }
+}
+
+bool FrameCapture::Start(const std::string &path, uint32_t sampleEvery, uint64_t maxBytes, std::string &error) {
+    std::lock_guard<std::mutex> control(controlMutex);
+    if (session) {
+        error = "Capture already running";
+        return false;
+    }
+
+    std::unique_ptr<CaptureSession> capture(new CaptureSession());
+    capture->file = fopen(path.c_str(), "wb");
+    if (!capture->file) {
+        error = "Cannot create " + path;
+        return false;
+    }
+
+    std::string header("BKCAPTR1");
+    AppendValue<uint32_t>(header, kVersion);
+    AppendValue<uint32_t>(header, 0);
+    WriteBytes(*capture, header);
+    if (!capture->error.empty()) {
+        fclose(capture->file);
+        error = capture->error;
+        return false;
+    }
+
+    capture->origin = std::chrono::steady_clock::now();
+    capture->maxBytes = maxBytes;
+    capture->reservedBytes = capture->writtenBytes;
+    capture->writer = std::thread(WriterLoop, capture.get());
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        session = std::move(capture);
+    }
+    sampleCounter.store(0, std::memory_order_relaxed);
+    sampleInterval.store(sampleEvery > 0 ? sampleEvery : 1, std::memory_order_relaxed);
+    droppedFrames.store(0, std::memory_order_relaxed);
+    active.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+bool FrameCapture::Sample() {
+    if (!Active()) {
+        return false;
+    }
+    return sampleCounter.fetch_add(1, std::memory_order_relaxed) % sampleInterval.load(std::memory_order_relaxed) == 0;
+}
+
+void FrameCapture::Record(CapturedFrame &&frame) {
+    uint64_t bytes = FrameBytes(frame);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (!session || session->stopping) {
+            return; // Sampled just before the capture stopped
+        }
+        bool writerBehind = session->queuedBytes + bytes > kMaxQueuedBytes;
+        bool full = session->maxBytes > 0 && session->reservedBytes + bytes > session->maxBytes;
+        if (writerBehind || full) {
+            droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        session->queuedBytes += bytes;
+        session->reservedBytes += bytes;
+        MemoryAccount::Add(MemoryCategory::Capture, static_cast<int64_t>(bytes));
+        session->queue.push_back(std::move(frame));
+    }
+    queueChanged.notify_one();
+}
+
+CaptureSummary FrameCapture::Stop() {
+    std::lock_guard<std::mutex> control(controlMutex);
+    CaptureSummary summary;
+    if (!session) {
+        return summary;
+    }
+
+    active.store(false, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        session->stopping = true;
+    }
+    queueChanged.notify_all();
+    session->writer.join();
+
+    CaptureSession &capture = *session;
+    uint64_t indexOffset = capture.writtenBytes;
+    std::string index("BKCAPIDX");
+    AppendValue<uint32_t>(index, static_cast<uint32_t>(capture.offsets.size()));
+    AppendValue<uint32_t>(index, 0);
+    for (uint64_t offset : capture.offsets) {
+        AppendValue<uint64_t>(index, offset);
+    }
+    AppendValue<uint64_t>(index, indexOffset);
+    index += "BKCAPEND";
+    WriteBytes(capture, index);
+    if (fclose(capture.file) != 0 && capture.error.empty()) {
+        capture.error = "Closing capture file failed";
+    }
+
+    summary.frames = capture.offsets.size();
+    summary.dropped = droppedFrames.load(std::memory_order_relaxed);
+    summary.bytes = capture.writtenBytes;
+    summary.error = capture.error;
+
+    std::lock_guard<std::mutex> lock(queueMutex);
+    session.reset();
+    return summary;
+}
+
+uint64_t FrameCapture::Fingerprint(const std::string &settings) {
+    // FNV-1a, stable across platforms and releases unlike std::hash
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : settings) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash;
+}
+
+}
@@ -0,0 +1,111 @@
+#ifndef FrameCapture_hpp
+#define FrameCapture_hpp
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace BKNode {
+
+/**
+ * @brief Pixel layouts a captured frame can have.
+ */
+enum class FrameFormat {
+    Gray8 = 0 /**< One byte per pixel, rows without padding. */
+};
+
+/**
+ * @brief One sampled decode request with everything needed to replay it.
+ */
+struct CapturedFrame {
+    std::chrono::steady_clock::time_point received; /**< When the request reached the addon. */
+    bool async = false;                /**< Decoded by decodeImageAsync rather than decodeImage. */
+    int width = 0;
+    int height = 0;
+    FrameFormat format = FrameFormat::Gray8;
+    std::vector<uint8_t> pixels;
+    std::string settings;              /**< JSON of every setting that affects the decode. */
+    std::string result;                /**< JSON string returned to JavaScript. */
+    uint64_t queueNs = 0;              /**< Time waiting for a pool worker, 0 for synchronous decodes. */
+    uint64_t decodeNs = 0;
+    uint64_t totalNs = 0;
+};
+
+/**
+ * @brief Totals of a capture session.
+ */
+struct CaptureSummary {
+    uint64_t frames = 0;   /**< Frames written to the file. */
+    uint64_t dropped = 0;  /**< Sampled frames discarded because the writer fell behind or the size limit was reached. */
+    uint64_t bytes = 0;    /**< File size. */
+    std::string error;     /**< First write error, empty when none. */
+};
+
+/**
+ * @brief Records sampled decode requests to an indexed capture file for later replay.
+ *
+ * Frames are handed to a background thread that writes them, so decode
+ * threads only pay for copying the pixels. When the writer falls more than
+ * a bounded number of bytes behind, new frames are dropped instead of
+ * queued. When capture is off, sampling costs one relaxed load.
+ *
+ * The file is little-endian:
+ *   header  "BKCAPTR1", u32 version, u32 reserved
+ *   frame   u32 size of the rest of the frame, u64 timestamp ns since the capture started,
+ *           u64 settings fingerprint, u32 width, u32 height, u32 format, u32 flags (1 = async),
+ *           u64 queue ns, u64 decode ns, u64 total ns, u32 settings length, u32 result length,
+ *           u32 pixels length, settings, result, pixels
+ *   index   "BKCAPIDX", u32 frame count, u32 reserved, u64 offset of every frame
+ *   footer  u64 index offset, "BKCAPEND"
+ * The index and footer are written by Stop. Files without them, such as
+ * those of a crashed process, can still be read frame by frame.
+ */
+class FrameCapture {
+public:
+    static const uint32_t kVersion = 1;
+
+    /**
+     * @brief Checks whether frames are being captured.
+     */
+    static bool Active() { return active.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Creates the capture file and starts sampling.
+     * @param path File to write, replaced if it exists.
+     * @param sampleEvery Capture one of every this many decode requests.
+     * @param maxBytes File size after which frames are dropped, 0 for no limit.
+     * @param error Receives the reason when the capture cannot start.
+     * @return False when a capture is already running or the file cannot be created.
+     */
+    static bool Start(const std::string &path, uint32_t sampleEvery, uint64_t maxBytes, std::string &error);
+
+    /**
+     * @brief Decides whether the current request is captured.
+     */
+    static bool Sample();
+
+    /**
+     * @brief Queues a sampled frame for writing.
+     */
+    static void Record(CapturedFrame &&frame);
+
+    /**
+     * @brief Writes the queued frames and the index, and closes the file.
+     * @return Totals of the session. All zero when no capture was running.
+     */
+    static CaptureSummary Stop();
+
+    /**
+     * @brief Gets the fingerprint of a settings JSON string, stored with every frame.
+     */
+    static uint64_t Fingerprint(const std::string &settings);
+
+private:
+    static std::atomic<bool> active;
+};
+
+}
+
+#endif /* FrameCapture_hpp */
@@ -0,0 +1,111 @@
+#include "ImageOps.hpp"
+#include <algorithm>
+#include <cstring>
+#include "Tracer.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace BKNode {
+
+bool ImageRect::Intersects(const ImageRect &other) const {
+    return left < other.Right() && other.left < Right() && top < other.Bottom() && other.top < Bottom();
+}
+
+ImageRect ImageRect::United(const ImageRect &other) const {
+    ImageRect result;
+    result.left = std::min(left, other.left);
+    result.top = std::min(top, other.top);
+    result.width = std::max(Right(), other.Right()) - result.left;
+    result.height = std::max(Bottom(), other.Bottom()) - result.top;
+    return result;
+}
+
+ImageRect ImageRect::Clamped(int imageWidth, int imageHeight) const {
+    ImageRect result;
+    result.left = std::max(0, std::min(left, imageWidth));
+    result.top = std::max(0, std::min(top, imageHeight));
+    result.width = std::max(0, std::min(Right(), imageWidth) - result.left);
+    result.height = std::max(0, std::min(Bottom(), imageHeight) - result.top);
+    return result;
+}
+
+/**
+ * Average each 2x2 block of two source rows into one destination row
+ */
+static void HalveRows(const uint8_t *row0, const uint8_t *row1, uint8_t *dst, int outWidth) {
+    int x = 0;
+
+#if defined(__SSE2__)
+    const __m128i lowBytes = _mm_set1_epi16(0x00FF);
+    const __m128i rounding = _mm_set1_epi16(2);
+    for (; x + 16 <= outWidth; x += 16) {
+        __m128i sums[2];
+        for (int half = 0; half < 2; half++) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + 2 * x + 16 * half));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + 2 * x + 16 * half));
+            __m128i sum = _mm_add_epi16(_mm_and_si128(a, lowBytes), _mm_srli_epi16(a, 8));
+            sum = _mm_add_epi16(sum, _mm_add_epi16(_mm_and_si128(b, lowBytes), _mm_srli_epi16(b, 8)));
+            sums[half] = _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x), _mm_packus_epi16(sums[0], sums[1]));
+    }
+#elif defined(__ARM_NEON)
+    for (; x + 8 <= outWidth; x += 8) {
+        uint16x8_t sum = vaddq_u16(vpaddlq_u8(vld1q_u8(row0 + 2 * x)), vpaddlq_u8(vld1q_u8(row1 + 2 * x)));
+        vst1_u8(dst + x, vrshrn_n_u16(sum, 2));
+    }
+#endif
+
+    for (; x < outWidth; x++) {
+        int sum = row0[2 * x] + row0[2 * x + 1] + row1[2 * x] + row1[2 * x + 1];
+        dst[x] = static_cast<uint8_t>((sum + 2) >> 2);
+    }
+}
+
+/**
+ * Halve a grayscale image, dropping an odd last row or column
+ */
+static std::vector<uint8_t> Halve(const uint8_t *pixels, int width, int height, int &outWidth, int &outHeight) {
+    outWidth = width / 2;
+    outHeight = height / 2;
+    std::vector<uint8_t> result(static_cast<size_t>(outWidth) * outHeight);
+
+    for (int y = 0; y < outHeight; y++) {
+        const uint8_t *row0 = pixels + static_cast<size_t>(2 * y) * width;
+        HalveRows(row0, row0 + width, result.data() + static_cast<size_t>(y) * outWidth, outWidth);
+    }
+
+    return result;
+}
+
+std::vector<uint8_t> Downscale(const uint8_t *pixels, int width, int height, int factor, int &outWidth, int &outHeight) {
+    TraceSpan span("downscale", "factor", factor);
+    std::vector<uint8_t> result = Halve(pixels, width, height, outWidth, outHeight);
+
+    if (factor == 4) {
+        int halfWidth = outWidth;
+        int halfHeight = outHeight;
+        result = Halve(result.data(), halfWidth, halfHeight, outWidth, outHeight);
+    }
+
+    return result;
+}
+
+std::vector<uint8_t> Crop(const uint8_t *pixels, int width, const ImageRect &rect) {
+    TraceSpan span("crop", "pixels", static_cast<int64_t>(rect.width) * rect.height);
+    std::vector<uint8_t> result(static_cast<size_t>(rect.width) * rect.height);
+
+    for (int y = 0; y < rect.height; y++) {
+        memcpy(result.data() + static_cast<size_t>(y) * rect.width,
+               pixels + static_cast<size_t>(rect.top + y) * width + rect.left,
+               rect.width);
+    }
+
+    return result;
+}
+
+}
@@ -0,0 +1,57 @@
+#ifndef ImageOps_hpp
+#define ImageOps_hpp
+
+#include <stdint.h>
+#include <vector>
+
+namespace BKNode {
+
+/**
+ * @brief Axis-aligned pixel rectangle inside an image.
+ */
+struct ImageRect {
+    int left = 0;
+    int top = 0;
+    int width = 0;
+    int height = 0;
+
+    int Right() const { return left + width; }
+    int Bottom() const { return top + height; }
+    bool Empty() const { return width <= 0 || height <= 0; }
+    bool Intersects(const ImageRect &other) const;
+
+    /**
+     * @brief Smallest rectangle containing both rectangles.
+     */
+    ImageRect United(const ImageRect &other) const;
+
+    /**
+     * @brief Rectangle clipped to an image of the given size.
+     */
+    ImageRect Clamped(int imageWidth, int imageHeight) const;
+};
+
+/**
+ * @brief Shrinks a grayscale image with a rounded box filter.
+ * @param pixels Pointer to the grayscale image pixels.
+ * @param width Width of the image.
+ * @param height Height of the image.
+ * @param factor Shrink factor, 2 or 4.
+ * @param outWidth Receives the width of the result.
+ * @param outHeight Receives the height of the result.
+ * @return The downscaled pixels, outWidth * outHeight bytes.
+ */
+std::vector<uint8_t> Downscale(const uint8_t *pixels, int width, int height, int factor, int &outWidth, int &outHeight);
+
+/**
+ * @brief Copies a rectangle of a grayscale image into a contiguous buffer.
+ * @param pixels Pointer to the grayscale image pixels.
+ * @param width Width (and row stride) of the image.
+ * @param rect Rectangle to copy, must lie inside the image.
+ * @return rect.width * rect.height bytes.
+ */
+std::vector<uint8_t> Crop(const uint8_t *pixels, int width, const ImageRect &rect);
+
+}
+
+#endif /* ImageOps_hpp */
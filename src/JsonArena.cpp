@@ -0,0 +1,125 @@
+#include "JsonArena.hpp"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "MemoryAccount.hpp"
+#include "json/cJSON.h"
+
+namespace BKNode {
+
+static const size_t kInitialBlockBytes = 64 * 1024;
+static const size_t kAlignment = 16;
+
+/**
+ * Memory of one thread. Blocks outgrown during a scope are freed when it
+ * closes; the current block, always the largest, is kept for the next one.
+ */
+struct ThreadArena {
+    struct Block {
+        char *data;
+        size_t capacity;
+    };
+
+    Block current = { nullptr, 0 };
+    size_t used = 0;
+    std::vector<Block> retired;
+    int depth = 0;
+
+    ~ThreadArena() {
+        Reset();
+        free(current.data);
+        MemoryAccount::Add(MemoryCategory::ResultBuffers, -static_cast<int64_t>(current.capacity));
+    }
+
+    void *Allocate(size_t size) {
+        size = (size + kAlignment - 1) & ~(kAlignment - 1);
+        if (used + size > current.capacity && !Grow(size)) {
+            return nullptr;
+        }
+        void *pointer = current.data + used;
+        used += size;
+        return pointer;
+    }
+
+    bool Grow(size_t size) {
+        size_t capacity = std::max(std::max(kInitialBlockBytes, current.capacity * 2), size);
+        char *data = static_cast<char *>(malloc(capacity));
+        if (!data) {
+            return false;
+        }
+        if (current.data) {
+            retired.push_back(current);
+        }
+        current = { data, capacity };
+        used = 0;
+        MemoryAccount::Add(MemoryCategory::ResultBuffers, static_cast<int64_t>(capacity));
+        return true;
+    }
+
+    bool Owns(const void *pointer) const {
+        auto inside = [pointer](const Block &block) {
+            uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+            uintptr_t start = reinterpret_cast<uintptr_t>(block.data);
+            return block.data && address >= start && address < start + block.capacity;
+        };
+        if (inside(current)) {
+            return true;
+        }
+        return std::any_of(retired.begin(), retired.end(), inside);
+    }
+
+    void Reset() {
+        for (const Block &block : retired) {
+            free(block.data);
+            MemoryAccount::Add(MemoryCategory::ResultBuffers, -static_cast<int64_t>(block.capacity));
+        }
+        retired.clear();
+        used = 0;
+    }
+};
+
+static thread_local ThreadArena arena;
+
+static void *ArenaMalloc(size_t size) {
+    ThreadArena &local = arena;
+    return local.depth > 0 ? local.Allocate(size) : malloc(size);
+}
+
+static void ArenaFree(void *pointer) {
+    if (pointer && !arena.Owns(pointer)) {
+        free(pointer);
+    }
+}
+
+void JsonArena::Install() {
+    cJSON_Hooks hooks = { ArenaMalloc, ArenaFree };
+    cJSON_InitHooks(&hooks);
+}
+
+void JsonArena::Release(void *pointer) {
+    ArenaFree(pointer);
+}
+
+void JsonArena::Prefault() {
+    ThreadArena &local = arena;
+    // Inside a Scope the block holds live trees
+    if (local.depth > 0 || (!local.current.data && !local.Grow(kInitialBlockBytes))) {
+        return;
+    }
+    memset(local.current.data, 0, local.current.capacity);
+}
+
+JsonArena::Scope::Scope() {
+    arena.depth++;
+}
+
+JsonArena::Scope::~Scope() {
+    ThreadArena &local = arena;
+    if (--local.depth == 0) {
+        local.Reset();
+    }
+}
+
+}
@@ -0,0 +1,51 @@
+#ifndef JsonArena_hpp
+#define JsonArena_hpp
+
+namespace BKNode {
+
+/**
+ * @brief Per-thread bump allocator for cJSON trees.
+ *
+ * Once installed, cJSON allocations made while a Scope is open on the
+ * calling thread are carved from that thread's arena and freeing them does
+ * nothing. Closing the outermost Scope releases everything at once. The
+ * arena keeps its largest block, so after a few calls building and printing
+ * a tree makes no heap calls at all, and worker threads never contend on the
+ * allocator. Outside a Scope cJSON uses malloc and free as before.
+ *
+ * Trees built inside a Scope must be deleted and printed on the same thread
+ * before the Scope closes.
+ */
+class JsonArena {
+public:
+    /**
+     * @brief Routes cJSON allocations through the arena. Call once before any tree is built.
+     */
+    static void Install();
+
+    /**
+     * @brief Frees a string returned by cJSON_Print, whether it came from an arena or from malloc.
+     */
+    static void Release(void *pointer);
+
+    /**
+     * @brief Allocates the calling thread's first block and touches its pages, so the first tree does not page-fault.
+     */
+    static void Prefault();
+
+    /**
+     * @brief Serves cJSON allocations of the calling thread from its arena while open.
+     */
+    class Scope {
+    public:
+        Scope();
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+};
+
+}
+
+#endif /* JsonArena_hpp */
@@ -0,0 +1,71 @@
+#include "MemoryAccount.hpp"
+#include <stddef.h>
+#include <atomic>
+#include "json/cJSON.h"
+
+namespace BKNode {
+
+static const int kCategoryCount = static_cast<int>(MemoryCategory::Count);
+
+static const char *const kCategoryNames[kCategoryCount] = {
+    "pinnedFrames", "conversionScratch", "resultBuffers", "capture", "caches", "tracing"
+};
+
+// Zero-initialized before any constructor runs, so static allocations can be charged safely
+static std::atomic<int64_t> currentBytes[kCategoryCount];
+static std::atomic<int64_t> peakBytes[kCategoryCount];
+
+void MemoryAccount::Add(MemoryCategory category, int64_t bytes) {
+    if (bytes == 0) {
+        return;
+    }
+    int index = static_cast<int>(category);
+    int64_t now = currentBytes[index].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t peak = peakBytes[index].load(std::memory_order_relaxed);
+    while (now > peak && !peakBytes[index].compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+}
+
+const char *MemoryAccount::Name(MemoryCategory category) {
+    return kCategoryNames[static_cast<int>(category)];
+}
+
+int64_t MemoryAccount::Current(MemoryCategory category) {
+    return currentBytes[static_cast<int>(category)].load(std::memory_order_relaxed);
+}
+
+int64_t MemoryAccount::OwnedBytes() {
+    int64_t total = 0;
+    for (int i = 0; i < kCategoryCount; i++) {
+        if (i != static_cast<int>(MemoryCategory::PinnedFrames)) {
+            total += currentBytes[i].load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+cJSON *MemoryAccount::ToJson() {
+    cJSON *root = cJSON_CreateObject();
+    for (int i = 0; i < kCategoryCount; i++) {
+        cJSON *category = cJSON_CreateObject();
+        cJSON_AddNumberToObject(category, "bytes", static_cast<double>(currentBytes[i].load(std::memory_order_relaxed)));
+        cJSON_AddNumberToObject(category, "peakBytes", static_cast<double>(peakBytes[i].load(std::memory_order_relaxed)));
+        cJSON_AddItemToObject(root, kCategoryNames[i], category);
+    }
+    return root;
+}
+
+MemoryCharge::MemoryCharge(MemoryCategory category, int64_t bytes) : category(category), bytes(bytes) {
+    MemoryAccount::Add(category, bytes);
+}
+
+MemoryCharge::~MemoryCharge() {
+    MemoryAccount::Add(category, -bytes);
+}
+
+void MemoryCharge::Set(int64_t bytes) {
+    MemoryAccount::Add(category, bytes - this->bytes);
+    this->bytes = bytes;
+}
+
+}
@@ -0,0 +1,88 @@
+#ifndef MemoryAccount_hpp
+#define MemoryAccount_hpp
+
+#include <stdint.h>
+
+struct cJSON;
+
+namespace BKNode {
+
+/**
+ * @brief What native memory held by the wrapper is used for.
+ */
+enum class MemoryCategory {
+    PinnedFrames = 0,   /**< Image buffers kept alive by queued decodes. V8 already counts these. */
+    ConversionScratch,  /**< Downscaled copies, crops and synthetic warm-up images. */
+    ResultBuffers,      /**< JSON arena blocks and result strings waiting to be handed back. */
+    Capture,            /**< Frames queued for the capture writer. */
+    Caches,             /**< Config copies kept per decoding speed. */
+    Tracing,            /**< Trace event rings. */
+    Count
+};
+
+/**
+ * @brief Process-wide byte counts of native memory owned by the wrapper.
+ *
+ * Any thread may charge and release bytes; each category is one relaxed
+ * atomic, so accounting stays cheap on the decode path. The JavaScript
+ * thread hands the owned total to V8 with napi_adjust_external_memory at
+ * its own call sites. Memory inside the SDK is not visible here, and config
+ * copies are counted by their shallow size.
+ */
+class MemoryAccount {
+public:
+    /**
+     * @brief Charges bytes to a category, or releases them when negative.
+     */
+    static void Add(MemoryCategory category, int64_t bytes);
+
+    /**
+     * @brief Name of a category as it appears in JSON and metrics labels.
+     */
+    static const char *Name(MemoryCategory category);
+
+    /**
+     * @brief Bytes currently charged to a category.
+     */
+    static int64_t Current(MemoryCategory category);
+
+    /**
+     * @brief Bytes the wrapper allocated itself, i.e. every category except those V8 already counts.
+     */
+    static int64_t OwnedBytes();
+
+    /**
+     * @brief Converts the current and peak bytes of each category to JSON. The caller deletes the tree.
+     */
+    static cJSON *ToJson();
+};
+
+/**
+ * @brief Bytes charged to a category for the lifetime of this object.
+ */
+class MemoryCharge {
+public:
+    explicit MemoryCharge(MemoryCategory category, int64_t bytes = 0);
+    ~MemoryCharge();
+
+    /**
+     * @brief Replaces the charged amount, e.g. with 0 once the memory is freed early.
+     */
+    void Set(int64_t bytes);
+
+    /**
+     * @brief Bytes currently charged.
+     */
+    int64_t Bytes() const { return bytes; }
+
+    MemoryCharge(const MemoryCharge &) = delete;
+    MemoryCharge &operator=(const MemoryCharge &) = delete;
+
+private:
+    MemoryCategory category;
+    int64_t bytes;
+};
+
+}
+
+#endif /* MemoryAccount_hpp */
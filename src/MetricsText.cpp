@@ -0,0 +1,52 @@
+#include "MetricsText.hpp"
+#include <cmath>
+#include <stdio.h>
+
+namespace BKNode {
+
+void MetricsText::Begin() {
+    text.clear();
+}
+
+void MetricsText::Family(const char *name, const char *type, const char *help) {
+    text.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+    text.append("# HELP ").append(name).append(" ").append(help).append("\n");
+}
+
+void MetricsText::SampleName(const char *name, const char *labels) {
+    text.append(name);
+    if (labels && *labels) {
+        text.append("{").append(labels).append("}");
+    }
+    text.append(" ");
+}
+
+void MetricsText::Sample(const char *name, const char *labels, double value) {
+    SampleName(name, labels);
+
+    char number[32];
+    if (std::isinf(value)) {
+        text.append(value > 0 ? "+Inf" : "-Inf");
+    } else if (std::isnan(value)) {
+        text.append("NaN");
+    } else {
+        int length = snprintf(number, sizeof(number), "%.9g", value);
+        text.append(number, length);
+    }
+    text.append("\n");
+}
+
+void MetricsText::Sample(const char *name, const char *labels, uint64_t value) {
+    SampleName(name, labels);
+
+    char number[24];
+    int length = snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(value));
+    text.append(number, length).append("\n");
+}
+
+const std::string &MetricsText::End() {
+    text.append("# EOF\n");
+    return text;
+}
+
+}
@@ -0,0 +1,53 @@
+#ifndef MetricsText_hpp
+#define MetricsText_hpp
+
+#include <stdint.h>
+#include <string>
+
+namespace BKNode {
+
+/**
+ * @brief Writes metrics in the OpenMetrics text format into a reused buffer.
+ *
+ * The buffer keeps its capacity between scrapes, so rendering allocates
+ * nothing once it has grown to the size of a full payload.
+ */
+class MetricsText {
+public:
+    /**
+     * @brief Clears the text, keeping the buffer.
+     */
+    void Begin();
+
+    /**
+     * @brief Starts a metric family.
+     * @param name Family name, without the _total suffix for counters.
+     * @param type counter, gauge or histogram.
+     * @param help One line description.
+     */
+    void Family(const char *name, const char *type, const char *help);
+
+    /**
+     * @brief Writes one sample.
+     * @param name Sample name, including any _total, _bucket, _count or _sum suffix.
+     * @param labels Label pairs without braces, e.g. stage="decode", or nullptr.
+     * @param value The value.
+     */
+    void Sample(const char *name, const char *labels, double value);
+    void Sample(const char *name, const char *labels, uint64_t value);
+
+    /**
+     * @brief Terminates the exposition with # EOF.
+     * @return The complete text, valid until the next Begin.
+     */
+    const std::string &End();
+
+private:
+    void SampleName(const char *name, const char *labels);
+
+    std::string text;
+};
+
+}
+
+#endif /* MetricsText_hpp */
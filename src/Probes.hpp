@@ -0,0 +1,44 @@
+#ifndef Probes_hpp
+#define Probes_hpp
+
+/**
+ * USDT (SystemTap SDT) probes in the "barkoder" provider, for attaching
+ * bpftrace or perf to a running process:
+ *
+ *   decode_start(width, height, speed)
+ *   decode_done(width, height, speed, resultCount, ns)
+ *   queue_enqueue(job, pending)
+ *   queue_dequeue(job, waitNs)
+ *
+ * A disabled probe is a single nop, but its arguments are still evaluated
+ * at the call site on every pass, attached or not. Only pass values that
+ * are already computed or cost a subtraction; anything costlier needs an
+ * sdt semaphore guard. Probes are compiled in when <sys/sdt.h> is available
+ * (systemtap-sdt-dev / systemtap-sdt-devel) and compile to nothing otherwise.
+ * Define BARKODER_DISABLE_USDT to leave them out.
+ */
+
+#if !defined(BARKODER_DISABLE_USDT) && defined(__linux__) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define BARKODER_USDT 1
+#endif
+#endif
+
+#ifdef BARKODER_USDT
+#define BK_PROBE_DECODE_START(width, height, speed) \
+    DTRACE_PROBE3(barkoder, decode_start, width, height, speed)
+#define BK_PROBE_DECODE_DONE(width, height, speed, resultCount, ns) \
+    DTRACE_PROBE5(barkoder, decode_done, width, height, speed, resultCount, ns)
+#define BK_PROBE_QUEUE_ENQUEUE(job, pending) \
+    DTRACE_PROBE2(barkoder, queue_enqueue, job, pending)
+#define BK_PROBE_QUEUE_DEQUEUE(job, waitNs) \
+    DTRACE_PROBE2(barkoder, queue_dequeue, job, waitNs)
+#else
+#define BK_PROBE_DECODE_START(width, height, speed) do {} while (0)
+#define BK_PROBE_DECODE_DONE(width, height, speed, resultCount, ns) do {} while (0)
+#define BK_PROBE_QUEUE_ENQUEUE(job, pending) do {} while (0)
+#define BK_PROBE_QUEUE_DEQUEUE(job, waitNs) do {} while (0)
+#endif
+
+#endif /* Probes_hpp */
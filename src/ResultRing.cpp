@@ -0,0 +1,170 @@
+#include "ResultRing.hpp"
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include "BarkoderClasses.hpp"
+
+namespace BKNode {
+
+static_assert(sizeof(std::atomic<int32_t>) == sizeof(int32_t) && ATOMIC_INT_LOCK_FREE == 2,
+              "Shared counters need lock-free 32-bit atomics");
+
+// Header fields, as 32-bit indices
+enum HeaderField { kMagicField = 0, kVersionField, kSlotsField, kSlotBytesField, kMaxResultsField, kTextBytesField, kPublishedField };
+
+// Record fields, as 32-bit indices from the start of the slot
+enum RecordField {
+    kStampField = 0, kFrameIdField, kStatusField, kFoundField, kStoredField, kWidthField, kHeightField, kSpeedField, kFlagsField
+};
+static const size_t kTimesOffset = 40;
+
+// Writers hold the mutex for the whole record, so records are published in sequence order
+static std::mutex ringMutex;
+static uint8_t *ringMemory = nullptr;
+static RingLayout ringLayout;
+static std::chrono::steady_clock::time_point ringOrigin;
+static uint32_t ringSequence = 0;
+static uint32_t ringSlot = 0; // Slot of ringSequence, advanced one at a time so it stays consecutive when the sequence wraps
+
+size_t RingLayout::SlotBytes() const {
+    size_t bytes = ResultRing::kRecordHeaderBytes + static_cast<size_t>(maxResults) * ResultRing::kResultBytes + textBytes;
+    return (bytes + 7) & ~static_cast<size_t>(7);
+}
+
+size_t RingLayout::TotalBytes() const {
+    return ResultRing::kHeaderBytes + static_cast<size_t>(slots) * SlotBytes();
+}
+
+static std::atomic<int32_t> *SharedField(uint8_t *base, size_t index) {
+    return reinterpret_cast<std::atomic<int32_t> *>(base + index * sizeof(int32_t));
+}
+
+static void WriteInt(uint8_t *base, size_t index, int32_t value) {
+    memcpy(base + index * sizeof(int32_t), &value, sizeof(value));
+}
+
+/**
+ * Stamp of a complete record: sequence + 1, skipping 0, which marks a record being written
+ */
+static int32_t StampOf(uint32_t sequence) {
+    uint32_t stamp = sequence + 1;
+    return static_cast<int32_t>(stamp == 0 ? 1 : stamp);
+}
+
+/**
+ * Bytes of text that fit in limit without splitting a UTF-8 character
+ */
+static size_t Utf8Prefix(const std::string &text, size_t limit) {
+    if (limit >= text.size()) {
+        return text.size();
+    }
+    size_t length = limit;
+    while (length > 0 && (static_cast<uint8_t>(text[length]) & 0xC0) == 0x80) {
+        length--;
+    }
+    return length;
+}
+
+bool ResultRing::Attach(uint8_t *memory, size_t length, const RingLayout &layout, std::string &error) {
+    if (reinterpret_cast<uintptr_t>(memory) % 8 != 0) {
+        error = "Ring memory must be 8-byte aligned";
+        return false;
+    }
+    if (layout.slots < 2 || layout.maxResults < 1) {
+        error = "Ring needs at least 2 slots and 1 result per record";
+        return false;
+    }
+    if (layout.TotalBytes() > length || layout.SlotBytes() > INT32_MAX) {
+        error = "Ring memory too small, " + std::to_string(layout.TotalBytes()) + " bytes needed";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(ringMutex);
+    memset(memory, 0, layout.TotalBytes());
+    WriteInt(memory, kMagicField, kMagic);
+    WriteInt(memory, kVersionField, kVersion);
+    WriteInt(memory, kSlotsField, static_cast<int32_t>(layout.slots));
+    WriteInt(memory, kSlotBytesField, static_cast<int32_t>(layout.SlotBytes()));
+    WriteInt(memory, kMaxResultsField, static_cast<int32_t>(layout.maxResults));
+    WriteInt(memory, kTextBytesField, static_cast<int32_t>(layout.textBytes));
+    ringMemory = memory;
+    ringLayout = layout;
+    ringOrigin = std::chrono::steady_clock::now();
+    ringSequence = 0;
+    ringSlot = 0;
+    return true;
+}
+
+void ResultRing::Detach() {
+    std::lock_guard<std::mutex> lock(ringMutex);
+    ringMemory = nullptr;
+}
+
+bool ResultRing::Attached() {
+    std::lock_guard<std::mutex> lock(ringMutex);
+    return ringMemory != nullptr;
+}
+
+int64_t ResultRing::Publish(const RingRecord &record) {
+    std::lock_guard<std::mutex> lock(ringMutex);
+    if (!ringMemory) {
+        return -1;
+    }
+
+    uint32_t sequence = ringSequence++;
+    uint8_t *slot = ringMemory + kHeaderBytes + static_cast<size_t>(ringSlot) * ringLayout.SlotBytes();
+    ringSlot = ringSlot + 1 == ringLayout.slots ? 0 : ringSlot + 1;
+    std::atomic<int32_t> *stamp = SharedField(slot, kStampField);
+    stamp->store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    int32_t found = record.results ? static_cast<int32_t>(record.results->size()) : 0;
+    int32_t stored = std::min<int32_t>(found, static_cast<int32_t>(ringLayout.maxResults));
+    int32_t flags = record.flags | (stored < found ? kFlagResultsDropped : 0);
+    uint8_t *text = slot + kRecordHeaderBytes + static_cast<size_t>(ringLayout.maxResults) * kResultBytes;
+    uint32_t textUsed = 0;
+
+    for (int32_t i = 0; i < stored; i++) {
+        const BaseResult &result = (*record.results)[i];
+        uint8_t *entry = slot + kRecordHeaderBytes + static_cast<size_t>(i) * kResultBytes;
+        uint32_t textLength = static_cast<uint32_t>(Utf8Prefix(result.textualData, ringLayout.textBytes - textUsed));
+        if (textLength < result.textualData.size()) {
+            flags |= kFlagTextTruncated;
+        }
+        memcpy(text + textUsed, result.textualData.data(), textLength);
+
+        WriteInt(entry, 0, static_cast<int32_t>(result.barcodeType));
+        WriteInt(entry, 1, static_cast<int32_t>(textUsed));
+        WriteInt(entry, 2, static_cast<int32_t>(textLength));
+        WriteInt(entry, 3, 0);
+        float corners[8];
+        for (int corner = 0; corner < 4; corner++) {
+            corners[corner * 2] = result.location[corner].x;
+            corners[corner * 2 + 1] = result.location[corner].y;
+        }
+        memcpy(entry + 16, corners, sizeof(corners));
+        textUsed += textLength;
+    }
+
+    WriteInt(slot, kFrameIdField, record.frameId);
+    WriteInt(slot, kStatusField, record.status);
+    WriteInt(slot, kFoundField, found);
+    WriteInt(slot, kStoredField, stored);
+    WriteInt(slot, kWidthField, record.width);
+    WriteInt(slot, kHeightField, record.height);
+    WriteInt(slot, kSpeedField, record.decodingSpeed);
+    WriteInt(slot, kFlagsField, flags);
+    double times[3] = {
+        std::chrono::duration<double, std::milli>(record.received - ringOrigin).count(),
+        record.decodeNs / 1e6,
+        record.totalNs / 1e6
+    };
+    memcpy(slot + kTimesOffset, times, sizeof(times));
+
+    stamp->store(StampOf(sequence), std::memory_order_release);
+    SharedField(ringMemory, kPublishedField)->store(static_cast<int32_t>(sequence + 1), std::memory_order_release);
+    return sequence;
+}
+
+}
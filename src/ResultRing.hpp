@@ -0,0 +1,113 @@
+#ifndef ResultRing_hpp
+#define ResultRing_hpp
+
+#include <stdint.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+class BaseResult;
+
+namespace BKNode {
+
+/**
+ * @brief Sizes of a result ring, chosen by the caller.
+ */
+struct RingLayout {
+    uint32_t slots = 64;        /**< Records kept before the oldest is overwritten. */
+    uint32_t maxResults = 16;   /**< Barcodes stored per record, later ones are counted but dropped. */
+    uint32_t textBytes = 4096;  /**< UTF-8 text stored per record, shared by its barcodes. */
+
+    /**
+     * @brief Bytes of one record, a multiple of 8.
+     */
+    size_t SlotBytes() const;
+
+    /**
+     * @brief Bytes of the whole ring, header included.
+     */
+    size_t TotalBytes() const;
+};
+
+/**
+ * @brief One finished decode, as published to the ring.
+ */
+struct RingRecord {
+    int32_t frameId = 0;    /**< Caller's tag for the frame. */
+    int32_t status = 0;     /**< StatusCode of the decode. */
+    int width = 0;
+    int height = 0;
+    int decodingSpeed = 0;
+    int32_t flags = 0;      /**< Extra record flags, e.g. kFlagDeadlineExceeded. */
+    const std::vector<BaseResult> *results = nullptr;
+    std::chrono::steady_clock::time_point received;
+    uint64_t decodeNs = 0;
+    uint64_t totalNs = 0;
+};
+
+/**
+ * @brief Fixed-layout decode results written into memory shared with JavaScript.
+ *
+ * The caller allocates a SharedArrayBuffer and attaches it. Each finished
+ * decode then writes one record into the next slot and bumps a published
+ * counter, so reading results creates no JavaScript objects. Writers are
+ * serialized. A reader that falls more than slots - 1 records behind loses
+ * the overwritten ones, which it can detect through the per-record stamp.
+ *
+ * The memory is little-endian, offsets in bytes:
+ *   header   i32 magic "BKRR", i32 version, i32 slots, i32 slot bytes, i32 max results,
+ *            i32 text bytes, i32 published (records written, modulo 2^32), i32 reserved, padded to 64 bytes
+ *   record   in slot 0, 1, ..., slots - 1, 0, ... in sequence order, at 64 + slot * slot bytes
+ *            (the slot is sequence % slots until the 32-bit sequence wraps, then it carries on from there):
+ *            i32 stamp (sequence + 1 modulo 2^32 once complete, 1 instead of 0, 0 while written), i32 frame id, i32 status,
+ *            i32 results found, i32 results stored, i32 width, i32 height, i32 decoding speed,
+ *            i32 flags (1 = results dropped, 2 = text truncated, 4 = deadline exceeded), i32 reserved,
+ *            f64 received ms since attach, f64 decode ms, f64 total ms,
+ *            then per stored result at 64 + i * 48: i32 barcode type, i32 text offset,
+ *            i32 text length, i32 reserved, f32 x0 y0 x1 y1 x2 y2 x3 y3,
+ *            then the text area at 64 + max results * 48
+ * The stamp and the published counter are written with release ordering
+ * after the rest of the record.
+ */
+class ResultRing {
+public:
+    static const int32_t kMagic = 0x52524B42;
+    static const int32_t kVersion = 1;
+    static const size_t kHeaderBytes = 64;
+    static const size_t kRecordHeaderBytes = 64;
+    static const size_t kResultBytes = 48;
+
+    static const int32_t kFlagResultsDropped = 1;
+    static const int32_t kFlagTextTruncated = 2;
+    static const int32_t kFlagDeadlineExceeded = 4;
+
+    /**
+     * @brief Starts publishing into caller memory, replacing any attached ring.
+     * @param memory Start of the ring, 8-byte aligned, kept alive by the caller until Detach.
+     * @param length Bytes available at memory.
+     * @param layout Sizes of the ring.
+     * @param error Receives the reason when the memory cannot hold the layout.
+     * @return False when the memory is misaligned or too small.
+     */
+    static bool Attach(uint8_t *memory, size_t length, const RingLayout &layout, std::string &error);
+
+    /**
+     * @brief Stops publishing. Returns once no writer uses the memory any more.
+     */
+    static void Detach();
+
+    /**
+     * @brief Checks whether a ring is attached.
+     */
+    static bool Attached();
+
+    /**
+     * @brief Writes one record and publishes it. Thread-safe.
+     * @return Sequence number of the record, -1 when no ring is attached.
+     */
+    static int64_t Publish(const RingRecord &record);
+};
+
+}
+
+#endif /* ResultRing_hpp */
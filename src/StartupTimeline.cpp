@@ -0,0 +1,55 @@
+#include "StartupTimeline.hpp"
+#include <atomic>
+#include "json/cJSON.h"
+
+namespace BKNode {
+
+static const int kEventCount = static_cast<int>(StartupEvent::Count);
+
+static const char *const kEventNames[kEventCount] = {
+    "moduleLoaded", "exportsStart", "exportsDone", "licenseStart", "licenseDone",
+    "optionsDone", "warmupStart", "warmupDone", "firstDecodeStart", "firstDecodeDone"
+};
+
+// Nanoseconds of the steady clock, 0 until reached. Zero-initialized before any constructor runs.
+static std::atomic<int64_t> timestamps[kEventCount];
+
+static int64_t Ticks(StartupTimeline::Clock::time_point when) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(when.time_since_epoch()).count();
+}
+
+void StartupTimeline::Mark(StartupEvent event, Clock::time_point when) {
+    int64_t expected = 0;
+    timestamps[static_cast<int>(event)].compare_exchange_strong(expected, Ticks(when), std::memory_order_relaxed);
+}
+
+void StartupTimeline::FirstDecode(Clock::time_point received, Clock::time_point completed) {
+    std::atomic<int64_t> &done = timestamps[static_cast<int>(StartupEvent::FirstDecodeDone)];
+    if (done.load(std::memory_order_relaxed) != 0) {
+        return;
+    }
+    int64_t expected = 0;
+    // The start is stored second, so it always belongs to the decode that won
+    if (done.compare_exchange_strong(expected, Ticks(completed), std::memory_order_relaxed)) {
+        timestamps[static_cast<int>(StartupEvent::FirstDecodeStart)].store(Ticks(received), std::memory_order_relaxed);
+    }
+}
+
+cJSON *StartupTimeline::ToJson() {
+    int64_t now = Ticks(Clock::now());
+    cJSON *root = cJSON_CreateObject();
+    for (int i = 0; i < kEventCount; i++) {
+        int64_t ticks = timestamps[i].load(std::memory_order_relaxed);
+        if (ticks == 0) {
+            cJSON_AddNullToObject(root, kEventNames[i]);
+        } else {
+            cJSON_AddNumberToObject(root, kEventNames[i], (now - ticks) / 1e6);
+        }
+    }
+    return root;
+}
+
+// Runs while the dynamic loader initializes the addon, before Init is called
+static const bool moduleLoaded = (StartupTimeline::Mark(StartupEvent::ModuleLoaded), true);
+
+}
@@ -0,0 +1,62 @@
+#ifndef StartupTimeline_hpp
+#define StartupTimeline_hpp
+
+#include <stdint.h>
+#include <chrono>
+
+struct cJSON;
+
+namespace BKNode {
+
+/**
+ * @brief Startup milestones, in the order they normally happen.
+ */
+enum class StartupEvent {
+    ModuleLoaded = 0,   /**< Static initializers of the addon ran, i.e. the library is mapped and relocated. */
+    ExportsStart,
+    ExportsDone,
+    LicenseStart,
+    LicenseDone,
+    OptionsDone,        /**< Default settings applied after the license check. */
+    WarmupStart,
+    WarmupDone,
+    FirstDecodeStart,   /**< Arrival of the first decode that completed. */
+    FirstDecodeDone,
+    Count
+};
+
+/**
+ * @brief Monotonic timestamps of the first occurrence of each startup milestone.
+ *
+ * Each milestone is recorded once, by whichever thread reaches it first, so
+ * a later re-initialization or warm-up does not move it. Recording is a
+ * single compare-and-swap, cheap enough to stay on the decode path.
+ */
+class StartupTimeline {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * @brief Records a milestone unless it already happened.
+     */
+    static void Mark(StartupEvent event, Clock::time_point when = Clock::now());
+
+    /**
+     * @brief Records the first completed decode.
+     * @param received When the request arrived.
+     * @param completed When its result was handed back.
+     */
+    static void FirstDecode(Clock::time_point received, Clock::time_point completed);
+
+    /**
+     * @brief Converts the milestones to JSON, each as milliseconds before now, null when not reached.
+     *
+     * Relative values let the caller place them on its own monotonic clock.
+     * The caller deletes the tree.
+     */
+    static cJSON *ToJson();
+};
+
+}
+
+#endif /* StartupTimeline_hpp */
@@ -0,0 +1,23 @@
+#ifndef Status_hpp
+#define Status_hpp
+
+namespace BKNode {
+
+/**
+ * @brief Result of a setting call, returned to JavaScript as a number.
+ *
+ * Mirrored by constants.Status in lib/constants.js. Failures keep a message
+ * that JavaScript reads with getLastError() only when it needs one.
+ */
+enum class StatusCode {
+    Ok = 0,
+    NotInitialized = 1,   // initialize() has not succeeded yet
+    InvalidArgument = 2,  // Missing, mistyped or out-of-range argument
+    SdkError = 3,         // The SDK or the addon threw
+    IoError = 4,          // A file could not be opened or written
+    Aborted = 5           // An AbortSignal stopped the decode
+};
+
+}
+
+#endif /* Status_hpp */
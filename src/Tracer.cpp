@@ -0,0 +1,195 @@
+#include "Tracer.hpp"
+#include <stdlib.h>
+#include <mutex>
+#include <vector>
+#include "JsonArena.hpp"
+#include "MemoryAccount.hpp"
+#include "json/cJSON.h"
+
+#ifdef _WIN32
+#include <process.h>
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace BKNode {
+
+std::atomic<bool> Tracer::enabled{false};
+
+/**
+ * One ring slot. The sequence number is zero while the slot is written and
+ * the event's position plus one afterwards, so readers can skip torn slots.
+ */
+struct TraceEvent {
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<const char *> name{nullptr};
+    std::atomic<const char *> argName{nullptr};
+    std::atomic<int64_t> argValue{0};
+    std::atomic<int64_t> startNs{0};
+    std::atomic<int64_t> durationNs{-1}; // -1 marks an instant event
+    std::atomic<uint64_t> threadId{0};
+};
+
+/**
+ * Event storage. A ring replaced by a restart with another capacity is
+ * kept until exit, since a writer may still be filling one of its slots.
+ */
+struct TraceRing {
+    explicit TraceRing(size_t capacity) : events(capacity) {}
+
+    std::vector<TraceEvent> events;
+    std::atomic<uint64_t> next{0};
+};
+
+static std::mutex controlMutex;
+static std::atomic<TraceRing *> currentRing{nullptr};
+static Tracer::Clock::time_point origin = Tracer::Clock::now();
+
+/**
+ * Operating system id of the calling thread, matching what perf and top show
+ */
+static uint64_t CurrentThreadId() {
+    thread_local uint64_t id = 0;
+    if (id == 0) {
+#if defined(__linux__)
+        id = static_cast<uint64_t>(syscall(SYS_gettid));
+#elif defined(__APPLE__)
+        pthread_threadid_np(nullptr, &id);
+#elif defined(_WIN32)
+        id = GetCurrentThreadId();
+#else
+        id = reinterpret_cast<uintptr_t>(pthread_self());
+#endif
+    }
+    return id;
+}
+
+static int64_t SinceOrigin(Tracer::Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time - origin).count();
+}
+
+static void Write(const char *name, int64_t startNs, int64_t durationNs, const char *argName, int64_t argValue) {
+    TraceRing *ring = currentRing.load(std::memory_order_acquire);
+    if (!ring) {
+        return;
+    }
+
+    uint64_t position = ring->next.fetch_add(1, std::memory_order_relaxed);
+    TraceEvent &event = ring->events[position % ring->events.size()];
+
+    event.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name.store(name, std::memory_order_relaxed);
+    event.argName.store(argName, std::memory_order_relaxed);
+    event.argValue.store(argValue, std::memory_order_relaxed);
+    event.startNs.store(startNs, std::memory_order_relaxed);
+    event.durationNs.store(durationNs, std::memory_order_relaxed);
+    event.threadId.store(CurrentThreadId(), std::memory_order_relaxed);
+    event.sequence.store(position + 1, std::memory_order_release);
+}
+
+void Tracer::Start(size_t capacity) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    capacity = capacity > 0 ? capacity : 1;
+
+    TraceRing *ring = currentRing.load(std::memory_order_relaxed);
+    if (ring && ring->events.size() == capacity) {
+        // Reuse the ring. Skipping a full lap leaves every old event outside the readable window.
+        ring->next.fetch_add(capacity, std::memory_order_relaxed);
+    } else {
+        currentRing.store(new TraceRing(capacity), std::memory_order_release);
+        // Stays charged, replaced rings are never freed
+        MemoryAccount::Add(MemoryCategory::Tracing, static_cast<int64_t>(sizeof(TraceRing) + capacity * sizeof(TraceEvent)));
+    }
+    enabled.store(true, std::memory_order_release);
+}
+
+void Tracer::Stop() {
+    enabled.store(false, std::memory_order_release);
+}
+
+void Tracer::Complete(const char *name, Clock::time_point start, Clock::time_point end, const char *argName, int64_t argValue) {
+    if (!Enabled()) {
+        return;
+    }
+    int64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    Write(name, SinceOrigin(start), duration > 0 ? duration : 0, argName, argValue);
+}
+
+void Tracer::Instant(const char *name, const char *argName, int64_t argValue) {
+    if (!Enabled()) {
+        return;
+    }
+    Write(name, SinceOrigin(Clock::now()), -1, argName, argValue);
+}
+
+std::string Tracer::ToJson() {
+    std::lock_guard<std::mutex> lock(controlMutex);
+
+#ifdef _WIN32
+    const int processId = _getpid();
+#else
+    const int processId = getpid();
+#endif
+
+    cJSON *root = cJSON_CreateObject();
+    cJSON *events = cJSON_CreateArray();
+    cJSON_AddItemToObject(root, "traceEvents", events);
+    cJSON_AddStringToObject(root, "displayTimeUnit", "ms");
+
+    TraceRing *ring = currentRing.load(std::memory_order_acquire);
+    if (ring) {
+        const uint64_t capacity = ring->events.size();
+        const uint64_t end = ring->next.load(std::memory_order_acquire);
+        const uint64_t begin = end > capacity ? end - capacity : 0;
+
+        for (uint64_t position = begin; position < end; position++) {
+            const TraceEvent &slot = ring->events[position % capacity];
+
+            uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const char *name = slot.name.load(std::memory_order_relaxed);
+            const char *argName = slot.argName.load(std::memory_order_relaxed);
+            int64_t argValue = slot.argValue.load(std::memory_order_relaxed);
+            int64_t startNs = slot.startNs.load(std::memory_order_relaxed);
+            int64_t durationNs = slot.durationNs.load(std::memory_order_relaxed);
+            uint64_t threadId = slot.threadId.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence != position + 1 || slot.sequence.load(std::memory_order_relaxed) != sequence || !name) {
+                continue; // Being written, overwritten or from before the last start
+            }
+
+            cJSON *event = cJSON_CreateObject();
+            cJSON_AddStringToObject(event, "name", name);
+            cJSON_AddStringToObject(event, "cat", "barkoder");
+            cJSON_AddStringToObject(event, "ph", durationNs < 0 ? "i" : "X");
+            cJSON_AddNumberToObject(event, "ts", startNs / 1000.0);
+            if (durationNs >= 0) {
+                cJSON_AddNumberToObject(event, "dur", durationNs / 1000.0);
+            } else {
+                cJSON_AddStringToObject(event, "s", "t");
+            }
+            cJSON_AddNumberToObject(event, "pid", processId);
+            cJSON_AddNumberToObject(event, "tid", static_cast<double>(threadId));
+            if (argName) {
+                cJSON *args = cJSON_CreateObject();
+                cJSON_AddNumberToObject(args, argName, static_cast<double>(argValue));
+                cJSON_AddItemToObject(event, "args", args);
+            }
+            cJSON_AddItemToArray(events, event);
+        }
+    }
+
+    char *text = cJSON_PrintUnformatted(root);
+    std::string json(text ? text : "");
+    JsonArena::Release(text);
+    cJSON_Delete(root);
+    return json;
+}
+
+}
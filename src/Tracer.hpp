@@ -0,0 +1,96 @@
+#ifndef Tracer_hpp
+#define Tracer_hpp
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace BKNode {
+
+/**
+ * @brief Opt-in timeline of decode pipeline stages in the Chrome trace-event format.
+ *
+ * Events go into a fixed-size ring shared by all threads. Writers claim a
+ * slot with one atomic increment and never wait; once the ring is full the
+ * oldest events are overwritten. When tracing is off, recording costs one
+ * relaxed load.
+ */
+class Tracer {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * @brief Checks whether events are being recorded.
+     */
+    static bool Enabled() { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Discards recorded events and starts recording.
+     * @param capacity Number of most recent events kept.
+     */
+    static void Start(size_t capacity);
+
+    /**
+     * @brief Stops recording, keeping the recorded events.
+     */
+    static void Stop();
+
+    /**
+     * @brief Records an event that covers a time span.
+     * @param name Static string naming the stage.
+     * @param start When the stage began.
+     * @param end When the stage ended.
+     * @param argName Static string naming the numeric argument, or nullptr.
+     * @param argValue Argument shown with the event.
+     */
+    static void Complete(const char *name, Clock::time_point start, Clock::time_point end,
+                         const char *argName = nullptr, int64_t argValue = 0);
+
+    /**
+     * @brief Records an event without duration, such as a queue handoff.
+     */
+    static void Instant(const char *name, const char *argName = nullptr, int64_t argValue = 0);
+
+    /**
+     * @brief Renders the recorded events, oldest first.
+     * @return Chrome trace JSON, loadable in chrome://tracing and Perfetto.
+     */
+    static std::string ToJson();
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+/**
+ * @brief Records the lifetime of a scope as a complete event when tracing is on.
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char *name, const char *argName = nullptr, int64_t argValue = 0)
+        : name(name), argName(argName), argValue(argValue), active(Tracer::Enabled()) {
+        if (active) {
+            start = Tracer::Clock::now();
+        }
+    }
+
+    ~TraceSpan() {
+        if (active) {
+            Tracer::Complete(name, start, Tracer::Clock::now(), argName, argValue);
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *name;
+    const char *argName;
+    int64_t argValue;
+    bool active;
+    Tracer::Clock::time_point start;
+};
+
+}
+
+#endif /* Tracer_hpp */
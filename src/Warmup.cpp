@@ -0,0 +1,199 @@
+#include "Warmup.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include "DecodePool.hpp"
+#include "DecodeStrategies.hpp"
+#include "JsonArena.hpp"
+#include "MemoryAccount.hpp"
+#include "Tracer.hpp"
+#include "json/cJSON.h"
+
+using namespace NSBarkoder;
+
+namespace BKNode {
+
+typedef std::chrono::steady_clock Clock;
+
+static uint64_t ElapsedNs(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+std::vector<uint8_t> Warmup::SyntheticImage(int width, int height) {
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height);
+    uint32_t state = 0x9E3779B9u;
+    auto next = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    };
+
+    // Soft gradient with noise, so binarization has something to adapt to
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            pixels[static_cast<size_t>(y) * width + x] = static_cast<uint8_t>(96 + (x + y) * 64 / (width + height) + next() % 16);
+        }
+    }
+
+    // Left part: bars of varying width across the middle band, as linear symbols have
+    int unit = std::max(1, width / 640);
+    int barsRight = width * 2 / 5;
+    for (int x = width / 20; x < barsRight;) {
+        int bar = unit * static_cast<int>(1 + next() % 4);
+        bool dark = (next() & 1) != 0;
+        for (int y = height * 3 / 10; y < height * 7 / 10; y++) {
+            for (int i = x; i < std::min(x + bar, barsRight); i++) {
+                pixels[static_cast<size_t>(y) * width + i] = dark ? 30 : 220;
+            }
+        }
+        x += bar;
+    }
+
+    // Right part: a module grid with three finder squares, as matrix symbols have
+    const int modules = 29;
+    int module = std::max(2, std::min(width * 2 / 5, height * 4 / 5) / (modules + 8));
+    int left = barsRight + width / 10;
+    int top = (height - modules * module) / 2;
+    auto finder = [](int mx, int my, int ox, int oy) {
+        int dx = mx - ox;
+        int dy = my - oy;
+        if (dx < 0 || dy < 0 || dx > 6 || dy > 6) {
+            return -1;
+        }
+        int ring = std::min(std::min(dx, dy), std::min(6 - dx, 6 - dy));
+        return ring == 1 ? 0 : 1;
+    };
+    for (int my = 0; my < modules; my++) {
+        for (int mx = 0; mx < modules; mx++) {
+            int shape = std::max(std::max(finder(mx, my, 0, 0), finder(mx, my, modules - 7, 0)), finder(mx, my, 0, modules - 7));
+            bool dark = shape >= 0 ? shape == 1 : (next() & 1) != 0;
+            for (int y = top + my * module; y < top + (my + 1) * module; y++) {
+                for (int x = left + mx * module; x < left + (mx + 1) * module; x++) {
+                    if (x >= 0 && y >= 0 && x < width && y < height) {
+                        pixels[static_cast<size_t>(y) * width + x] = dark ? 25 : 225;
+                    }
+                }
+            }
+        }
+    }
+    return pixels;
+}
+
+WarmupReport Warmup::Run(ConfigVariants &variants, const WarmupOptions &options, DecodePool &pool) {
+    WarmupReport report;
+    report.threads = pool.ThreadCount();
+    auto started = Clock::now();
+    TraceSpan span("warmup", "threads", report.threads);
+
+    std::vector<std::vector<uint8_t>> images;
+    MemoryCharge imagesCharge(MemoryCategory::ConversionScratch);
+    for (const auto &resolution : options.resolutions) {
+        images.push_back(SyntheticImage(resolution.first, resolution.second));
+        imagesCharge.Set(imagesCharge.Bytes() + images.back().size());
+    }
+    std::vector<std::unique_ptr<Config>> configs;
+    MemoryCharge configsCharge(MemoryCategory::Caches);
+    for (DecoderType decoder : options.decoders) {
+        for (DecodingSpeed speed : options.speeds) {
+            configs.push_back(variants.WithDecoders({ decoder }, speed));
+            configsCharge.Set(configsCharge.Bytes() + sizeof(Config));
+            for (const auto &resolution : options.resolutions) {
+                WarmupPass pass;
+                pass.decoder = decoder;
+                pass.width = resolution.first;
+                pass.height = resolution.second;
+                pass.speed = speed;
+                report.passes.push_back(pass);
+            }
+        }
+    }
+    if (report.passes.empty()) {
+        return report;
+    }
+    int repeats = std::max(1, options.repeats);
+    size_t resolutionCount = options.resolutions.size();
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    int arrived = 0;
+    int finished = 0;
+
+    for (int t = 0; t < report.threads; t++) {
+        pool.Submit([&] {
+            {
+                // Hold this worker until every worker has a warm-up task
+                std::unique_lock<std::mutex> lock(mutex);
+                arrived++;
+                changed.notify_all();
+                changed.wait(lock, [&] { return arrived == report.threads; });
+            }
+
+            JsonArena::Prefault();
+            std::vector<uint64_t> firstNs(report.passes.size());
+            std::vector<uint64_t> lastNs(report.passes.size());
+            std::string error;
+            for (size_t p = 0; p < report.passes.size(); p++) {
+                const WarmupPass &pass = report.passes[p];
+                Config *config = configs[p / resolutionCount].get();
+                std::vector<uint8_t> &image = images[p % resolutionCount];
+                for (int r = 0; r < repeats; r++) {
+                    auto decodeStart = Clock::now();
+                    try {
+                        DecodeWithSdk(config, image.data(), pass.width, pass.height);
+                    } catch (const std::exception &e) {
+                        if (error.empty()) {
+                            error = e.what();
+                        }
+                    }
+                    lastNs[p] = ElapsedNs(decodeStart, Clock::now());
+                    if (r == 0) {
+                        firstNs[p] = lastNs[p];
+                    }
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t p = 0; p < report.passes.size(); p++) {
+                report.passes[p].firstNs = std::max(report.passes[p].firstNs, firstNs[p]);
+                report.passes[p].lastNs = std::max(report.passes[p].lastNs, lastNs[p]);
+            }
+            if (report.error.empty()) {
+                report.error = error;
+            }
+            finished++;
+            changed.notify_all();
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [&] { return finished == report.threads; });
+    report.decodes = static_cast<uint64_t>(report.passes.size()) * repeats * report.threads;
+    report.totalNs = ElapsedNs(started, Clock::now());
+    return report;
+}
+
+cJSON *WarmupReport::ToJson() const {
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddNumberToObject(root, "totalMs", totalNs / 1e6);
+    cJSON_AddNumberToObject(root, "threads", threads);
+    cJSON_AddNumberToObject(root, "decodes", static_cast<double>(decodes));
+    cJSON *items = cJSON_CreateArray();
+    for (const WarmupPass &pass : passes) {
+        cJSON *item = cJSON_CreateObject();
+        cJSON_AddNumberToObject(item, "decoder", static_cast<int>(pass.decoder));
+        cJSON_AddNumberToObject(item, "width", pass.width);
+        cJSON_AddNumberToObject(item, "height", pass.height);
+        cJSON_AddNumberToObject(item, "speed", static_cast<int>(pass.speed));
+        cJSON_AddNumberToObject(item, "firstMs", pass.firstNs / 1e6);
+        cJSON_AddNumberToObject(item, "warmMs", pass.lastNs / 1e6);
+        cJSON_AddItemToArray(items, item);
+    }
+    cJSON_AddItemToObject(root, "passes", items);
+    if (!error.empty()) {
+        cJSON_AddStringToObject(root, "error", error.c_str());
+    }
+    return root;
+}
+
+}
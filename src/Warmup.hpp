@@ -0,0 +1,84 @@
+#ifndef Warmup_hpp
+#define Warmup_hpp
+
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Barkoder.hpp"
+
+struct cJSON;
+
+namespace BKNode {
+
+class ConfigVariants;
+class DecodePool;
+
+/**
+ * @brief What a warm-up decodes.
+ */
+struct WarmupOptions {
+    std::vector<NSBarkoder::DecoderType> decoders;   /**< Each is warmed on its own. */
+    std::vector<std::pair<int, int>> resolutions;    /**< Synthetic image sizes, width and height. */
+    std::vector<NSBarkoder::DecodingSpeed> speeds;
+    int repeats = 2;                                 /**< Decodes per pass and worker, the last one counts as warm. */
+};
+
+/**
+ * @brief Timings of one decoder, resolution and speed combination.
+ */
+struct WarmupPass {
+    NSBarkoder::DecoderType decoder = NSBarkoder::DecoderType::QR;
+    int width = 0;
+    int height = 0;
+    NSBarkoder::DecodingSpeed speed = NSBarkoder::DecodingSpeed::Normal;
+    uint64_t firstNs = 0;   /**< Slowest first decode across workers. */
+    uint64_t lastNs = 0;    /**< Slowest last decode across workers. */
+};
+
+/**
+ * @brief Outcome of a warm-up.
+ */
+struct WarmupReport {
+    int threads = 0;
+    uint64_t decodes = 0;
+    uint64_t totalNs = 0;
+    std::vector<WarmupPass> passes;
+    std::string error;      /**< First exception thrown by a decode, empty when none was. */
+
+    /**
+     * @brief Converts the report to JSON; the caller deletes the tree.
+     */
+    cJSON *ToJson() const;
+};
+
+/**
+ * @brief Runs synthetic decodes so the first real ones do not pay for cold code and data.
+ *
+ * The SDK builds tables on first use and its code pages are only faulted in
+ * once executed, so early decodes after startup are several times slower
+ * than later ones. A warm-up decodes a generated image with bars and module
+ * grids, which drives both the 1D and 2D detectors, once per pass on every
+ * pool worker, and prefaults each worker's result JSON arena. Workers are
+ * held at a barrier until all of them have taken a warm-up task, so every
+ * thread is warmed even when other decodes are queued.
+ */
+class Warmup {
+public:
+    /**
+     * @brief Warms every worker of the pool. Blocks until done, so never call it from a pool task.
+     * @param variants Settings to decode with; each pass enables only its own decoder.
+     * @param options Decoders, resolutions and speeds to run.
+     * @param pool Pool whose workers are warmed.
+     */
+    static WarmupReport Run(ConfigVariants &variants, const WarmupOptions &options, DecodePool &pool);
+
+    /**
+     * @brief Generates the deterministic grayscale image the warm-up decodes.
+     */
+    static std::vector<uint8_t> SyntheticImage(int width, int height);
+};
+
+}
+
+#endif /* Warmup_hpp */
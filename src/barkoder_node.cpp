@@ -1,12 +1,33 @@
 #include <napi.h>
+#include <cstdio>
 #include <iostream>
 #include <string>
 #include <vector>
+#include <memory>
+#include <algorithm>
+#include <thread>
+#include <functional>
+#include <deque>
+#include <unordered_map>
 #include "Barkoder.hpp"
 #include "Config.hpp"
+#include "DecodePool.hpp"
+#include "DecodeStats.hpp"
+#include "DecodeStrategies.hpp"
+#include "FrameCapture.hpp"
+#include "JsonArena.hpp"
+#include "MemoryAccount.hpp"
+#include "MetricsText.hpp"
+#include "Probes.hpp"
+#include "ResultRing.hpp"
+#include "StartupTimeline.hpp"
+#include "Status.hpp"
+#include "Tracer.hpp"
+#include "Warmup.hpp"
 #include "json/cJSON.h"
 
 using namespace NSBarkoder;
+using namespace BKNode;
 
 // External function from the SDK
 extern void SetDeviceInfo(std::string& appName, std::string& operatingSystem, std::string& operatingSystemVersion, std::string& manufacturerName, std::string& deviceName, std::string& deviceId);
@@ -14,6 +35,182 @@ extern void SetDeviceInfo(std::string& appName, std::string& operatingSystem, st
 // Global config pointer (similar to Python implementation)
 Config *config = nullptr;
 
+// Decode strategy settings and the config copies they decode with
+DecodeOptions decodeOptions;
+std::shared_ptr<ConfigVariants> configVariants;
+uint64_t configSnapshotHits = 0;
+uint64_t configSnapshotMisses = 0;
+
+/**
+ * Drop config copies so the next decode picks up changed settings
+ */
+static void InvalidateConfigVariants() {
+    configVariants.reset();
+}
+
+/**
+ * Get config copies matching the current global config
+ */
+static std::shared_ptr<ConfigVariants> GetConfigVariants() {
+    if (!configVariants) {
+        configVariants = std::make_shared<ConfigVariants>(*config);
+        configSnapshotMisses++;
+    } else {
+        configSnapshotHits++;
+    }
+    return configVariants;
+}
+
+// Native worker threads shared by all parallel decodes. Queued jobs and warm-ups hold a reference,
+// so a pool replaced by setDecodeThreads lives until its last job is done.
+std::shared_ptr<DecodePool> decodePool;
+int decodeThreads = 0;
+int interactiveWeight = DecodePool::kDefaultInteractiveWeight;
+
+/**
+ * Destroy a pool once nothing references it. Destruction drains the queue and joins the
+ * workers, which must neither block the JavaScript thread nor run on one of those workers.
+ */
+static void DestroyDecodePool(DecodePool* pool) {
+    std::thread([pool] { delete pool; }).detach();
+}
+
+/**
+ * Get the decode pool, starting it on first use
+ */
+static std::shared_ptr<DecodePool> GetDecodePool() {
+    if (!decodePool) {
+        int threads = decodeThreads > 0 ? decodeThreads : static_cast<int>(std::thread::hardware_concurrency());
+        decodePool.reset(new DecodePool(threads, interactiveWeight), DestroyDecodePool);
+    }
+    return decodePool;
+}
+
+// Hands finished jobs back to the JavaScript thread
+Napi::ThreadSafeFunction asyncCompletions;
+bool asyncCompletionsCreated = false;
+int pendingAsyncJobs = 0;
+
+/**
+ * Count a job that will post back through asyncCompletions
+ */
+static void AddPendingAsyncJob(Napi::Env env) {
+    if (!asyncCompletionsCreated) {
+        asyncCompletions = Napi::ThreadSafeFunction::New(env, Napi::Function::New(env, [](const Napi::CallbackInfo&) {}),
+                                                         "BarkoderDecodeComplete", 0, 1);
+        asyncCompletions.Unref(env);
+        asyncCompletionsCreated = true;
+    }
+    // Keep the process alive only while decodes are outstanding
+    if (pendingAsyncJobs++ == 0) {
+        asyncCompletions.Ref(env);
+    }
+}
+
+/**
+ * Uncount a completed job, on the JavaScript thread
+ */
+static void RemovePendingAsyncJob(Napi::Env env) {
+    if (--pendingAsyncJobs == 0) {
+        asyncCompletions.Unref(env);
+    }
+}
+
+/**
+ * Where an abortable job is. Its worker and abortDecode() race to move it out of Queued.
+ */
+enum class JobState { Queued, Running, Dropped };
+
+struct JobAbort;
+
+// Jobs that can still be aborted, by the id of the AbortSignal they were queued with.
+// Only touched on the JavaScript thread.
+std::unordered_multimap<uint32_t, std::pair<JobAbort*, std::function<void()>>> abortableJobs;
+
+/**
+ * Abort state of an async job, shared by the JavaScript thread and its worker
+ */
+struct JobAbort {
+    uint32_t signalId = 0;  // 0 when the caller passed no signal
+    std::atomic<JobState> state{JobState::Queued};
+    std::atomic<bool> requested{false};  // Polled by the decode strategies between steps
+    
+    ~JobAbort() {
+        auto range = abortableJobs.equal_range(signalId);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second.first == this) {
+                abortableJobs.erase(it);
+                break;
+            }
+        }
+    }
+    
+    /**
+     * Register what abortDecode() does for this job, on the JavaScript thread
+     */
+    void Watch(std::function<void()> onAbort) {
+        if (signalId != 0) {
+            abortableJobs.emplace(signalId, std::make_pair(this, std::move(onAbort)));
+        }
+    }
+    
+    /**
+     * Claim the job for a worker
+     * @returns False when it was dropped while queued
+     */
+    bool Start() {
+        JobState expected = JobState::Queued;
+        return state.compare_exchange_strong(expected, JobState::Running);
+    }
+    
+    /**
+     * Ask the job to stop
+     * @returns True when it had not started and never will, so its pixels can be released now
+     */
+    bool Abort() {
+        requested.store(true, std::memory_order_relaxed);
+        JobState expected = JobState::Queued;
+        return state.compare_exchange_strong(expected, JobState::Dropped);
+    }
+    
+    bool Dropped() const { return state.load() == JobState::Dropped; }
+};
+
+// Native bytes last reported to V8, and the smallest change worth reporting
+int64_t reportedExternalBytes = 0;
+const int64_t kExternalMemoryGranularity = 64 * 1024;
+
+/**
+ * Report changes in wrapper-owned native memory to V8, so its GC heuristics see it.
+ * Only the JavaScript thread may call napi_adjust_external_memory, so this runs at its call sites.
+ */
+static void ReportExternalMemory(Napi::Env env) {
+    int64_t owned = MemoryAccount::OwnedBytes();
+    int64_t delta = owned - reportedExternalBytes;
+    if (delta >= kExternalMemoryGranularity || delta <= -kExternalMemoryGranularity) {
+        Napi::MemoryManagement::AdjustExternalMemory(env, delta);
+        reportedExternalBytes = owned;
+    }
+}
+
+// Message of the last failed setting call, only built when a call fails
+std::string lastErrorMessage;
+
+/**
+ * Status code of a successful setting call
+ */
+static Napi::Number StatusOk(Napi::Env env) {
+    return Napi::Number::New(env, static_cast<int>(StatusCode::Ok));
+}
+
+/**
+ * Status code of a failed setting call, keeping its message for getLastError()
+ */
+static Napi::Number StatusError(Napi::Env env, StatusCode code, std::string message) {
+    lastErrorMessage = std::move(message);
+    return Napi::Number::New(env, static_cast<int>(code));
+}
+
 /**
  * Get the SDK library version
  */
@@ -29,6 +226,28 @@ Napi::String GetVersion(const Napi::CallbackInfo& info) {
     }
 }
 
+// Set while initializeAsync runs on its own thread
+bool initializing = false;
+
+// Async decodes submitted while initializeAsync runs, started (true) or failed (false) once it finishes
+std::vector<std::function<void(Napi::Env, bool)>> awaitingInit;
+
+/**
+ * Store the global config of a successful initialization and apply the default settings
+ */
+static void AdoptConfig(Config* initialized) {
+    config = initialized;
+    
+    // Set default configurations (similar to Python implementation)
+    Config::SetGlobalOption(BKGlobalOption_SetMaximumThreads, 1);
+    Config::SetGlobalOption(BKGlobalOption_UseGPU, 0);
+    
+    config->decodingSpeed = NSBarkoder::DecodingSpeed::Normal;
+    config->maximumResultsCount = 1;
+    InvalidateConfigVariants();
+    StartupTimeline::Mark(StartupEvent::OptionsDone);
+}
+
 /**
  * Initialize the SDK with license key
  * Similar to init_config() in cpython.cpp:53
@@ -40,10 +259,14 @@ Napi::String Initialize(const Napi::CallbackInfo& info) {
         Napi::TypeError::New(env, "License key string expected").ThrowAsJavaScriptException();
         return Napi::String::New(env, "ERROR: License key string expected");
     }
+    if (initializing) {
+        return Napi::String::New(env, "ERROR: Initialization already in progress");
+    }
     
     std::string licenseKey = info[0].As<Napi::String>().Utf8Value();
     
     try {
+        auto licenseStart = StartupTimeline::Clock::now();
         auto response = Config::InitializeWithLicenseKey(licenseKey);
         
         std::string message = response.Message();
@@ -51,17 +274,10 @@ Napi::String Initialize(const Napi::CallbackInfo& info) {
         if (response.GetResult() == ConfigResponse::Result::Error) {
             return Napi::String::New(env, "ERROR: " + message);
         }
+        StartupTimeline::Mark(StartupEvent::LicenseStart, licenseStart);
+        StartupTimeline::Mark(StartupEvent::LicenseDone);
         
-        // Store global config
-        config = response.GetConfig();
-        
-        // Set default configurations (similar to Python implementation)
-        Config::SetGlobalOption(BKGlobalOption_SetMaximumThreads, 1);
-        Config::SetGlobalOption(BKGlobalOption_UseGPU, 0);
-        
-        config->decodingSpeed = NSBarkoder::DecodingSpeed::Normal;
-        config->maximumResultsCount = 1;
-        
+        AdoptConfig(response.GetConfig());
         return Napi::String::New(env, "SUCCESS: " + message);
         
     } catch (const std::exception& e) {
@@ -70,6 +286,95 @@ Napi::String Initialize(const Napi::CallbackInfo& info) {
     }
 }
 
+/**
+ * A license validation running on its own thread
+ */
+struct InitJob {
+    explicit InitJob(Napi::Env env) : deferred(Napi::Promise::Deferred::New(env)) {}
+    
+    Napi::Promise::Deferred deferred;
+    std::string licenseKey;
+    bool lazyInit = false;
+    DecodeStats::Clock::time_point started;
+    DecodeStats::Clock::time_point finished;
+    Config* config = nullptr;
+    std::string result;
+};
+
+/**
+ * Adopt the initialized config on the JavaScript thread and start the decodes that waited for it
+ */
+static void CompleteInitialize(Napi::Env env, Napi::Function, InitJob* job) {
+    Tracer::Complete("initialize", job->started, job->finished, "lazy", job->lazyInit ? 1 : 0);
+    if (job->config) {
+        AdoptConfig(job->config);
+    }
+    initializing = false;
+    job->deferred.Resolve(Napi::String::New(env, job->result));
+    
+    std::vector<std::function<void(Napi::Env, bool)>> waiting;
+    waiting.swap(awaitingInit);
+    for (auto& start : waiting) {
+        start(env, config != nullptr);
+    }
+    
+    delete job;
+    RemovePendingAsyncJob(env);
+}
+
+/**
+ * Initialize the SDK with license key on a separate thread
+ * @param licenseKey - Barkoder license key
+ * @param lazyInit - Let the SDK finish setting up in the background after validation
+ * @returns Promise of the same message initialize returns; async decodes issued meanwhile wait for it
+ */
+Napi::Value InitializeAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    InitJob* job = new InitJob(env);
+    Napi::Promise promise = job->deferred.Promise();
+    
+    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsBoolean()) {
+        job->deferred.Resolve(Napi::String::New(env, "ERROR: License key string and lazy init flag expected"));
+        delete job;
+        return promise;
+    }
+    if (initializing) {
+        job->deferred.Resolve(Napi::String::New(env, "ERROR: Initialization already in progress"));
+        delete job;
+        return promise;
+    }
+    
+    job->licenseKey = info[0].As<Napi::String>().Utf8Value();
+    job->lazyInit = info[1].As<Napi::Boolean>().Value();
+    initializing = true;
+    AddPendingAsyncJob(env);
+    
+    // Validation blocks for as long as the license check takes, so it gets its own thread rather than a decode worker
+    std::thread([job] {
+        job->started = DecodeStats::Clock::now();
+        try {
+            if (job->lazyInit) {
+                Config::SetGlobalOption(BKGlobalOption_LazyInitEnable, 1);
+            }
+            auto response = Config::InitializeWithLicenseKey(job->licenseKey);
+            if (response.GetResult() == ConfigResponse::Result::Error) {
+                job->result = "ERROR: " + response.Message();
+            } else {
+                job->config = response.GetConfig();
+                job->result = "SUCCESS: " + response.Message();
+                StartupTimeline::Mark(StartupEvent::LicenseStart, job->started);
+                StartupTimeline::Mark(StartupEvent::LicenseDone);
+            }
+        } catch (const std::exception& e) {
+            job->result = "ERROR: Exception during initialization: " + std::string(e.what());
+        }
+        job->finished = DecodeStats::Clock::now();
+        asyncCompletions.NonBlockingCall(job, CompleteInitialize);
+    }).detach();
+    
+    return promise;
+}
+
 /**
  * Check if SDK is initialized
  */
@@ -82,15 +387,15 @@ Napi::Boolean IsInitialized(const Napi::CallbackInfo& info) {
  * Set which decoders are enabled for scanning
  * @param decodersArray - Array of decoder type integers
  */
-Napi::String SetEnabledDecoders(const Napi::CallbackInfo& info) {
+Napi::Number SetEnabledDecoders(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
     if (!config) {
-        return Napi::String::New(env, "ERROR: SDK not initialized");
+        return StatusError(env, StatusCode::NotInitialized, "SDK not initialized");
     }
     
     if (info.Length() < 1 || !info[0].IsArray()) {
-        return Napi::String::New(env, "ERROR: Array of decoder types expected");
+        return StatusError(env, StatusCode::InvalidArgument, "Array of decoder types expected");
     }
     
     try {
@@ -106,10 +411,11 @@ Napi::String SetEnabledDecoders(const Napi::CallbackInfo& info) {
         }
         
         config->SetEnabledDecoders(enabledDecoders);
-        return Napi::String::New(env, "SUCCESS: Enabled " + std::to_string(enabledDecoders.size()) + " decoders");
+        InvalidateConfigVariants();
+        return StatusOk(env);
         
     } catch (const std::exception& e) {
-        return Napi::String::New(env, "ERROR: " + std::string(e.what()));
+        return StatusError(env, StatusCode::SdkError, e.what());
     }
 }
 
@@ -117,24 +423,207 @@ Napi::String SetEnabledDecoders(const Napi::CallbackInfo& info) {
  * Set the decoding speed
  * @param speed - Speed value (0=Fast, 1=Normal, 2=Slow, 3=Rigorous)
  */
-Napi::String SetDecodingSpeed(const Napi::CallbackInfo& info) {
+Napi::Number SetDecodingSpeed(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
     if (!config) {
-        return Napi::String::New(env, "ERROR: SDK not initialized");
+        return StatusError(env, StatusCode::NotInitialized, "SDK not initialized");
     }
     
     if (info.Length() < 1 || !info[0].IsNumber()) {
-        return Napi::String::New(env, "ERROR: Speed integer expected");
+        return StatusError(env, StatusCode::InvalidArgument, "Speed integer expected");
     }
     
     try {
         int speed = info[0].As<Napi::Number>().Int32Value();
+        if (speed < static_cast<int>(DecodingSpeed::Fast) || speed > static_cast<int>(DecodingSpeed::Rigorous)) {
+            return StatusError(env, StatusCode::InvalidArgument, "Invalid speed " + std::to_string(speed));
+        }
         config->decodingSpeed = static_cast<DecodingSpeed>(speed);
-        return Napi::String::New(env, "SUCCESS: Decoding speed set to " + std::to_string(speed));
+        InvalidateConfigVariants();
+        return StatusOk(env);
         
     } catch (const std::exception& e) {
-        return Napi::String::New(env, "ERROR: " + std::string(e.what()));
+        return StatusError(env, StatusCode::SdkError, e.what());
+    }
+}
+
+/**
+ * Set the speeds tried in turn when a decode finds nothing
+ * @param speeds - Array of speed values, escalated from fastest to slowest (empty disables)
+ * @param timeBudgetMs - Per-request time after which no further speed is tried (0 = unlimited)
+ */
+Napi::Number SetDecodingCascade(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!config) {
+        return StatusError(env, StatusCode::NotInitialized, "SDK not initialized");
+    }
+    
+    if (info.Length() < 1 || !info[0].IsArray() || (info.Length() > 1 && !info[1].IsNumber())) {
+        return StatusError(env, StatusCode::InvalidArgument, "Array of speeds and optional time budget expected");
+    }
+    
+    try {
+        Napi::Array speedsArray = info[0].As<Napi::Array>();
+        std::vector<DecodingSpeed> speeds;
+        
+        for (uint32_t i = 0; i < speedsArray.Length(); i++) {
+            Napi::Value element = speedsArray[i];
+            if (!element.IsNumber()) {
+                return StatusError(env, StatusCode::InvalidArgument, "Speeds must be numbers");
+            }
+            int speed = element.As<Napi::Number>().Int32Value();
+            if (speed < static_cast<int>(DecodingSpeed::Fast) || speed > static_cast<int>(DecodingSpeed::Rigorous)) {
+                return StatusError(env, StatusCode::InvalidArgument, "Invalid speed " + std::to_string(speed));
+            }
+            speeds.push_back(static_cast<DecodingSpeed>(speed));
+        }
+        
+        // Always escalate from the fastest level, each level once
+        std::sort(speeds.begin(), speeds.end());
+        speeds.erase(std::unique(speeds.begin(), speeds.end()), speeds.end());
+        
+        decodeOptions.cascade.speeds = speeds;
+        decodeOptions.cascade.timeBudgetMs = info.Length() > 1 ? std::max(0, info[1].As<Napi::Number>().Int32Value()) : 0;
+        
+        return StatusOk(env);
+        
+    } catch (const std::exception& e) {
+        return StatusError(env, StatusCode::SdkError, e.what());
+    }
+}
+
+/**
+ * Decode large images coarse-to-fine
+ * @param factor - Downscale factor of the first pass, 2 or 4 (1 disables)
+ * @param minPixels - Images with fewer pixels are decoded directly
+ * @param fullFrameFallback - Decode the full image when the downscaled pass finds nothing
+ */
+Napi::Number SetPyramidMode(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!config) {
+        return StatusError(env, StatusCode::NotInitialized, "SDK not initialized");
+    }
+    
+    if (info.Length() < 3 || !info[0].IsNumber() || !info[1].IsNumber() || !info[2].IsBoolean()) {
+        return StatusError(env, StatusCode::InvalidArgument, "Factor, minimum pixels and fallback flag expected");
+    }
+    
+    try {
+        int factor = info[0].As<Napi::Number>().Int32Value();
+        if (factor != 1 && factor != 2 && factor != 4) {
+            return StatusError(env, StatusCode::InvalidArgument, "Pyramid factor must be 1, 2 or 4");
+        }
+        
+        decodeOptions.pyramid.factor = factor;
+        decodeOptions.pyramid.minPixels = std::max(0, info[1].As<Napi::Number>().Int32Value());
+        decodeOptions.pyramid.fullFrameFallback = info[2].As<Napi::Boolean>().Value();
+        
+        return StatusOk(env);
+        
+    } catch (const std::exception& e) {
+        return StatusError(env, StatusCode::SdkError, e.what());
+    }
+}
+
+/**
+ * Decode huge images as overlapping tiles in parallel
+ * @param maxBarcodeSize - Largest expected barcode side in pixels, used as tile overlap (0 disables)
+ * @param minPixels - Images with fewer pixels are not tiled
+ */
+Napi::Number SetTileMode(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!config) {
+        return StatusError(env, StatusCode::NotInitialized, "SDK not initialized");
+    }
+    
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+        return StatusError(env, StatusCode::InvalidArgument, "Maximum barcode size and minimum pixels expected");
+    }
+    
+    try {
+        decodeOptions.tiles.maxBarcodeSize = std::max(0, info[0].As<Napi::Number>().Int32Value());
+        decodeOptions.tiles.minPixels = std::max(0, info[1].As<Napi::Number>().Int32Value());
+        
+        return StatusOk(env);
+        
+    } catch (const std::exception& e) {
+        return StatusError(env, StatusCode::SdkError, e.what());
+    }
+}
+
+/**
+ * Set the number of native threads used for parallel decoding
+ * @param threads - Thread count (0 = one per CPU core)
+ */
+Napi::Number SetDecodeThreads(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        return StatusError(env, StatusCode::InvalidArgument, "Thread count expected");
+    }
+    
+    try {
+        decodeThreads = std::max(0, info[0].As<Napi::Number>().Int32Value());
+        
+        // Restart with the new size on next use; the old pool finishes its queued work on its own
+        decodePool.reset();
+        
+        return StatusOk(env);
+        
+    } catch (const std::exception& e) {
+        return StatusError(env, StatusCode::SdkError, e.what());
+    }
+}
+
+/**
+ * Set how many interactive decodes run before a waiting bulk decode gets a worker
+ * @param weight - Interactive decodes per bulk decode, at least 1
+ */
+Napi::Number SetInteractiveWeight(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        return StatusError(env, StatusCode::InvalidArgument, "Weight expected");
+    }
+    int weight = info[0].As<Napi::Number>().Int32Value();
+    if (weight < 1) {
+        return StatusError(env, StatusCode::InvalidArgument, "Weight must be at least 1");
+    }
+    
+    interactiveWeight = weight;
+    if (decodePool) {
+        decodePool->SetInteractiveWeight(weight);
+    }
+    return StatusOk(env);
+}
+
+/**
+ * Set the maximum number of barcodes returned per image
+ * @param count - Maximum results count
+ */
+Napi::Number SetMaximumResultsCount(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!config) {
+        return StatusError(env, StatusCode::NotInitialized, "SDK not initialized");
+    }
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        return StatusError(env, StatusCode::InvalidArgument, "Results count expected");
+    }
+    
+    try {
+        int count = info[0].As<Napi::Number>().Int32Value();
+        config->maximumResultsCount = count;
+        InvalidateConfigVariants();
+        return StatusOk(env);
+        
+    } catch (const std::exception& e) {
+        return StatusError(env, StatusCode::SdkError, e.what());
     }
 }
 
@@ -142,16 +631,16 @@ Napi::String SetDecodingSpeed(const Napi::CallbackInfo& info) {
  * Set the region of interest for scanning
  * @param left, top, width, height - ROI coordinates (floats 0-100)
  */
-Napi::String SetRegionOfInterest(const Napi::CallbackInfo& info) {
+Napi::Number SetRegionOfInterest(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
     if (!config) {
-        return Napi::String::New(env, "ERROR: SDK not initialized");
+        return StatusError(env, StatusCode::NotInitialized, "SDK not initialized");
     }
     
     if (info.Length() < 4 || !info[0].IsNumber() || !info[1].IsNumber() || 
         !info[2].IsNumber() || !info[3].IsNumber()) {
-        return Napi::String::New(env, "ERROR: Four numbers expected (left, top, width, height)");
+        return StatusError(env, StatusCode::InvalidArgument, "Four numbers expected (left, top, width, height)");
     }
     
     try {
@@ -161,135 +650,1317 @@ Napi::String SetRegionOfInterest(const Napi::CallbackInfo& info) {
         float height = info[3].As<Napi::Number>().FloatValue();
         
         config->SetRegionOfInterest(left, top, width, height);
+        InvalidateConfigVariants();
         
-        return Napi::String::New(env, "SUCCESS: ROI set to (" + 
-                                std::to_string(left) + "," + std::to_string(top) + "," +
-                                std::to_string(width) + "," + std::to_string(height) + ")");
+        return StatusOk(env);
         
     } catch (const std::exception& e) {
-        return Napi::String::New(env, "ERROR: " + std::string(e.what()));
+        return StatusError(env, StatusCode::SdkError, e.what());
     }
 }
 
 /**
- * Decode barcode from image buffer
- * @param imageBuffer - Buffer containing grayscale image data
- * @param width - Image width in pixels
- * @param height - Image height in pixels
+ * Get the message of the last failed setting call
  */
-Napi::String DecodeImage(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
+Napi::String GetLastError(const Napi::CallbackInfo& info) {
+    return Napi::String::New(info.Env(), lastErrorMessage);
+}
+
+/**
+ * Print a cJSON tree to a string and free it
+ */
+static std::string PrintAndDeleteJson(cJSON* root) {
+    char* jsonString = cJSON_Print(root);
+    std::string result(jsonString);
     
-    if (!config) {
-        return Napi::String::New(env, "ERROR: SDK not initialized");
+    cJSON_Delete(root);
+    JsonArena::Release(jsonString);
+    
+    return result;
+}
+
+/**
+ * Add corner and polygon coordinates of a result to a JSON object
+ */
+static void AddLocationToJson(cJSON* object, const BaseResult& result) {
+    cJSON* location = cJSON_CreateArray();
+    for (const BKPoint& point : result.location) {
+        cJSON* corner = cJSON_CreateObject();
+        cJSON_AddFloatToObject(corner, "x", point.x);
+        cJSON_AddFloatToObject(corner, "y", point.y);
+        cJSON_AddItemToArray(location, corner);
     }
+    cJSON_AddItemToObject(object, "location", location);
     
-    if (info.Length() < 3 || !info[0].IsBuffer() || !info[1].IsNumber() || !info[2].IsNumber()) {
-        return Napi::String::New(env, "ERROR: Buffer and two numbers expected (imageBuffer, width, height)");
+    if (!result.polygonLocation.empty()) {
+        cJSON* polygon = cJSON_CreateArray();
+        for (const BKPoint& point : result.polygonLocation) {
+            cJSON* vertex = cJSON_CreateObject();
+            cJSON_AddFloatToObject(vertex, "x", point.x);
+            cJSON_AddFloatToObject(vertex, "y", point.y);
+            cJSON_AddItemToArray(polygon, vertex);
+        }
+        cJSON_AddItemToObject(object, "polygon", polygon);
     }
+}
+
+/**
+ * Convert decode results to the JSON string returned to JavaScript
+ * @param outcome - Results and the way they were obtained
+ * @param strategies - Strategies used for the decode, reported alongside the results (nullptr = none)
+ */
+static std::string ResultsToJson(const DecodeOutcome& outcome, const DecodeOptions* strategies) {
+    JsonArena::Scope arena; // The whole tree and its printout live in this thread's arena
+    const std::vector<BaseResult>& results = outcome.results;
+    int resultsCount = static_cast<int>(results.size());
+    cJSON* root = cJSON_CreateObject();
     
-    try {
-        Napi::Buffer<uint8_t> buffer = info[0].As<Napi::Buffer<uint8_t>>();
-        int width = info[1].As<Napi::Number>().Int32Value();
-        int height = info[2].As<Napi::Number>().Int32Value();
-        
-        uint8_t* imageData = buffer.Data();
-        size_t bufferLength = buffer.Length();
+    if (resultsCount == 0) {
+        // No barcodes found
+        cJSON_AddNumberToObject(root, "resultsCount", 0);
+        cJSON_AddStringToObject(root, "barcodeTypeName", "");
+        cJSON_AddStringToObject(root, "textualData", "");
+    }
+    else if (resultsCount == 1) {
+        // Single barcode result
+        cJSON_AddNumberToObject(root, "resultsCount", 1);
+        cJSON_AddStringToObject(root, "barcodeTypeName", results[0].barcodeTypeName.c_str());
+        cJSON_AddStringToObject(root, "textualData", results[0].textualData.c_str());
+        AddLocationToJson(root, results[0]);
         
-        // Validate buffer size
-        if (bufferLength < static_cast<size_t>(width * height)) {
-            return Napi::String::New(env, "ERROR: Buffer too small for specified dimensions");
+        // Add extra data if available
+        for (const auto& pair : results[0].extra) {
+            cJSON_AddStringToObject(root, pair.first.c_str(), pair.second.c_str());
         }
+    }
+    else {
+        // Multiple barcode results
+        cJSON_AddNumberToObject(root, "resultsCount", resultsCount);
         
-        // Decode the image
-        std::vector<BaseResult> results = Barkoder::DecodeImageMemory(config, imageData, width, height);
-        
-        // Convert results to JSON
-        int resultsCount = static_cast<int>(results.size());
+        cJSON* resultsArray = cJSON_CreateArray();
         
-        if (resultsCount == 0) {
-            // No barcodes found
-            cJSON* root = cJSON_CreateObject();
-            cJSON_AddNumberToObject(root, "resultsCount", 0);
-            cJSON_AddStringToObject(root, "barcodeTypeName", "");
-            cJSON_AddStringToObject(root, "textualData", "");
-            
-            char* jsonString = cJSON_Print(root);
-            std::string result(jsonString);
-            
-            cJSON_Delete(root);
-            free(jsonString);
-            
-            return Napi::String::New(env, result);
-        }
-        else if (resultsCount == 1) {
-            // Single barcode result
-            cJSON* root = cJSON_CreateObject();
-            cJSON_AddNumberToObject(root, "resultsCount", 1);
-            cJSON_AddStringToObject(root, "barcodeTypeName", results[0].barcodeTypeName.c_str());
-            cJSON_AddStringToObject(root, "textualData", results[0].textualData.c_str());
+        for (int i = 0; i < resultsCount; i++) {
+            cJSON* singleResult = cJSON_CreateObject();
+            cJSON_AddStringToObject(singleResult, "barcodeTypeName", results[i].barcodeTypeName.c_str());
+            cJSON_AddStringToObject(singleResult, "textualData", results[i].textualData.c_str());
+            AddLocationToJson(singleResult, results[i]);
             
             // Add extra data if available
-            for (const auto& pair : results[0].extra) {
-                cJSON_AddStringToObject(root, pair.first.c_str(), pair.second.c_str());
+            for (const auto& pair : results[i].extra) {
+                cJSON_AddStringToObject(singleResult, pair.first.c_str(), pair.second.c_str());
             }
             
-            char* jsonString = cJSON_Print(root);
-            std::string result(jsonString);
-            
-            cJSON_Delete(root);
-            free(jsonString);
-            
-            return Napi::String::New(env, result);
+            cJSON_AddItemToArray(resultsArray, singleResult);
         }
-        else {
-            // Multiple barcode results
-            cJSON* root = cJSON_CreateObject();
-            cJSON_AddNumberToObject(root, "resultsCount", resultsCount);
-            
-            cJSON* resultsArray = cJSON_CreateArray();
-            
-            for (int i = 0; i < resultsCount; i++) {
-                cJSON* singleResult = cJSON_CreateObject();
-                cJSON_AddStringToObject(singleResult, "barcodeTypeName", results[i].barcodeTypeName.c_str());
-                cJSON_AddStringToObject(singleResult, "textualData", results[i].textualData.c_str());
-                
-                // Add extra data if available
-                for (const auto& pair : results[i].extra) {
-                    cJSON_AddStringToObject(singleResult, pair.first.c_str(), pair.second.c_str());
-                }
-                
-                cJSON_AddItemToArray(resultsArray, singleResult);
-            }
-            
-            cJSON_AddItemToObject(root, "results", resultsArray);
-            
-            char* jsonString = cJSON_Print(root);
-            std::string result(jsonString);
-            
-            cJSON_Delete(root);
-            free(jsonString);
-            
-            return Napi::String::New(env, result);
+        
+        cJSON_AddItemToObject(root, "results", resultsArray);
+    }
+    
+    if (strategies && !strategies->cascade.speeds.empty()) {
+        cJSON_AddNumberToObject(root, "decodingSpeed", static_cast<int>(outcome.decodingSpeed));
+        cJSON_AddNumberToObject(root, "cascadeAttempts", outcome.attempts);
+        cJSON_AddBoolToObject(root, "cascadeBudgetExhausted", outcome.budgetExhausted);
+    }
+    if (strategies && outcome.pyramidFactor > 1) {
+        cJSON_AddNumberToObject(root, "pyramidFactor", outcome.pyramidFactor);
+    }
+    if (strategies && outcome.tiles > 0) {
+        cJSON_AddNumberToObject(root, "tiles", outcome.tiles);
+    }
+    if (outcome.deadlineExceeded) {
+        cJSON_AddBoolToObject(root, "deadlineExceeded", true);
+    }
+    
+    return PrintAndDeleteJson(root);
+}
+
+/**
+ * Describe every setting that affects a decode, so a captured frame can be replayed with the same settings
+ */
+static std::string CaptureSettingsJson(const ConfigVariants& variants, const DecodeOptions& options) {
+    cJSON* root = cJSON_CreateObject();
+    
+    cJSON* decoders = cJSON_CreateArray();
+    for (DecoderType decoder : variants.EnabledDecoders()) {
+        cJSON_AddItemToArray(decoders, cJSON_CreateNumber(static_cast<int>(decoder)));
+    }
+    cJSON_AddItemToObject(root, "decoders", decoders);
+    cJSON_AddNumberToObject(root, "decodingSpeed", static_cast<int>(variants.BaseSpeed()));
+    cJSON_AddNumberToObject(root, "maximumResultsCount", variants.MaximumResultsCount());
+    
+    const Rect& roi = variants.RegionOfInterest();
+    double regionOfInterest[4] = { roi.left, roi.top, roi.width, roi.height };
+    cJSON_AddItemToObject(root, "regionOfInterest", cJSON_CreateDoubleArray(regionOfInterest, 4));
+    
+    cJSON* cascade = cJSON_CreateObject();
+    cJSON* speeds = cJSON_CreateArray();
+    for (DecodingSpeed speed : options.cascade.speeds) {
+        cJSON_AddItemToArray(speeds, cJSON_CreateNumber(static_cast<int>(speed)));
+    }
+    cJSON_AddItemToObject(cascade, "speeds", speeds);
+    cJSON_AddNumberToObject(cascade, "timeBudgetMs", options.cascade.timeBudgetMs);
+    cJSON_AddItemToObject(root, "cascade", cascade);
+    
+    cJSON* pyramid = cJSON_CreateObject();
+    cJSON_AddNumberToObject(pyramid, "factor", options.pyramid.factor);
+    cJSON_AddNumberToObject(pyramid, "minPixels", options.pyramid.minPixels);
+    cJSON_AddBoolToObject(pyramid, "fullFrameFallback", options.pyramid.fullFrameFallback);
+    cJSON_AddItemToObject(root, "pyramid", pyramid);
+    
+    cJSON* tiles = cJSON_CreateObject();
+    cJSON_AddNumberToObject(tiles, "maxBarcodeSize", options.tiles.maxBarcodeSize);
+    cJSON_AddNumberToObject(tiles, "minPixels", options.tiles.minPixels);
+    cJSON_AddItemToObject(root, "tiles", tiles);
+    
+    char* jsonString = cJSON_PrintUnformatted(root);
+    std::string settings(jsonString);
+    cJSON_Delete(root);
+    JsonArena::Release(jsonString);
+    return settings;
+}
+
+/**
+ * Whether any decode strategy is enabled
+ */
+static bool StrategiesEnabled(const DecodeOptions& options) {
+    return !options.cascade.speeds.empty() || options.pyramid.factor > 1 || options.tiles.maxBarcodeSize > 0;
+}
+
+// Deadline of requests that did not pass a time budget
+static const DecodeStats::Clock::time_point kNoDeadline = DecodeStats::Clock::time_point::max();
+
+/**
+ * Deadline of a request from its optional time budget argument
+ * @param index - Position of the budget in milliseconds; missing or negative means no deadline
+ * @param received - When the request arrived, the budget counts from there
+ */
+static DecodeStats::Clock::time_point DeadlineArgument(const Napi::CallbackInfo& info, size_t index,
+                                                       DecodeStats::Clock::time_point received) {
+    if (info.Length() <= index || !info[index].IsNumber()) {
+        return kNoDeadline;
+    }
+    double budgetMs = info[index].As<Napi::Number>().DoubleValue();
+    // Negative, NaN and budgets too long to represent all mean no deadline
+    if (!(budgetMs >= 0) || budgetMs > 1e12) {
+        return kNoDeadline;
+    }
+    return received + std::chrono::duration_cast<DecodeStats::Clock::duration>(std::chrono::duration<double, std::milli>(budgetMs));
+}
+
+/**
+ * Queue of a request from its optional priority argument (0 = interactive, 1 = bulk)
+ */
+static DecodeLane LaneArgument(const Napi::CallbackInfo& info, size_t index) {
+    if (info.Length() > index && info[index].IsNumber() &&
+        info[index].As<Napi::Number>().Int32Value() == static_cast<int>(DecodeLane::Bulk)) {
+        return DecodeLane::Bulk;
+    }
+    return DecodeLane::Interactive;
+}
+
+/**
+ * Current decode options, copied into storage only when the request has a deadline
+ */
+static const DecodeOptions& WithDeadline(DecodeStats::Clock::time_point deadline, DecodeOptions& storage) {
+    if (deadline == kNoDeadline) {
+        return decodeOptions;
+    }
+    storage = decodeOptions;
+    storage.deadline = deadline;
+    return storage;
+}
+
+/**
+ * Decode barcode from image buffer
+ * @param imageBuffer - Buffer containing grayscale image data
+ * @param width - Image width in pixels
+ * @param height - Image height in pixels
+ * @param budgetMs - Time budget from now (optional); escalation stops when it runs short
+ */
+Napi::String DecodeImage(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto received = DecodeStats::Clock::now();
+    
+    if (!config) {
+        return Napi::String::New(env, initializing ? "ERROR: SDK still initializing, await initializeAsync() first"
+                                                   : "ERROR: SDK not initialized");
+    }
+    
+    if (info.Length() < 3 || !info[0].IsBuffer() || !info[1].IsNumber() || !info[2].IsNumber()) {
+        return Napi::String::New(env, "ERROR: Buffer and two numbers expected (imageBuffer, width, height)");
+    }
+    
+    try {
+        Napi::Buffer<uint8_t> buffer = info[0].As<Napi::Buffer<uint8_t>>();
+        int width = info[1].As<Napi::Number>().Int32Value();
+        int height = info[2].As<Napi::Number>().Int32Value();
+        
+        uint8_t* imageData = buffer.Data();
+        size_t bufferLength = buffer.Length();
+        
+        // Validate buffer size
+        if (bufferLength < static_cast<size_t>(width * height)) {
+            return Napi::String::New(env, "ERROR: Buffer too small for specified dimensions");
+        }
+        
+        // Decode the image
+        DecodeOutcome outcome;
+        bool strategies = StrategiesEnabled(decodeOptions);
+        DecodeOptions deadlineOptions;
+        const DecodeOptions& options = WithDeadline(DeadlineArgument(info, 3, received), deadlineOptions);
+        std::shared_ptr<ConfigVariants> variants = GetConfigVariants();
+        auto decodeStart = DecodeStats::Clock::now();
+        BK_PROBE_DECODE_START(width, height, static_cast<int>(variants->BaseSpeed()));
+        
+        if (strategies || options.deadline != kNoDeadline) {
+            std::shared_ptr<DecodePool> pool = options.tiles.maxBarcodeSize > 0 ? GetDecodePool() : nullptr;
+            outcome = Decode(*variants, options, pool.get(), imageData, width, height);
+        } else {
+            outcome.decodingSpeed = config->decodingSpeed;
+            outcome.attempts = 1;
+            TraceSpan span("DecodeImageMemory", "speed", static_cast<int64_t>(config->decodingSpeed));
+            outcome.results = DecodeWithSdk(config, imageData, width, height);
         }
         
+        auto decodeEnd = DecodeStats::Clock::now();
+        BK_PROBE_DECODE_DONE(width, height, static_cast<int>(outcome.decodingSpeed), outcome.results.size(),
+                             std::chrono::duration_cast<std::chrono::nanoseconds>(decodeEnd - decodeStart).count());
+        std::string resultJson = ResultsToJson(outcome, strategies ? &decodeOptions : nullptr);
+        Napi::String result = Napi::String::New(env, resultJson);
+        auto marshalEnd = DecodeStats::Clock::now();
+        
+        Tracer::Complete("unpackArguments", received, decodeStart);
+        Tracer::Complete("decode", decodeStart, decodeEnd, "results", static_cast<int64_t>(outcome.results.size()));
+        Tracer::Complete("buildResult", decodeEnd, marshalEnd);
+        
+        SizeBucket size = DecodeStats::SizeBucketFor(width, height);
+        DecodeStats::Record(DecodeStage::Conversion, outcome.decodingSpeed, size, received, decodeStart);
+        if (outcome.attempts > 0) {
+            // Requests skipped for their deadline would skew the decode latencies
+            DecodeStats::Record(DecodeStage::Decode, outcome.decodingSpeed, size, decodeStart, decodeEnd);
+            DecodeStats::RecordOutcome(variants->DecoderSet(), outcome.results,
+                                       std::chrono::duration_cast<std::chrono::nanoseconds>(decodeEnd - decodeStart).count());
+        }
+        DecodeStats::Record(DecodeStage::Marshal, outcome.decodingSpeed, size, decodeEnd, marshalEnd);
+        DecodeStats::Record(DecodeStage::Total, outcome.decodingSpeed, size, received, marshalEnd);
+        StartupTimeline::FirstDecode(received, marshalEnd);
+        
+        if (FrameCapture::Sample()) {
+            CapturedFrame frame;
+            frame.received = received;
+            frame.width = width;
+            frame.height = height;
+            frame.pixels.assign(imageData, imageData + static_cast<size_t>(width) * height);
+            frame.settings = CaptureSettingsJson(*variants, decodeOptions);
+            frame.result = std::move(resultJson);
+            frame.decodeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(decodeEnd - decodeStart).count();
+            frame.totalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(marshalEnd - received).count();
+            FrameCapture::Record(std::move(frame));
+        }
+        ReportExternalMemory(env);
+        
+        return result;
+        
     } catch (const std::exception& e) {
         return Napi::String::New(env, "ERROR: " + std::string(e.what()));
     }
 }
 
+/**
+ * A decode request running on the decode pool
+ */
+struct AsyncDecodeJob {
+    explicit AsyncDecodeJob(Napi::Env env) : deferred(Napi::Promise::Deferred::New(env)) {}
+    
+    Napi::Promise::Deferred deferred;
+    Napi::Reference<Napi::Buffer<uint8_t>> buffer; // Keeps the pixels alive until the job completes
+    MemoryCharge pinned{MemoryCategory::PinnedFrames};
+    JobAbort abort;
+    uint8_t* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    std::shared_ptr<ConfigVariants> variants;
+    DecodeOptions options;
+    bool strategies = false;
+    std::shared_ptr<DecodePool> pool;
+    DecodeLane lane = DecodeLane::Interactive;
+    
+    DecodeStats::Clock::time_point received;
+    DecodeStats::Clock::time_point deadline = kNoDeadline;
+    DecodeStats::Clock::time_point queued;
+    DecodeStats::Clock::time_point posted;
+    uint64_t marshalNs = 0;
+    DecodingSpeed decodingSpeed = DecodingSpeed::Normal;
+    std::string result;
+    MemoryCharge resultCharge{MemoryCategory::ResultBuffers};
+    
+    bool capture = false;
+    std::unique_ptr<CapturedFrame> frame; // Filled by the worker when the request is captured
+};
+
+// Result of a decode stopped by its AbortSignal
+static const char* const kDecodeAborted = "ERROR: Decode aborted";
+
+/**
+ * Resolve a finished job's promise on the JavaScript thread
+ */
+static void CompleteAsyncDecode(Napi::Env env, Napi::Function, AsyncDecodeJob* job) {
+    if (job->abort.Dropped()) {
+        // Settled when it was dropped, the worker only handed it back
+        delete job;
+        RemovePendingAsyncJob(env);
+        return;
+    }
+    
+    auto marshalStart = DecodeStats::Clock::now();
+    job->deferred.Resolve(Napi::String::New(env, job->result));
+    auto completed = DecodeStats::Clock::now();
+    
+    Tracer::Complete("completionHandoff", job->posted, marshalStart);
+    Tracer::Complete("resolvePromise", marshalStart, completed);
+    
+    SizeBucket size = DecodeStats::SizeBucketFor(job->width, job->height);
+    uint64_t marshalNs = job->marshalNs + std::chrono::duration_cast<std::chrono::nanoseconds>(completed - marshalStart).count();
+    DecodeStats::Record(DecodeStage::Marshal, job->decodingSpeed, size, marshalNs);
+    DecodeStats::Record(DecodeStage::Total, job->decodingSpeed, size, job->received, completed);
+    StartupTimeline::FirstDecode(job->received, completed);
+    
+    if (job->frame) {
+        job->frame->totalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(completed - job->received).count();
+        FrameCapture::Record(std::move(*job->frame));
+    }
+    
+    delete job;
+    RemovePendingAsyncJob(env);
+    ReportExternalMemory(env);
+}
+
+/**
+ * Decode a job on a pool worker and post it back for completion
+ */
+static void RunAsyncDecode(AsyncDecodeJob* job) {
+    if (!job->abort.Start()) {
+        asyncCompletions.NonBlockingCall(job, CompleteAsyncDecode);
+        return;
+    }
+    
+    auto started = DecodeStats::Clock::now();
+    SizeBucket size = DecodeStats::SizeBucketFor(job->width, job->height);
+    BK_PROBE_QUEUE_DEQUEUE(job, std::chrono::duration_cast<std::chrono::nanoseconds>(started - job->queued).count());
+    BK_PROBE_DECODE_START(job->width, job->height, static_cast<int>(job->decodingSpeed));
+    
+    try {
+        DecodePool* pool = job->options.tiles.maxBarcodeSize > 0 ? job->pool.get() : nullptr;
+        DecodeOutcome outcome = Decode(*job->variants, job->options, pool, job->pixels, job->width, job->height);
+        auto decoded = DecodeStats::Clock::now();
+        BK_PROBE_DECODE_DONE(job->width, job->height, static_cast<int>(outcome.decodingSpeed), outcome.results.size(),
+                             std::chrono::duration_cast<std::chrono::nanoseconds>(decoded - started).count());
+        
+        // Nobody reads the partial results of an aborted decode
+        job->result = outcome.aborted ? kDecodeAborted : ResultsToJson(outcome, job->strategies ? &job->options : nullptr);
+        job->decodingSpeed = outcome.decodingSpeed;
+        job->marshalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(DecodeStats::Clock::now() - decoded).count();
+        
+        Tracer::Complete("decode", started, decoded, "results", static_cast<int64_t>(outcome.results.size()));
+        Tracer::Complete("buildResult", decoded, DecodeStats::Clock::now());
+        
+        if (outcome.attempts > 0) {
+            DecodeStats::Record(DecodeStage::Decode, outcome.decodingSpeed, size, started, decoded);
+        }
+        if (outcome.attempts > 0 && !outcome.aborted) {
+            DecodeStats::RecordOutcome(job->variants->DecoderSet(), outcome.results,
+                                       std::chrono::duration_cast<std::chrono::nanoseconds>(decoded - started).count());
+        }
+        
+        if (job->capture && !outcome.aborted) {
+            // Copied here rather than on the JavaScript thread, the buffer stays pinned until completion
+            job->frame.reset(new CapturedFrame());
+            job->frame->received = job->received;
+            job->frame->async = true;
+            job->frame->width = job->width;
+            job->frame->height = job->height;
+            job->frame->pixels.assign(job->pixels, job->pixels + static_cast<size_t>(job->width) * job->height);
+            job->frame->settings = CaptureSettingsJson(*job->variants, job->options);
+            job->frame->result = job->result;
+            job->frame->queueNs = std::chrono::duration_cast<std::chrono::nanoseconds>(started - job->queued).count();
+            job->frame->decodeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(decoded - started).count();
+        }
+    } catch (const std::exception& e) {
+        job->result = "ERROR: " + std::string(e.what());
+    }
+    job->resultCharge.Set(job->result.capacity());
+    
+    DecodeStats::Record(DecodeStage::QueueWait, job->decodingSpeed, size, job->queued, started);
+    Tracer::Complete("queueWait", job->queued, started);
+    
+    job->posted = DecodeStats::Clock::now();
+    asyncCompletions.NonBlockingCall(job, CompleteAsyncDecode);
+}
+
+/**
+ * Queue a job on the decode pool with the current settings
+ * @param unpacked - When its arguments were unpacked, earlier than now if it waited for initializeAsync
+ */
+static void SubmitAsyncDecode(AsyncDecodeJob* job, DecodeStats::Clock::time_point unpacked) {
+    job->variants = GetConfigVariants();
+    job->options = decodeOptions;
+    job->options.abort = &job->abort.requested;
+    job->options.deadline = job->deadline;
+    job->strategies = StrategiesEnabled(decodeOptions);
+    job->decodingSpeed = config->decodingSpeed;
+    job->pool = GetDecodePool();
+    job->capture = FrameCapture::Sample();
+    
+    job->queued = DecodeStats::Clock::now();
+    DecodeStats::Record(DecodeStage::Conversion, job->decodingSpeed, DecodeStats::SizeBucketFor(job->width, job->height),
+                        job->received, unpacked);
+    Tracer::Complete("unpackArguments", job->received, unpacked);
+    Tracer::Instant("enqueue", "pending", pendingAsyncJobs);
+    BK_PROBE_QUEUE_ENQUEUE(job, pendingAsyncJobs);
+    job->pool->Submit([job] { RunAsyncDecode(job); }, job->lane);
+}
+
+/**
+ * Abort an async decode: settle it and release its pixels if it is still queued,
+ * otherwise stop it at its next cascade level, crop or tile
+ */
+static void AbortAsyncDecode(AsyncDecodeJob* job) {
+    if (job->abort.Abort()) {
+        job->deferred.Resolve(Napi::String::New(job->deferred.Env(), kDecodeAborted));
+        job->buffer.Reset();
+        job->pinned.Set(0);
+    }
+}
+
+/**
+ * Decode barcode from image buffer on a native worker thread
+ * @param imageBuffer - Buffer containing grayscale image data, must not be modified until the promise settles
+ * @param width - Image width in pixels
+ * @param height - Image height in pixels
+ * @param signalId - Id abortDecode() stops this decode with (optional, 0 = not abortable)
+ * @param budgetMs - Time budget from now (optional); skipped if it has run out before a worker is free
+ * @param priority - Queue to wait in (optional, 0 = interactive, 1 = bulk)
+ * @returns Promise of the same JSON string decodeImage returns
+ */
+Napi::Value DecodeImageAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    AsyncDecodeJob* job = new AsyncDecodeJob(env);
+    Napi::Promise promise = job->deferred.Promise();
+    job->received = DecodeStats::Clock::now();
+    
+    if (!config && !initializing) {
+        job->deferred.Resolve(Napi::String::New(env, "ERROR: SDK not initialized"));
+        delete job;
+        return promise;
+    }
+    
+    if (info.Length() < 3 || !info[0].IsBuffer() || !info[1].IsNumber() || !info[2].IsNumber()) {
+        job->deferred.Resolve(Napi::String::New(env, "ERROR: Buffer and two numbers expected (imageBuffer, width, height)"));
+        delete job;
+        return promise;
+    }
+    
+    Napi::Buffer<uint8_t> buffer = info[0].As<Napi::Buffer<uint8_t>>();
+    job->width = info[1].As<Napi::Number>().Int32Value();
+    job->height = info[2].As<Napi::Number>().Int32Value();
+    if (info.Length() > 3 && info[3].IsNumber()) {
+        job->abort.signalId = info[3].As<Napi::Number>().Uint32Value();
+    }
+    job->deadline = DeadlineArgument(info, 4, job->received);
+    job->lane = LaneArgument(info, 5);
+    
+    if (job->width <= 0 || job->height <= 0 || buffer.Length() < static_cast<size_t>(job->width) * job->height) {
+        job->deferred.Resolve(Napi::String::New(env, "ERROR: Buffer too small for specified dimensions"));
+        delete job;
+        return promise;
+    }
+    
+    {
+        TraceSpan span("pinBuffer");
+        job->buffer = Napi::Reference<Napi::Buffer<uint8_t>>::New(buffer, 1);
+        job->pinned.Set(buffer.Length());
+        job->pixels = buffer.Data();
+    }
+    AddPendingAsyncJob(env);
+    job->abort.Watch([job] { AbortAsyncDecode(job); });
+    
+    if (!config) {
+        // Picks up the settings in effect once initialization finishes
+        auto unpacked = DecodeStats::Clock::now();
+        awaitingInit.push_back([job, unpacked](Napi::Env env, bool ready) {
+            Tracer::Complete("awaitInitialize", unpacked, DecodeStats::Clock::now());
+            if (ready && !job->abort.Dropped()) {
+                SubmitAsyncDecode(job, unpacked);
+                return;
+            }
+            if (!job->abort.Dropped()) {
+                job->deferred.Resolve(Napi::String::New(env, "ERROR: SDK not initialized"));
+            }
+            delete job;
+            RemovePendingAsyncJob(env);
+        });
+        return promise;
+    }
+    
+    SubmitAsyncDecode(job, DecodeStats::Clock::now());
+    return promise;
+}
+
+// View of the attached SharedArrayBuffer, referenced so it outlives every write into it
+Napi::Reference<Napi::Uint8Array> resultRingView;
+
+/**
+ * Start writing decodeToRing results into shared memory
+ * @param view - Uint8Array over a SharedArrayBuffer, replacing any attached ring
+ * @param slots - Records kept before the oldest is overwritten
+ * @param maxResults - Barcodes stored per record
+ * @param textBytes - UTF-8 text bytes stored per record
+ */
+Napi::Number AttachResultRing(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 4 || !info[0].IsTypedArray() || !info[1].IsNumber() || !info[2].IsNumber() || !info[3].IsNumber()) {
+        return StatusError(env, StatusCode::InvalidArgument, "Uint8Array, slots, maximum results and text bytes expected");
+    }
+    
+    Napi::TypedArray typedArray = info[0].As<Napi::TypedArray>();
+    int slots = info[1].As<Napi::Number>().Int32Value();
+    int maxResults = info[2].As<Napi::Number>().Int32Value();
+    int textBytes = info[3].As<Napi::Number>().Int32Value();
+    if (typedArray.TypedArrayType() != napi_uint8_array || slots <= 0 || maxResults <= 0 || textBytes < 0) {
+        return StatusError(env, StatusCode::InvalidArgument, "Uint8Array and positive sizes expected");
+    }
+    
+    RingLayout layout;
+    layout.slots = static_cast<uint32_t>(slots);
+    layout.maxResults = static_cast<uint32_t>(maxResults);
+    layout.textBytes = static_cast<uint32_t>(textBytes);
+    
+    Napi::Uint8Array view = typedArray.As<Napi::Uint8Array>();
+    std::string error;
+    if (!ResultRing::Attach(view.Data(), view.ByteLength(), layout, error)) {
+        return StatusError(env, StatusCode::InvalidArgument, error);
+    }
+    // Pool workers may still be writing into the previous ring until Attach returns
+    resultRingView = Napi::Reference<Napi::Uint8Array>::New(view, 1);
+    resultRingView.SuppressDestruct(); // Released by detach, not by static destruction after the environment is gone
+    return StatusOk(env);
+}
+
+/**
+ * Stop writing results into shared memory
+ */
+Napi::Number DetachResultRing(const Napi::CallbackInfo& info) {
+    ResultRing::Detach();
+    resultRingView.Reset();
+    return StatusOk(info.Env());
+}
+
+/**
+ * Publish one decode to the ring and record its statistics
+ */
+static void PublishToRing(RingRecord& record, const DecodeOutcome& outcome, DecodeStats::Clock::time_point decodeStart,
+                          DecodeStats::Clock::time_point decodeEnd) {
+    record.decodingSpeed = static_cast<int>(outcome.decodingSpeed);
+    record.flags = outcome.deadlineExceeded ? ResultRing::kFlagDeadlineExceeded : 0;
+    record.results = &outcome.results;
+    record.decodeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(decodeEnd - decodeStart).count();
+    record.totalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(DecodeStats::Clock::now() - record.received).count();
+    ResultRing::Publish(record);
+    
+    auto published = DecodeStats::Clock::now();
+    Tracer::Complete("decode", decodeStart, decodeEnd, "results", static_cast<int64_t>(outcome.results.size()));
+    Tracer::Complete("publishRecord", decodeEnd, published);
+    
+    SizeBucket size = DecodeStats::SizeBucketFor(record.width, record.height);
+    if (outcome.attempts > 0) {
+        DecodeStats::Record(DecodeStage::Decode, outcome.decodingSpeed, size, decodeStart, decodeEnd);
+    }
+    DecodeStats::Record(DecodeStage::Marshal, outcome.decodingSpeed, size, decodeEnd, published);
+    DecodeStats::Record(DecodeStage::Total, outcome.decodingSpeed, size, record.received, published);
+    StartupTimeline::FirstDecode(record.received, published);
+}
+
+/**
+ * Publish a failed decode to the ring so the reader sees every frame id
+ */
+static void PublishFailureToRing(RingRecord& record, StatusCode status) {
+    record.status = static_cast<int32_t>(status);
+    record.totalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(DecodeStats::Clock::now() - record.received).count();
+    ResultRing::Publish(record);
+}
+
+/**
+ * Capture a ring decode, building the JSON result only for sampled frames
+ */
+static void CaptureRingDecode(CapturedFrame* frame, const RingRecord& record, const DecodeOutcome& outcome,
+                              const ConfigVariants& variants, const DecodeOptions& options, const uint8_t* pixels) {
+    frame->received = record.received;
+    frame->width = record.width;
+    frame->height = record.height;
+    frame->pixels.assign(pixels, pixels + static_cast<size_t>(record.width) * record.height);
+    frame->settings = CaptureSettingsJson(variants, options);
+    frame->result = ResultsToJson(outcome, StrategiesEnabled(options) ? &options : nullptr);
+    frame->decodeNs = record.decodeNs;
+    frame->totalNs = record.totalNs;
+}
+
+/**
+ * Decode barcode from image buffer into the attached result ring
+ * @param imageBuffer - Buffer containing grayscale image data
+ * @param width - Image width in pixels
+ * @param height - Image height in pixels
+ * @param frameId - Caller's tag, copied into the record
+ * @param budgetMs - Time budget from now (optional); escalation stops when it runs short
+ * @returns Status code; results are read from the ring
+ */
+Napi::Number DecodeToRing(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    RingRecord record;
+    record.received = DecodeStats::Clock::now();
+    
+    if (!config) {
+        return StatusError(env, StatusCode::NotInitialized, "SDK not initialized");
+    }
+    if (!ResultRing::Attached()) {
+        return StatusError(env, StatusCode::InvalidArgument, "No result ring attached");
+    }
+    if (info.Length() < 4 || !info[0].IsBuffer() || !info[1].IsNumber() || !info[2].IsNumber() || !info[3].IsNumber()) {
+        return StatusError(env, StatusCode::InvalidArgument, "Buffer and three numbers expected (imageBuffer, width, height, frameId)");
+    }
+    
+    Napi::Buffer<uint8_t> buffer = info[0].As<Napi::Buffer<uint8_t>>();
+    record.width = info[1].As<Napi::Number>().Int32Value();
+    record.height = info[2].As<Napi::Number>().Int32Value();
+    record.frameId = info[3].As<Napi::Number>().Int32Value();
+    if (record.width <= 0 || record.height <= 0 || buffer.Length() < static_cast<size_t>(record.width) * record.height) {
+        return StatusError(env, StatusCode::InvalidArgument, "Buffer too small for specified dimensions");
+    }
+    
+    DecodeOptions deadlineOptions;
+    const DecodeOptions& options = WithDeadline(DeadlineArgument(info, 4, record.received), deadlineOptions);
+    std::shared_ptr<ConfigVariants> variants = GetConfigVariants();
+    auto decodeStart = DecodeStats::Clock::now();
+    Tracer::Complete("unpackArguments", record.received, decodeStart);
+    DecodeStats::Record(DecodeStage::Conversion, config->decodingSpeed, DecodeStats::SizeBucketFor(record.width, record.height),
+                        record.received, decodeStart);
+    
+    try {
+        std::shared_ptr<DecodePool> pool = options.tiles.maxBarcodeSize > 0 ? GetDecodePool() : nullptr;
+        BK_PROBE_DECODE_START(record.width, record.height, static_cast<int>(variants->BaseSpeed()));
+        DecodeOutcome outcome = Decode(*variants, options, pool.get(), buffer.Data(), record.width, record.height);
+        auto decodeEnd = DecodeStats::Clock::now();
+        BK_PROBE_DECODE_DONE(record.width, record.height, static_cast<int>(outcome.decodingSpeed), outcome.results.size(),
+                             std::chrono::duration_cast<std::chrono::nanoseconds>(decodeEnd - decodeStart).count());
+        
+        PublishToRing(record, outcome, decodeStart, decodeEnd);
+        if (outcome.attempts > 0) {
+            DecodeStats::RecordOutcome(variants->DecoderSet(), outcome.results, record.decodeNs);
+        }
+        
+        if (FrameCapture::Sample()) {
+            CapturedFrame frame;
+            CaptureRingDecode(&frame, record, outcome, *variants, options, buffer.Data());
+            FrameCapture::Record(std::move(frame));
+        }
+        ReportExternalMemory(env);
+        return StatusOk(env);
+        
+    } catch (const std::exception& e) {
+        PublishFailureToRing(record, StatusCode::SdkError);
+        return StatusError(env, StatusCode::SdkError, e.what());
+    }
+}
+
+/**
+ * A ring decode running on the decode pool, completed without creating JavaScript objects
+ */
+struct RingDecodeJob {
+    Napi::Reference<Napi::Buffer<uint8_t>> buffer; // Keeps the pixels alive until the job completes
+    MemoryCharge pinned{MemoryCategory::PinnedFrames};
+    JobAbort abort;
+    uint8_t* pixels = nullptr;
+    std::shared_ptr<ConfigVariants> variants;
+    DecodeOptions options;
+    std::shared_ptr<DecodePool> pool;
+    DecodeLane lane = DecodeLane::Interactive;
+    RingRecord record;
+    DecodeStats::Clock::time_point deadline = kNoDeadline;
+    DecodeStats::Clock::time_point queued;
+    bool capture = false;
+    std::unique_ptr<CapturedFrame> frame;
+};
+
+/**
+ * Release a finished ring job's buffer on the JavaScript thread
+ */
+static void CompleteRingDecode(Napi::Env env, Napi::Function, RingDecodeJob* job) {
+    if (job->frame) {
+        FrameCapture::Record(std::move(*job->frame));
+    }
+    delete job;
+    RemovePendingAsyncJob(env);
+    ReportExternalMemory(env);
+}
+
+/**
+ * Decode a ring job on a pool worker and publish its record from there
+ */
+static void RunRingDecode(RingDecodeJob* job) {
+    if (!job->abort.Start()) {
+        // Its aborted record was published when it was dropped
+        asyncCompletions.NonBlockingCall(job, CompleteRingDecode);
+        return;
+    }
+    
+    RingRecord& record = job->record;
+    auto started = DecodeStats::Clock::now();
+    BK_PROBE_QUEUE_DEQUEUE(job, std::chrono::duration_cast<std::chrono::nanoseconds>(started - job->queued).count());
+    BK_PROBE_DECODE_START(record.width, record.height, static_cast<int>(job->variants->BaseSpeed()));
+    
+    try {
+        DecodePool* pool = job->options.tiles.maxBarcodeSize > 0 ? job->pool.get() : nullptr;
+        DecodeOutcome outcome = Decode(*job->variants, job->options, pool, job->pixels, record.width, record.height);
+        auto decoded = DecodeStats::Clock::now();
+        BK_PROBE_DECODE_DONE(record.width, record.height, static_cast<int>(outcome.decodingSpeed), outcome.results.size(),
+                             std::chrono::duration_cast<std::chrono::nanoseconds>(decoded - started).count());
+        
+        DecodeStats::Record(DecodeStage::QueueWait, outcome.decodingSpeed, DecodeStats::SizeBucketFor(record.width, record.height),
+                            job->queued, started);
+        if (outcome.aborted) {
+            PublishFailureToRing(record, StatusCode::Aborted);
+        } else {
+            PublishToRing(record, outcome, started, decoded);
+            if (outcome.attempts > 0) {
+                DecodeStats::RecordOutcome(job->variants->DecoderSet(), outcome.results, record.decodeNs);
+            }
+        }
+        
+        if (job->capture && !outcome.aborted) {
+            job->frame.reset(new CapturedFrame());
+            CaptureRingDecode(job->frame.get(), record, outcome, *job->variants, job->options, job->pixels);
+            job->frame->async = true;
+            job->frame->queueNs = std::chrono::duration_cast<std::chrono::nanoseconds>(started - job->queued).count();
+        }
+    } catch (const std::exception&) {
+        PublishFailureToRing(record, StatusCode::SdkError);
+    }
+    
+    Tracer::Complete("queueWait", job->queued, started);
+    asyncCompletions.NonBlockingCall(job, CompleteRingDecode);
+}
+
+/**
+ * Queue a ring job on the decode pool with the current settings
+ * @param unpacked - When its arguments were unpacked, earlier than now if it waited for initializeAsync
+ */
+static void SubmitRingDecode(RingDecodeJob* job, DecodeStats::Clock::time_point unpacked) {
+    job->variants = GetConfigVariants();
+    job->options = decodeOptions;
+    job->options.abort = &job->abort.requested;
+    job->options.deadline = job->deadline;
+    job->pool = GetDecodePool();
+    job->capture = FrameCapture::Sample();
+    
+    job->queued = DecodeStats::Clock::now();
+    DecodeStats::Record(DecodeStage::Conversion, config->decodingSpeed, DecodeStats::SizeBucketFor(job->record.width, job->record.height),
+                        job->record.received, unpacked);
+    Tracer::Complete("unpackArguments", job->record.received, unpacked);
+    BK_PROBE_QUEUE_ENQUEUE(job, pendingAsyncJobs);
+    job->pool->Submit([job] { RunRingDecode(job); }, job->lane);
+}
+
+/**
+ * Abort a ring decode: publish its aborted record and release its pixels if it is
+ * still queued, otherwise stop it at its next cascade level, crop or tile
+ */
+static void AbortRingDecode(RingDecodeJob* job) {
+    if (job->abort.Abort()) {
+        PublishFailureToRing(job->record, StatusCode::Aborted);
+        job->buffer.Reset();
+        job->pinned.Set(0);
+    }
+}
+
+/**
+ * Decode barcode from image buffer on a native worker thread into the attached result ring
+ * @param imageBuffer - Buffer containing grayscale image data, must not be modified until the record is published
+ * @param width - Image width in pixels
+ * @param height - Image height in pixels
+ * @param frameId - Caller's tag, copied into the record
+ * @param signalId - Id abortDecode() stops this decode with (optional, 0 = not abortable)
+ * @param budgetMs - Time budget from now (optional); skipped if it has run out before a worker is free
+ * @param priority - Queue to wait in (optional, 0 = interactive, 1 = bulk)
+ * @returns Status code of queuing the decode; results are read from the ring
+ */
+Napi::Number DecodeToRingAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto received = DecodeStats::Clock::now();
+    
+    if (!config && !initializing) {
+        return StatusError(env, StatusCode::NotInitialized, "SDK not initialized");
+    }
+    if (!ResultRing::Attached()) {
+        return StatusError(env, StatusCode::InvalidArgument, "No result ring attached");
+    }
+    if (info.Length() < 4 || !info[0].IsBuffer() || !info[1].IsNumber() || !info[2].IsNumber() || !info[3].IsNumber()) {
+        return StatusError(env, StatusCode::InvalidArgument, "Buffer and three numbers expected (imageBuffer, width, height, frameId)");
+    }
+    
+    Napi::Buffer<uint8_t> buffer = info[0].As<Napi::Buffer<uint8_t>>();
+    int width = info[1].As<Napi::Number>().Int32Value();
+    int height = info[2].As<Napi::Number>().Int32Value();
+    if (width <= 0 || height <= 0 || buffer.Length() < static_cast<size_t>(width) * height) {
+        return StatusError(env, StatusCode::InvalidArgument, "Buffer too small for specified dimensions");
+    }
+    
+    RingDecodeJob* job = new RingDecodeJob();
+    job->record.received = received;
+    job->record.width = width;
+    job->record.height = height;
+    job->record.frameId = info[3].As<Napi::Number>().Int32Value();
+    job->buffer = Napi::Reference<Napi::Buffer<uint8_t>>::New(buffer, 1);
+    job->pinned.Set(buffer.Length());
+    job->pixels = buffer.Data();
+    if (info.Length() > 4 && info[4].IsNumber()) {
+        job->abort.signalId = info[4].As<Napi::Number>().Uint32Value();
+    }
+    job->deadline = DeadlineArgument(info, 5, received);
+    job->lane = LaneArgument(info, 6);
+    AddPendingAsyncJob(env);
+    job->abort.Watch([job] { AbortRingDecode(job); });
+    
+    if (!config) {
+        // Picks up the settings in effect once initialization finishes
+        auto unpacked = DecodeStats::Clock::now();
+        awaitingInit.push_back([job, unpacked](Napi::Env env, bool ready) {
+            Tracer::Complete("awaitInitialize", unpacked, DecodeStats::Clock::now());
+            if (ready && !job->abort.Dropped()) {
+                SubmitRingDecode(job, unpacked);
+                return;
+            }
+            if (!job->abort.Dropped()) {
+                PublishFailureToRing(job->record, StatusCode::NotInitialized);
+            }
+            delete job;
+            RemovePendingAsyncJob(env);
+        });
+        return StatusOk(env);
+    }
+    
+    SubmitRingDecode(job, DecodeStats::Clock::now());
+    return StatusOk(env);
+}
+
+/**
+ * Abort every queued and running async decode submitted with an AbortSignal
+ * @param signalId - Id the signal's decodes were submitted with
+ */
+Napi::Value AbortDecode(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        return env.Undefined();
+    }
+    
+    uint32_t signalId = info[0].As<Napi::Number>().Uint32Value();
+    auto range = abortableJobs.equal_range(signalId);
+    std::vector<std::function<void()>> handlers;
+    for (auto it = range.first; it != range.second; ++it) {
+        handlers.push_back(std::move(it->second.second));
+    }
+    // Later completions of these jobs find nothing to unregister
+    abortableJobs.erase(signalId);
+    
+    Tracer::Instant("abort", "jobs", static_cast<int64_t>(handlers.size()));
+    for (const std::function<void()>& handler : handlers) {
+        handler();
+    }
+    ReportExternalMemory(env);
+    return env.Undefined();
+}
+
+/**
+ * A warm-up running on its own thread
+ */
+struct WarmupJob {
+    explicit WarmupJob(Napi::Env env) : deferred(Napi::Promise::Deferred::New(env)) {}
+    
+    Napi::Promise::Deferred deferred;
+    WarmupOptions options;
+    std::shared_ptr<ConfigVariants> variants;
+    std::shared_ptr<DecodePool> pool;
+    std::string result;
+};
+
+// Warm-ups started and not finished, the running one first (JavaScript thread only). Warmup::Run holds every pool
+// worker until all of them have its task, so two at once could each hold some workers and wait for the rest forever.
+static std::deque<WarmupJob*> warmups;
+
+static void RunWarmup(WarmupJob* job);
+
+/**
+ * Resolve a finished warm-up's promise on the JavaScript thread and run the next one
+ */
+static void CompleteWarmup(Napi::Env env, Napi::Function, WarmupJob* job) {
+    // decodeImage builds its results on this thread, so its arena is warmed too
+    JsonArena::Prefault();
+    StartupTimeline::Mark(StartupEvent::WarmupDone);
+    job->deferred.Resolve(Napi::String::New(env, job->result));
+    warmups.pop_front();
+    delete job;
+    if (!warmups.empty()) {
+        RunWarmup(warmups.front());
+    }
+    RemovePendingAsyncJob(env);
+    ReportExternalMemory(env);
+}
+
+/**
+ * Run a warm-up now, or after the ones before it
+ */
+static void StartWarmup(WarmupJob* job) {
+    warmups.push_back(job);
+    if (warmups.size() == 1) {
+        RunWarmup(job);
+    }
+}
+
+/**
+ * Fill in the defaults from the current settings and run the warm-up
+ */
+static void RunWarmup(WarmupJob* job) {
+    StartupTimeline::Mark(StartupEvent::WarmupStart);
+    job->variants = GetConfigVariants();
+    job->pool = GetDecodePool();
+    
+    WarmupOptions& options = job->options;
+    if (options.decoders.empty()) {
+        options.decoders = job->variants->EnabledDecoders();
+    }
+    if (options.speeds.empty()) {
+        // Every speed a decode may use: the configured one and the cascade levels
+        options.speeds = decodeOptions.cascade.speeds;
+        if (std::find(options.speeds.begin(), options.speeds.end(), job->variants->BaseSpeed()) == options.speeds.end()) {
+            options.speeds.insert(options.speeds.begin(), job->variants->BaseSpeed());
+        }
+    }
+    if (options.resolutions.empty()) {
+        options.resolutions = { { 640, 480 }, { 1920, 1080 } };
+    }
+    
+    // Run blocks until every pool worker has taken part, so it must not run on one
+    std::thread([job] {
+        WarmupReport report = Warmup::Run(*job->variants, job->options, *job->pool);
+        job->result = PrintAndDeleteJson(report.ToJson());
+        asyncCompletions.NonBlockingCall(job, CompleteWarmup);
+    }).detach();
+}
+
+/**
+ * Run synthetic decodes on every decode worker so the first real decodes are not slowed by cold code and data.
+ * Starts after the warm-ups already running or waiting.
+ * @param decoders - Decoder types warmed one at a time (empty = the enabled decoders)
+ * @param resolutions - Flat array of synthetic image widths and heights (empty = 640x480 and 1920x1080)
+ * @param speeds - Decoding speeds (empty = the configured speed and the cascade speeds)
+ * @param repeats - Decodes per combination and worker, the last one is reported as warm
+ * @returns Promise of a JSON report with the time spent and per-combination timings
+ */
+Napi::Value WarmupDecoders(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    WarmupJob* job = new WarmupJob(env);
+    Napi::Promise promise = job->deferred.Promise();
+    
+    if (!config && !initializing) {
+        job->deferred.Resolve(Napi::String::New(env, "ERROR: SDK not initialized"));
+        delete job;
+        return promise;
+    }
+    
+    if (info.Length() < 4 || !info[0].IsArray() || !info[1].IsArray() || !info[2].IsArray() || !info[3].IsNumber()) {
+        job->deferred.Resolve(Napi::String::New(env, "ERROR: Decoder, resolution and speed arrays and a repeat count expected"));
+        delete job;
+        return promise;
+    }
+    
+    Napi::Array decoders = info[0].As<Napi::Array>();
+    Napi::Array resolutions = info[1].As<Napi::Array>();
+    Napi::Array speeds = info[2].As<Napi::Array>();
+    std::string error;
+    for (uint32_t i = 0; i < decoders.Length() && error.empty(); i++) {
+        Napi::Value element = decoders[i];
+        int decoder = element.IsNumber() ? element.As<Napi::Number>().Int32Value() : -1;
+        if (decoder < 0 || decoder > static_cast<int>(DecoderType::MaxiCode)) {
+            error = "Invalid decoder type";
+        }
+        job->options.decoders.push_back(static_cast<DecoderType>(decoder));
+    }
+    for (uint32_t i = 0; i + 1 < resolutions.Length() && error.empty(); i += 2) {
+        Napi::Value width = resolutions[i];
+        Napi::Value height = resolutions[i + 1];
+        if (!width.IsNumber() || !height.IsNumber() || width.As<Napi::Number>().Int32Value() <= 0 ||
+            height.As<Napi::Number>().Int32Value() <= 0) {
+            error = "Resolutions must be positive widths and heights";
+            break;
+        }
+        job->options.resolutions.emplace_back(width.As<Napi::Number>().Int32Value(), height.As<Napi::Number>().Int32Value());
+    }
+    for (uint32_t i = 0; i < speeds.Length() && error.empty(); i++) {
+        Napi::Value element = speeds[i];
+        int speed = element.IsNumber() ? element.As<Napi::Number>().Int32Value() : -1;
+        if (speed < static_cast<int>(DecodingSpeed::Fast) || speed > static_cast<int>(DecodingSpeed::Rigorous)) {
+            error = "Invalid speed";
+        }
+        job->options.speeds.push_back(static_cast<DecodingSpeed>(speed));
+    }
+    if (!error.empty()) {
+        job->deferred.Resolve(Napi::String::New(env, "ERROR: " + error));
+        delete job;
+        return promise;
+    }
+    job->options.repeats = std::max(1, info[3].As<Napi::Number>().Int32Value());
+    AddPendingAsyncJob(env);
+    
+    if (!config) {
+        awaitingInit.push_back([job](Napi::Env env, bool ready) {
+            if (ready) {
+                StartWarmup(job);
+                return;
+            }
+            job->deferred.Resolve(Napi::String::New(env, "ERROR: SDK not initialized"));
+            delete job;
+            RemovePendingAsyncJob(env);
+        });
+        return promise;
+    }
+    
+    StartWarmup(job);
+    return promise;
+}
+
+/**
+ * Get decode latency statistics since the last reset
+ * @returns JSON string with per-stage percentiles, broken down by decoding speed and image size
+ */
+Napi::String GetStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    cJSON* root = DecodeStats::ToJson();
+    
+    cJSON* queue = cJSON_CreateObject();
+    cJSON_AddNumberToObject(queue, "depth", decodePool ? static_cast<double>(decodePool->QueueDepth()) : 0);
+    cJSON_AddNumberToObject(queue, "threads", decodePool ? decodePool->ThreadCount() : 0);
+    cJSON_AddNumberToObject(queue, "pendingAsync", pendingAsyncJobs);
+    cJSON* lanes = cJSON_CreateObject();
+    for (int i = 0; i < static_cast<int>(DecodeLane::Count); i++) {
+        DecodeLane lane = static_cast<DecodeLane>(i);
+        cJSON_AddNumberToObject(lanes, DecodePool::LaneName(lane), decodePool ? static_cast<double>(decodePool->QueueDepth(lane)) : 0);
+    }
+    cJSON_AddItemToObject(queue, "lanes", lanes);
+    cJSON_AddNumberToObject(queue, "interactiveWeight", interactiveWeight);
+    cJSON_AddItemToObject(root, "queue", queue);
+    
+    return Napi::String::New(env, PrintAndDeleteJson(root));
+}
+
+/**
+ * Start decode statistics from zero
+ */
+Napi::Value ResetStats(const Napi::CallbackInfo& info) {
+    DecodeStats::Reset();
+    return info.Env().Undefined();
+}
+
+/**
+ * Start recording a timeline of decode stages
+ * @param capacity - Number of most recent events kept
+ */
+Napi::Number StartTracing(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        return StatusError(env, StatusCode::InvalidArgument, "Event capacity expected");
+    }
+    
+    int capacity = info[0].As<Napi::Number>().Int32Value();
+    if (capacity <= 0) {
+        return StatusError(env, StatusCode::InvalidArgument, "Event capacity must be positive");
+    }
+    
+    Tracer::Start(static_cast<size_t>(capacity));
+    ReportExternalMemory(env);
+    return StatusOk(env);
+}
+
+/**
+ * Stop recording and get the timeline
+ * @returns Chrome trace-event JSON string
+ */
+Napi::String StopTracing(const Napi::CallbackInfo& info) {
+    Tracer::Stop();
+    return Napi::String::New(info.Env(), Tracer::ToJson());
+}
+
+/**
+ * Start recording sampled decode requests to a capture file
+ * @param path - File to write, replaced if it exists
+ * @param sampleEvery - Capture one of every this many requests
+ * @param maxBytes - File size after which frames are dropped (0 = unlimited)
+ */
+Napi::Number StartCapture(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 3 || !info[0].IsString() || !info[1].IsNumber() || !info[2].IsNumber()) {
+        return StatusError(env, StatusCode::InvalidArgument, "Path, sampling interval and maximum bytes expected");
+    }
+    
+    std::string path = info[0].As<Napi::String>().Utf8Value();
+    int sampleEvery = info[1].As<Napi::Number>().Int32Value();
+    int64_t maxBytes = info[2].As<Napi::Number>().Int64Value();
+    if (sampleEvery <= 0 || maxBytes < 0) {
+        return StatusError(env, StatusCode::InvalidArgument, "Sampling interval must be positive and maximum bytes not negative");
+    }
+    
+    std::string error;
+    if (!FrameCapture::Start(path, static_cast<uint32_t>(sampleEvery), static_cast<uint64_t>(maxBytes), error)) {
+        return StatusError(env, StatusCode::IoError, error);
+    }
+    return StatusOk(env);
+}
+
+/**
+ * Stop capturing and finish the capture file
+ * @returns JSON string with the frames written, frames dropped, file size and any write error
+ */
+Napi::String StopCapture(const Napi::CallbackInfo& info) {
+    CaptureSummary summary = FrameCapture::Stop();
+    ReportExternalMemory(info.Env());
+    
+    cJSON* root = cJSON_CreateObject();
+    cJSON_AddNumberToObject(root, "frames", static_cast<double>(summary.frames));
+    cJSON_AddNumberToObject(root, "dropped", static_cast<double>(summary.dropped));
+    cJSON_AddNumberToObject(root, "bytes", static_cast<double>(summary.bytes));
+    if (!summary.error.empty()) {
+        cJSON_AddStringToObject(root, "error", summary.error.c_str());
+    }
+    return Napi::String::New(info.Env(), PrintAndDeleteJson(root));
+}
+
+/**
+ * Get the startup milestones of this process
+ * @returns JSON string with each milestone in milliseconds before now, null when not reached yet
+ */
+Napi::String GetStartupTimeline(const Napi::CallbackInfo& info) {
+    return Napi::String::New(info.Env(), PrintAndDeleteJson(StartupTimeline::ToJson()));
+}
+
+/**
+ * Get the native memory held by the wrapper
+ * @returns JSON string with current and peak bytes per category, and the bytes reported to V8
+ */
+Napi::String GetMemoryUsage(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ReportExternalMemory(env);
+    
+    cJSON* root = cJSON_CreateObject();
+    cJSON_AddItemToObject(root, "categories", MemoryAccount::ToJson());
+    cJSON_AddNumberToObject(root, "ownedBytes", static_cast<double>(MemoryAccount::OwnedBytes()));
+    cJSON_AddNumberToObject(root, "reportedToV8", static_cast<double>(reportedExternalBytes));
+    return Napi::String::New(env, PrintAndDeleteJson(root));
+}
+
+// Reused by every scrape so rendering does not allocate once warmed up
+MetricsText metricsText;
+
+/**
+ * Render decode metrics in the OpenMetrics text format
+ * @returns Exposition text, terminated by # EOF
+ */
+Napi::String GetMetricsText(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    metricsText.Begin();
+    DecodeStats::WriteMetrics(metricsText);
+    
+    metricsText.Family("barkoder_queue_depth", "gauge", "Decode tasks waiting for a native worker.");
+    metricsText.Sample("barkoder_queue_depth", nullptr, static_cast<uint64_t>(decodePool ? decodePool->QueueDepth() : 0));
+    metricsText.Family("barkoder_lane_queue_depth", "gauge", "Decode tasks waiting for a native worker, by priority lane.");
+    for (int i = 0; i < static_cast<int>(DecodeLane::Count); i++) {
+        DecodeLane lane = static_cast<DecodeLane>(i);
+        char labels[32];
+        snprintf(labels, sizeof(labels), "lane=\"%s\"", DecodePool::LaneName(lane));
+        metricsText.Sample("barkoder_lane_queue_depth", labels, static_cast<uint64_t>(decodePool ? decodePool->QueueDepth(lane) : 0));
+    }
+    metricsText.Family("barkoder_async_pending", "gauge", "decodeImageAsync calls not settled yet.");
+    metricsText.Sample("barkoder_async_pending", nullptr, static_cast<uint64_t>(pendingAsyncJobs));
+    
+    metricsText.Family("barkoder_pool_threads", "gauge", "Native decode worker threads.");
+    metricsText.Sample("barkoder_pool_threads", nullptr, static_cast<uint64_t>(decodePool ? decodePool->ThreadCount() : 0));
+    metricsText.Family("barkoder_pool_busy_threads", "gauge", "Native decode workers running a task.");
+    metricsText.Sample("barkoder_pool_busy_threads", nullptr, static_cast<uint64_t>(decodePool ? decodePool->BusyThreads() : 0));
+    metricsText.Family("barkoder_pool_busy_seconds", "counter", "Time native decode workers spent running tasks.");
+    metricsText.Sample("barkoder_pool_busy_seconds_total", nullptr, DecodePool::TotalBusyNs() / 1e9);
+    
+    metricsText.Family("barkoder_native_memory_bytes", "gauge", "Native memory held by the wrapper, outside the SDK.");
+    for (int i = 0; i < static_cast<int>(MemoryCategory::Count); i++) {
+        MemoryCategory category = static_cast<MemoryCategory>(i);
+        char labels[64];
+        snprintf(labels, sizeof(labels), "category=\"%s\"", MemoryAccount::Name(category));
+        metricsText.Sample("barkoder_native_memory_bytes", labels, static_cast<uint64_t>(std::max<int64_t>(MemoryAccount::Current(category), 0)));
+    }
+    
+    metricsText.Family("barkoder_config_snapshot_lookups", "counter", "Decodes that reused the cached settings snapshot (hit) or had to copy the settings (miss).");
+    metricsText.Sample("barkoder_config_snapshot_lookups_total", "result=\"hit\"", configSnapshotHits);
+    metricsText.Sample("barkoder_config_snapshot_lookups_total", "result=\"miss\"", configSnapshotMisses);
+    
+    DeadlineMisses misses = DeadlineMissCounts();
+    metricsText.Family("barkoder_deadline_misses", "counter", "Decodes skipped because their deadline had passed, or cut short by it.");
+    metricsText.Sample("barkoder_deadline_misses_total", "result=\"skipped\"", misses.skipped);
+    metricsText.Sample("barkoder_deadline_misses_total", "result=\"cut_short\"", misses.cutShort);
+    
+    const std::string& text = metricsText.End();
+    return Napi::String::New(env, text.data(), text.size());
+}
+
 /**
  * Module initialization
  */
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
+    StartupTimeline::Mark(StartupEvent::ExportsStart);
+    JsonArena::Install();
+    
     exports.Set("getVersion", Napi::Function::New(env, GetVersion));
     exports.Set("initialize", Napi::Function::New(env, Initialize));
+    exports.Set("initializeAsync", Napi::Function::New(env, InitializeAsync));
     exports.Set("isInitialized", Napi::Function::New(env, IsInitialized));
     exports.Set("setEnabledDecoders", Napi::Function::New(env, SetEnabledDecoders));
     exports.Set("setDecodingSpeed", Napi::Function::New(env, SetDecodingSpeed));
+    exports.Set("setDecodingCascade", Napi::Function::New(env, SetDecodingCascade));
+    exports.Set("setPyramidMode", Napi::Function::New(env, SetPyramidMode));
+    exports.Set("setTileMode", Napi::Function::New(env, SetTileMode));
+    exports.Set("setDecodeThreads", Napi::Function::New(env, SetDecodeThreads));
+    exports.Set("setInteractiveWeight", Napi::Function::New(env, SetInteractiveWeight));
+    exports.Set("setMaximumResultsCount", Napi::Function::New(env, SetMaximumResultsCount));
     exports.Set("setRegionOfInterest", Napi::Function::New(env, SetRegionOfInterest));
+    exports.Set("getLastError", Napi::Function::New(env, GetLastError));
     exports.Set("decodeImage", Napi::Function::New(env, DecodeImage));
+    exports.Set("decodeImageAsync", Napi::Function::New(env, DecodeImageAsync));
+    exports.Set("attachResultRing", Napi::Function::New(env, AttachResultRing));
+    exports.Set("detachResultRing", Napi::Function::New(env, DetachResultRing));
+    exports.Set("decodeToRing", Napi::Function::New(env, DecodeToRing));
+    exports.Set("decodeToRingAsync", Napi::Function::New(env, DecodeToRingAsync));
+    exports.Set("abortDecode", Napi::Function::New(env, AbortDecode));
+    exports.Set("warmup", Napi::Function::New(env, WarmupDecoders));
+    exports.Set("getStats", Napi::Function::New(env, GetStats));
+    exports.Set("resetStats", Napi::Function::New(env, ResetStats));
+    exports.Set("metricsText", Napi::Function::New(env, GetMetricsText));
+    exports.Set("startTracing", Napi::Function::New(env, StartTracing));
+    exports.Set("stopTracing", Napi::Function::New(env, StopTracing));
+    exports.Set("startCapture", Napi::Function::New(env, StartCapture));
+    exports.Set("stopCapture", Napi::Function::New(env, StopCapture));
+    exports.Set("startupTimeline", Napi::Function::New(env, GetStartupTimeline));
+    exports.Set("memoryUsage", Napi::Function::New(env, GetMemoryUsage));
     
+    StartupTimeline::Mark(StartupEvent::ExportsDone);
     return exports;
 }
 
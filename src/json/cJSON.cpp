@@ -30,6 +30,8 @@
 #include <float.h>
 #include <limits.h>
 #include <ctype.h>
+#include <stdint.h>
+#include <locale.h>
 #include "cJSON.h"
 
 static const char *ep;
@@ -92,48 +94,198 @@ void cJSON_Delete(cJSON *c)
 	}
 }
 
-/* Parse the input text to generate a number, and populate the result into item. */
+/* Parse the input text to generate a number, and populate the result into item.
+   strtod rounds once, so every number print_number writes reads back as the same double.
+   The token is copied to swap '.' for the locale's decimal point. */
 static const char *parse_number(cJSON *item,const char *num)
 {
-	double n=0,sign=1,scale=0;int subscale=0,signsubscale=1;
-
-	if (*num=='-') sign=-1,num++;	/* Has sign? */
-	if (*num=='0') num++;			/* is zero */
-	if (*num>='1' && *num<='9')	do	n=(n*10.0)+(*num++ -'0');	while (*num>='0' && *num<='9');	/* Number? */
-	if (*num=='.' && num[1]>='0' && num[1]<='9') {num++;		do	n=(n*10.0)+(*num++ -'0'),scale--; while (*num>='0' && *num<='9');}	/* Fractional part? */
-	if (*num=='e' || *num=='E')		/* Exponent? */
-	{	num++;if (*num=='+') num++;	else if (*num=='-') signsubscale=-1,num++;		/* With sign? */
-		while (*num>='0' && *num<='9') subscale=(subscale*10)+(*num++ - '0');	/* Number? */
+	const char *end=num;char small[64],*copy=small,point=localeconv()->decimal_point[0];size_t len,i;double n;
+
+	if (*end=='-') end++;	/* Has sign? */
+	if (*end=='0') end++;			/* is zero */
+	if (*end>='1' && *end<='9')	do	end++;	while (*end>='0' && *end<='9');	/* Number? */
+	if (*end=='.' && end[1]>='0' && end[1]<='9') {end++;		do	end++; while (*end>='0' && *end<='9');}	/* Fractional part? */
+	if (*end=='e' || *end=='E')		/* Exponent? */
+	{	end++;if (*end=='+' || *end=='-') end++;		/* With sign? */
+		while (*end>='0' && *end<='9') end++;	/* Number? */
 	}
 
-	n=sign*n*pow(10.0,(scale+subscale*signsubscale));	/* number = +/- number.fraction * 10^+/- exponent */
+	len=end-num;
+	if (len>=sizeof(small) && !(copy=(char*)cJSON_malloc(len+1))) {ep=num;return 0;}
+	for (i=0;i<len;i++) copy[i]=num[i]=='.'?point:num[i];
+	copy[len]=0;
+	n=strtod(copy,0);
+	if (copy!=small) cJSON_free(copy);
 	
 	item->valuedouble=n;
 	item->valueint=(int)n;
 	item->type=cJSON_Number;
-	return num;
+	return end;
 }
 
-/* Render the number nicely from the given item into a string. */
-static char *print_number(cJSON *item)
+/* Shortest number formatting (Grisu2, after Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers").
+   Produces the shortest digits that read back as the same value (rarely one digit more), without sprintf or the locale. */
+typedef struct {uint64_t f;int e;} diyfp;
+typedef struct {uint64_t f;int e;int k;} cached_power;
+
+static diyfp diyfp_make(uint64_t f,int e)			{diyfp r;r.f=f;r.e=e;return r;}
+static diyfp diyfp_sub(diyfp x,diyfp y)				{return diyfp_make(x.f-y.f,x.e);}
+static diyfp diyfp_normalize(diyfp x)				{while (!(x.f>>63)) x.f<<=1,x.e--;return x;}
+static diyfp diyfp_normalize_to(diyfp x,int e)		{return diyfp_make(x.f<<(x.e-e),e);}
+static diyfp diyfp_mul(diyfp x,diyfp y)				/* Upper 64 bits of the 128-bit product, rounded. */
 {
-	char *str;
-	double d=item->valuedouble;
-	if (fabs(((double)item->valueint)-d)<=DBL_EPSILON && d<=INT_MAX && d>=INT_MIN)
+	uint64_t u_lo=x.f&0xFFFFFFFFu,u_hi=x.f>>32,v_lo=y.f&0xFFFFFFFFu,v_hi=y.f>>32;
+	uint64_t p0=u_lo*v_lo,p1=u_lo*v_hi,p2=u_hi*v_lo,p3=u_hi*v_hi;
+	uint64_t q=(p0>>32)+(p1&0xFFFFFFFFu)+(p2&0xFFFFFFFFu)+(1u<<31);
+	return diyfp_make(p3+(p1>>32)+(p2>>32)+(q>>32),x.e+y.e+64);
+}
+
+/* Normalized 10^k for k=-300,-292,...,324, each as f*2^e. */
+static const cached_power cached_powers[]={
+	{0xAB70FE17C79AC6CAULL,-1060,-300}, {0xFF77B1FCBEBCDC4FULL,-1034,-292},
+	{0xBE5691EF416BD60CULL,-1007,-284}, {0x8DD01FAD907FFC3CULL,-980,-276},
+	{0xD3515C2831559A83ULL,-954,-268}, {0x9D71AC8FADA6C9B5ULL,-927,-260},
+	{0xEA9C227723EE8BCBULL,-901,-252}, {0xAECC49914078536DULL,-874,-244},
+	{0x823C12795DB6CE57ULL,-847,-236}, {0xC21094364DFB5637ULL,-821,-228},
+	{0x9096EA6F3848984FULL,-794,-220}, {0xD77485CB25823AC7ULL,-768,-212},
+	{0xA086CFCD97BF97F4ULL,-741,-204}, {0xEF340A98172AACE5ULL,-715,-196},
+	{0xB23867FB2A35B28EULL,-688,-188}, {0x84C8D4DFD2C63F3BULL,-661,-180},
+	{0xC5DD44271AD3CDBAULL,-635,-172}, {0x936B9FCEBB25C996ULL,-608,-164},
+	{0xDBAC6C247D62A584ULL,-582,-156}, {0xA3AB66580D5FDAF6ULL,-555,-148},
+	{0xF3E2F893DEC3F126ULL,-529,-140}, {0xB5B5ADA8AAFF80B8ULL,-502,-132},
+	{0x87625F056C7C4A8BULL,-475,-124}, {0xC9BCFF6034C13053ULL,-449,-116},
+	{0x964E858C91BA2655ULL,-422,-108}, {0xDFF9772470297EBDULL,-396,-100},
+	{0xA6DFBD9FB8E5B88FULL,-369,-92}, {0xF8A95FCF88747D94ULL,-343,-84},
+	{0xB94470938FA89BCFULL,-316,-76}, {0x8A08F0F8BF0F156BULL,-289,-68},
+	{0xCDB02555653131B6ULL,-263,-60}, {0x993FE2C6D07B7FACULL,-236,-52},
+	{0xE45C10C42A2B3B06ULL,-210,-44}, {0xAA242499697392D3ULL,-183,-36},
+	{0xFD87B5F28300CA0EULL,-157,-28}, {0xBCE5086492111AEBULL,-130,-20},
+	{0x8CBCCC096F5088CCULL,-103,-12}, {0xD1B71758E219652CULL,-77,-4},
+	{0x9C40000000000000ULL,-50,4}, {0xE8D4A51000000000ULL,-24,12},
+	{0xAD78EBC5AC620000ULL,3,20}, {0x813F3978F8940984ULL,30,28},
+	{0xC097CE7BC90715B3ULL,56,36}, {0x8F7E32CE7BEA5C70ULL,83,44},
+	{0xD5D238A4ABE98068ULL,109,52}, {0x9F4F2726179A2245ULL,136,60},
+	{0xED63A231D4C4FB27ULL,162,68}, {0xB0DE65388CC8ADA8ULL,189,76},
+	{0x83C7088E1AAB65DBULL,216,84}, {0xC45D1DF942711D9AULL,242,92},
+	{0x924D692CA61BE758ULL,269,100}, {0xDA01EE641A708DEAULL,295,108},
+	{0xA26DA3999AEF774AULL,322,116}, {0xF209787BB47D6B85ULL,348,124},
+	{0xB454E4A179DD1877ULL,375,132}, {0x865B86925B9BC5C2ULL,402,140},
+	{0xC83553C5C8965D3DULL,428,148}, {0x952AB45CFA97A0B3ULL,455,156},
+	{0xDE469FBD99A05FE3ULL,481,164}, {0xA59BC234DB398C25ULL,508,172},
+	{0xF6C69A72A3989F5CULL,534,180}, {0xB7DCBF5354E9BECEULL,561,188},
+	{0x88FCF317F22241E2ULL,588,196}, {0xCC20CE9BD35C78A5ULL,614,204},
+	{0x98165AF37B2153DFULL,641,212}, {0xE2A0B5DC971F303AULL,667,220},
+	{0xA8D9D1535CE3B396ULL,694,228}, {0xFB9B7CD9A4A7443CULL,720,236},
+	{0xBB764C4CA7A44410ULL,747,244}, {0x8BAB8EEFB6409C1AULL,774,252},
+	{0xD01FEF10A657842CULL,800,260}, {0x9B10A4E5E9913129ULL,827,268},
+	{0xE7109BFBA19C0C9DULL,853,276}, {0xAC2820D9623BF429ULL,880,284},
+	{0x80444B5E7AA7CF85ULL,907,292}, {0xBF21E44003ACDD2DULL,933,300},
+	{0x8E679C2F5E44FF8FULL,960,308}, {0xD433179D9C8CB841ULL,986,316},
+	{0x9E19DB92B4E31BA9ULL,1013,324}
+};
+
+/* Value and the midpoints to its neighbours, for a binary format with "precision" significand bits (hidden bit included) and the given exponent bias. */
+static void compute_boundaries(uint64_t bits,int precision,int bias,diyfp *w,diyfp *m_minus,diyfp *m_plus)
+{
+	uint64_t hidden=(uint64_t)1<<(precision-1);
+	uint64_t F=bits&(hidden-1);int E=(int)(bits>>(precision-1));
+	diyfp v=E?diyfp_make(F+hidden,E-bias):diyfp_make(F,1-bias);
+	int lower_is_closer=(F==0 && E>1);
+	*m_plus=diyfp_normalize(diyfp_make(2*v.f+1,v.e-1));
+	*m_minus=diyfp_normalize_to(lower_is_closer?diyfp_make(4*v.f-1,v.e-2):diyfp_make(2*v.f-1,v.e-1),m_plus->e);
+	*w=diyfp_normalize(v);
+}
+
+static void grisu2_round(char *buf,int len,uint64_t dist,uint64_t delta,uint64_t rest,uint64_t ten_k)
+{
+	while (rest<dist && delta-rest>=ten_k && (rest+ten_k<dist || dist-rest>rest+ten_k-dist)) buf[len-1]--,rest+=ten_k;
+}
+
+/* Writes the digits of the shortest decimal in [m_minus,m_plus] nearest to w; the value is digits*10^k. Returns the digit count. */
+static int grisu2(char *buf,int *k,diyfp m_minus,diyfp w,diyfp m_plus)
+{
+	/* Scale by a cached power so the product's binary exponent lies in [-60,-32]. */
+	int f=-60-m_plus.e-1;
+	int ck=(f*78913)/(1<<18)+(f>0);
+	const cached_power *c=&cached_powers[(300+ck+7)/8];
+	diyfp c_minus_k=diyfp_make(c->f,c->e);
+	diyfp W=diyfp_mul(w,c_minus_k),lo=diyfp_mul(m_minus,c_minus_k),hi=diyfp_mul(m_plus,c_minus_k);
+	diyfp M_minus=diyfp_make(lo.f+1,lo.e),M_plus=diyfp_make(hi.f-1,hi.e);
+	uint64_t delta=diyfp_sub(M_plus,M_minus).f,dist=diyfp_sub(M_plus,W).f;
+	int shift=-M_plus.e;uint64_t one=(uint64_t)1<<shift;
+	uint32_t p1=(uint32_t)(M_plus.f>>shift);uint64_t p2=M_plus.f&(one-1);
+	uint32_t pow10=1;int n=1,len=0;
+	*k=-c->k;
+
+	while (n<10 && p1>=pow10*10) pow10*=10,n++;
+	while (n>0)		/* Integral digits. */
+	{
+		uint64_t rest;
+		buf[len++]=(char)('0'+p1/pow10);p1%=pow10;n--;
+		rest=((uint64_t)p1<<shift)+p2;
+		if (rest<=delta) {*k+=n;grisu2_round(buf,len,dist,delta,rest,(uint64_t)pow10<<shift);return len;}
+		pow10/=10;
+	}
+	for (;;)		/* Fractional digits. */
 	{
-		str=(char*)cJSON_malloc(21);	/* 2^64+1 can be represented in 21 chars. */
-		if (str) sprintf(str,"%d",item->valueint);
+		p2*=10;buf[len++]=(char)('0'+(p2>>shift));p2&=one-1;(*k)--;
+		delta*=10;dist*=10;
+		if (p2<=delta) break;
 	}
+	grisu2_round(buf,len,dist,delta,p2,one);
+	return len;
+}
+
+/* Writes a finite value as JavaScript would: plain notation for 1e-7 <= |d| < 1e21, exponent notation otherwise.
+   With single set, d must be a float widened to double, and gets the shortest digits that read back as that float.
+   Returns the length written; str must hold 32 chars. */
+static int format_double(char *str,double d,int single)
+{
+	char digits[24];int len,k,point,i,o=0;
+	diyfp w,m_minus,m_plus;
+	if (d<0) str[o++]='-',d=-d;
+	if (d==0) {str[o++]='0';str[o]=0;return o;}
+	if (single)	{float f=(float)d;uint32_t b;memcpy(&b,&f,sizeof(b));compute_boundaries(b,24,150,&w,&m_minus,&m_plus);}
+	else		{uint64_t b;memcpy(&b,&d,sizeof(b));compute_boundaries(b,53,1075,&w,&m_minus,&m_plus);}
+	len=grisu2(digits,&k,m_minus,w,m_plus);
+	point=len+k;		/* Position of the decimal point relative to the first digit. */
+
+	if (k>=0 && point<=21)			{memcpy(str+o,digits,len);o+=len;for (i=0;i<k;i++) str[o++]='0';}
+	else if (point>0 && point<=21)	{memcpy(str+o,digits,point);o+=point;str[o++]='.';memcpy(str+o,digits+point,len-point);o+=len-point;}
+	else if (point>-6 && point<=0)	{str[o++]='0';str[o++]='.';for (i=point;i<0;i++) str[o++]='0';memcpy(str+o,digits,len);o+=len;}
 	else
 	{
-		str=(char*)cJSON_malloc(64);	/* This is a nice tradeoff. */
-		if (str)
-		{
-			if (fabs(floor(d)-d)<=DBL_EPSILON && fabs(d)<1.0e60)sprintf(str,"%.0f",d);
-			else if (fabs(d)<1.0e-6 || fabs(d)>1.0e9)			sprintf(str,"%e",d);
-			else												sprintf(str,"%f",d);
-		}
+		int e=point-1;
+		str[o++]=digits[0];
+		if (len>1) {str[o++]='.';memcpy(str+o,digits+1,len-1);o+=len-1;}
+		str[o++]='e';str[o++]=e<0?'-':'+';if (e<0) e=-e;
+		if (e>=100) str[o++]=(char)('0'+e/100);
+		if (e>=10) str[o++]=(char)('0'+e/10%10);
+		str[o++]=(char)('0'+e%10);
+	}
+	str[o]=0;
+	return o;
+}
+
+/* Render the number nicely from the given item into a string. */
+static char *print_number(cJSON *item)
+{
+	char buf[32],*str;int len;
+	double d=item->valuedouble;
+	if ((double)item->valueint==d)
+	{
+		/* Integers print their digits backwards, then reverse. */
+		unsigned int u=item->valueint<0?0u-(unsigned int)item->valueint:(unsigned int)item->valueint;
+		int i,j;len=0;
+		do buf[len++]=(char)('0'+u%10),u/=10; while (u);
+		if (item->valueint<0) buf[len++]='-';
+		for (i=0,j=len-1;i<j;i++,j--) {char t=buf[i];buf[i]=buf[j];buf[j]=t;}
+		buf[len]=0;
 	}
+	else if (d!=d || d-d!=0)	len=4,memcpy(buf,"null",5);		/* JSON has no NaN or infinity. */
+	else						len=format_double(buf,d,item->type&cJSON_FloatPrecision);
+	str=(char*)cJSON_malloc(len+1);
+	if (str) memcpy(str,buf,len+1);
 	return str;
 }
 
@@ -339,6 +491,7 @@ static const char *parse_array(cJSON *item,const char *value)
 		value=skip(parse_value(child,skip(value+1)));
 		if (!value) return 0;	/* memory fail */
 	}
+	item->tail=child;
 
 	if (*value==']') return value+1;	/* end of array */
 	ep=value;return 0;	/* malformed. */
@@ -433,6 +586,7 @@ static const char *parse_object(cJSON *item,const char *value)
 		value=skip(parse_value(child,skip(value+1)));	/* skip any spacing, get the value. */
 		if (!value) return 0;
 	}
+	item->tail=child;
 	
 	if (*value=='}') return value+1;	/* end of array */
 	ep=value;return 0;	/* malformed. */
@@ -517,13 +671,13 @@ static void suffix_object(cJSON *prev,cJSON *item) {prev->next=item;item->prev=p
 static cJSON *create_reference(cJSON *item) {cJSON *ref=cJSON_New_Item();if (!ref) return 0;memcpy(ref,item,sizeof(cJSON));ref->string=0;ref->type|=cJSON_IsReference;ref->next=ref->prev=0;return ref;}
 
 /* Add item to array/object. */
-void   cJSON_AddItemToArray(cJSON *array, cJSON *item)						{cJSON *c=array->child;if (!item) return; if (!c) {array->child=item;} else {while (c && c->next) c=c->next; suffix_object(c,item);}}
+void   cJSON_AddItemToArray(cJSON *array, cJSON *item)						{cJSON *c=array->child;if (!item) return; if (!c) {array->child=item;} else {if (array->tail) c=array->tail; while (c->next) c=c->next; suffix_object(c,item);} array->tail=item;}
 void   cJSON_AddItemToObject(cJSON *object,const char *string,cJSON *item)	{if (!item) return; if (item->string) cJSON_free(item->string);item->string=cJSON_strdup(string);cJSON_AddItemToArray(object,item);}
 void	cJSON_AddItemReferenceToArray(cJSON *array, cJSON *item)						{cJSON_AddItemToArray(array,create_reference(item));}
 void	cJSON_AddItemReferenceToObject(cJSON *object,const char *string,cJSON *item)	{cJSON_AddItemToObject(object,string,create_reference(item));}
 
 cJSON *cJSON_DetachItemFromArray(cJSON *array,int which)			{cJSON *c=array->child;while (c && which>0) c=c->next,which--;if (!c) return 0;
-	if (c->prev) c->prev->next=c->next;if (c->next) c->next->prev=c->prev;if (c==array->child) array->child=c->next;c->prev=c->next=0;return c;}
+	if (c->prev) c->prev->next=c->next;if (c->next) c->next->prev=c->prev;if (c==array->child) array->child=c->next;if (c==array->tail) array->tail=c->prev;c->prev=c->next=0;return c;}
 void   cJSON_DeleteItemFromArray(cJSON *array,int which)			{cJSON_Delete(cJSON_DetachItemFromArray(array,which));}
 cJSON *cJSON_DetachItemFromObject(cJSON *object,const char *string) {int i=0;cJSON *c=object->child;while (c && cJSON_strcasecmp(c->string,string)) i++,c=c->next;if (c) return cJSON_DetachItemFromArray(object,i);return 0;}
 void   cJSON_DeleteItemFromObject(cJSON *object,const char *string) {cJSON_Delete(cJSON_DetachItemFromObject(object,string));}
@@ -531,7 +685,7 @@ void   cJSON_DeleteItemFromObject(cJSON *object,const char *string) {cJSON_Delet
 /* Replace array/object items with new ones. */
 void   cJSON_ReplaceItemInArray(cJSON *array,int which,cJSON *newitem)		{cJSON *c=array->child;while (c && which>0) c=c->next,which--;if (!c) return;
 	newitem->next=c->next;newitem->prev=c->prev;if (newitem->next) newitem->next->prev=newitem;
-	if (c==array->child) array->child=newitem; else newitem->prev->next=newitem;c->next=c->prev=0;cJSON_Delete(c);}
+	if (c==array->child) array->child=newitem; else newitem->prev->next=newitem;if (c==array->tail) array->tail=newitem;c->next=c->prev=0;cJSON_Delete(c);}
 void   cJSON_ReplaceItemInObject(cJSON *object,const char *string,cJSON *newitem){int i=0;cJSON *c=object->child;while(c && cJSON_strcasecmp(c->string,string))i++,c=c->next;if(c){newitem->string=cJSON_strdup(string);cJSON_ReplaceItemInArray(object,i,newitem);}}
 
 /* Create basic types: */
@@ -540,15 +694,16 @@ cJSON *cJSON_CreateTrue(void)					{cJSON *item=cJSON_New_Item();if(item)item->ty
 cJSON *cJSON_CreateFalse(void)					{cJSON *item=cJSON_New_Item();if(item)item->type=cJSON_False;return item;}
 cJSON *cJSON_CreateBool(int b)					{cJSON *item=cJSON_New_Item();if(item)item->type=b?cJSON_True:cJSON_False;return item;}
 cJSON *cJSON_CreateNumber(double num)			{cJSON *item=cJSON_New_Item();if(item){item->type=cJSON_Number;item->valuedouble=num;item->valueint=(int)num;}return item;}
+cJSON *cJSON_CreateFloat(float num)				{cJSON *item=cJSON_CreateNumber(num);if(item)item->type|=cJSON_FloatPrecision;return item;}
 cJSON *cJSON_CreateString(const char *string)	{cJSON *item=cJSON_New_Item();if(item){item->type=cJSON_String;item->valuestring=cJSON_strdup(string);}return item;}
 cJSON *cJSON_CreateArray(void)					{cJSON *item=cJSON_New_Item();if(item)item->type=cJSON_Array;return item;}
 cJSON *cJSON_CreateObject(void)					{cJSON *item=cJSON_New_Item();if(item)item->type=cJSON_Object;return item;}
 
 /* Create Arrays: */
-cJSON *cJSON_CreateIntArray(const int *numbers,int count)		{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateNumber(numbers[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}return a;}
-cJSON *cJSON_CreateFloatArray(const float *numbers,int count)	{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateNumber(numbers[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}return a;}
-cJSON *cJSON_CreateDoubleArray(const double *numbers,int count)	{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateNumber(numbers[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}return a;}
-cJSON *cJSON_CreateStringArray(const char **strings,int count)	{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateString(strings[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}return a;}
+cJSON *cJSON_CreateIntArray(const int *numbers,int count)		{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateNumber(numbers[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}if(a)a->tail=p;return a;}
+cJSON *cJSON_CreateFloatArray(const float *numbers,int count)	{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateFloat(numbers[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}if(a)a->tail=p;return a;}
+cJSON *cJSON_CreateDoubleArray(const double *numbers,int count)	{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateNumber(numbers[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}if(a)a->tail=p;return a;}
+cJSON *cJSON_CreateStringArray(const char **strings,int count)	{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateString(strings[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}if(a)a->tail=p;return a;}
 
 /* Duplication */
 cJSON *cJSON_Duplicate(cJSON *item,int recurse)
@@ -575,6 +730,7 @@ cJSON *cJSON_Duplicate(cJSON *item,int recurse)
 		else		{newitem->child=newchild;nptr=newchild;}					/* Set newitem->child and move to it */
 		cptr=cptr->next;
 	}
+	newitem->tail=nptr;
 	return newitem;
 }
 
@@ -38,6 +38,7 @@ extern "C"
 #define cJSON_Object 6
 	
 #define cJSON_IsReference 256
+#define cJSON_FloatPrecision 512	/* A number that holds a float: printed with the digits the float needs, not those of the double. */
 
 /* The cJSON structure: */
 typedef struct cJSON {
@@ -51,6 +52,8 @@ typedef struct cJSON {
 	double valuedouble;			/* The item's number, if type==cJSON_Number */
 
 	char *string;				/* The item's name string, if this item is the child of, or is in the list of subitems of an object. */
+
+	struct cJSON *tail;			/* Last item of the child chain, kept by the Add/Detach/Replace calls so appends don't walk the chain. Set it (or zero it) if you link children by hand. */
 } cJSON;
 
 typedef struct cJSON_Hooks {
@@ -87,6 +90,8 @@ extern cJSON *cJSON_CreateTrue(void);
 extern cJSON *cJSON_CreateFalse(void);
 extern cJSON *cJSON_CreateBool(int b);
 extern cJSON *cJSON_CreateNumber(double num);
+/* A float, printed with the shortest digits that read back as it, so 123.4f prints as 123.4 rather than 123.40000152587891. */
+extern cJSON *cJSON_CreateFloat(float num);
 extern cJSON *cJSON_CreateString(const char *string);
 extern cJSON *cJSON_CreateArray(void);
 extern cJSON *cJSON_CreateObject(void);
@@ -131,6 +136,7 @@ extern void cJSON_Minify(char *json);
 #define cJSON_AddFalseToObject(object,name)		cJSON_AddItemToObject(object, name, cJSON_CreateFalse())
 #define cJSON_AddBoolToObject(object,name,b)	cJSON_AddItemToObject(object, name, cJSON_CreateBool(b))
 #define cJSON_AddNumberToObject(object,name,n)	cJSON_AddItemToObject(object, name, cJSON_CreateNumber(n))
+#define cJSON_AddFloatToObject(object,name,n)	cJSON_AddItemToObject(object, name, cJSON_CreateFloat(n))
 #define cJSON_AddStringToObject(object,name,s)	cJSON_AddItemToObject(object, name, cJSON_CreateString(s))
 
 /* When assigning an integer value, it needs to be propagated to valuedouble too. */
@@ -13,15 +13,27 @@ console.log('===================================');
 
 let testsPassed = 0;
 let testsFailed = 0;
+const pendingTests = [];
 
 function test(name, fn) {
-    try {
-        fn();
+    const passed = () => {
         console.log(`✅ ${name}`);
         testsPassed++;
-    } catch (error) {
+    };
+    const failed = error => {
         console.log(`❌ ${name}: ${error.message}`);
         testsFailed++;
+    };
+    try {
+        const result = fn();
+        if (result instanceof Promise) {
+            // Async tests are counted once they settle, before the summary
+            pendingTests.push(result.then(passed, failed));
+            return;
+        }
+        passed();
+    } catch (error) {
+        failed(error);
     }
 }
 
@@ -85,6 +97,9 @@ test('setDecodingSpeed should validate input', () => {
     } catch (error) {
         assert(error.message.includes('number'), 'Should mention number in error message');
     }
+    for (const speed of [-1, 4, 1.5, 2 ** 32]) {
+        assert.throws(() => BarkoderSDK.setDecodingSpeed(speed), /Unknown decoding speed/, `Should reject speed ${speed}`);
+    }
 });
 
 // Test 9: decodeImage validation
@@ -107,16 +122,307 @@ test('loadConfig should handle missing file gracefully', () => {
     }
 });
 
-// Summary
-console.log(`\n📊 Test Results:`);
-console.log(`   ✅ Passed: ${testsPassed}`);
-console.log(`   ❌ Failed: ${testsFailed}`);
-console.log(`   📈 Total: ${testsPassed + testsFailed}`);
+// Test 11: setDecodingCascade validation
+test('setDecodingCascade should validate input', () => {
+    try {
+        BarkoderSDK.setDecodingCascade(1);
+        assert(false, 'Should throw error for non-array input');
+    } catch (error) {
+        assert(error.message.includes('array'), 'Should mention array in error message');
+    }
+});
+
+// Test 12: setPyramidMode validation
+test('setPyramidMode should validate input', () => {
+    try {
+        BarkoderSDK.setPyramidMode('not-a-number');
+        assert(false, 'Should throw error for non-number input');
+    } catch (error) {
+        assert(error.message.includes('number'), 'Should mention number in error message');
+    }
+});
+
+// Test 13: setTileMode validation
+test('setTileMode should validate input', () => {
+    try {
+        BarkoderSDK.setTileMode('not-a-number');
+        assert(false, 'Should throw error for non-number input');
+    } catch (error) {
+        assert(error.message.includes('number'), 'Should mention number in error message');
+    }
+});
+
+// Test 14: decodeImageAsync validation
+test('decodeImageAsync should validate input', async () => {
+    const pending = BarkoderSDK.decodeImageAsync('not-a-buffer', 100, 100);
+    assert(pending instanceof Promise, 'Should return a promise');
+    await assert.rejects(pending, /Buffer/);
+});
+
+// Test 15: decodeImageAsync abort signal
+test('Async decodes should not start when their signal is already aborted', async () => {
+    const controller = new AbortController();
+    controller.abort();
+    const pending = BarkoderSDK.decodeImageAsync(Buffer.alloc(4), 2, 2, { signal: controller.signal });
+    const status = BarkoderSDK.decodeToRingAsync(Buffer.alloc(4), 2, 2, 0, { signal: controller.signal });
+    assert(status.code === BarkoderSDK.constants.Status.Aborted, 'Ring decode should report an aborted signal');
+    await assert.rejects(pending, { name: 'AbortError' });
+});
+
+// Test 16: Deadline validation
+test('Decode deadlines should validate input', () => {
+    try {
+        BarkoderSDK.decodeImage(Buffer.alloc(4), 2, 2, { timeout: 'soon' });
+        assert(false, 'Should throw error for non-number timeout');
+    } catch (error) {
+        assert(error.message.includes('numbers'), 'Should mention numbers in error message');
+    }
+    assert.throws(() => BarkoderSDK.decodeToRing(Buffer.alloc(4), 2, 2, 0, { deadline: new Date() }), 'Should reject a Date deadline');
+});
+
+// Test 17: Priority validation
+test('Async decodes should validate their priority', () => {
+    assert(BarkoderSDK.constants.Priority.Bulk === 1, 'Bulk priority should be 1');
+    assert.throws(() => BarkoderSDK.decodeToRingAsync(Buffer.alloc(4), 2, 2, 0, { priority: 'high' }), /Priority/);
+    assert.throws(() => BarkoderSDK.setInteractiveWeight('often'), /number/);
+});
+
+// Test 18: Frame stream validation
+test('frameStream should validate input', () => {
+    const stream = BarkoderSDK.frameStream({ concurrency: 2 });
+    assert(stream instanceof BarkoderSDK.FrameStream && stream.dropped === 0, 'Should create a frame stream');
+    stream.destroy();
+    assert.throws(() => BarkoderSDK.frameStream({ concurrency: 0 }), /Concurrency/);
+    assert.throws(() => BarkoderSDK.decodeFrames(42), /iterable/);
+});
+
+// Test 19: startCapture validation
+test('startCapture should validate input', () => {
+    try {
+        BarkoderSDK.startCapture('capture.bkcap', { sampleEvery: 'often' });
+        assert(false, 'Should throw error for non-number sampling interval');
+    } catch (error) {
+        assert(error.message.includes('numbers'), 'Should mention numbers in error message');
+    }
+});
+
+// Test 20: Setting status codes
+test('Setting status should expose codes and the legacy message form', () => {
+    const { BarkoderStatus, BarkoderError, constants } = BarkoderSDK;
+    const applied = new BarkoderStatus(constants.Status.Ok, 'Decoding speed set');
+    assert(applied.ok, 'Ok status should report ok');
+    assert(applied.startsWith('SUCCESS:'), 'Ok status should read as SUCCESS:');
+    assert(applied.throwIfError() === applied, 'throwIfError should return an ok status');
 
-if (testsFailed === 0) {
-    console.log(`\n🎉 All tests passed!`);
-    process.exit(0);
-} else {
-    console.log(`\n💥 ${testsFailed} test(s) failed!`);
-    process.exit(1);
-}
\ No newline at end of file
+    const failed = new BarkoderStatus(constants.Status.NotInitialized, 'SDK not initialized');
+    assert(!failed.ok, 'Failed status should not report ok');
+    assert(String(failed) === 'ERROR: SDK not initialized', 'Failed status should read as ERROR:');
+    try {
+        failed.throwIfError();
+        assert(false, 'Should throw for a failed status');
+    } catch (error) {
+        assert(error instanceof BarkoderError, 'Should throw a BarkoderError');
+        assert(error.code === constants.Status.NotInitialized, 'Error should carry the status code');
+    }
+});
+
+// Test 21: Result ring layout
+test('Result ring should read records in the native layout', () => {
+    const { ResultRing, constants } = BarkoderSDK;
+    const ring = new ResultRing({ slots: 4, maxResults: 2, textBytes: 16 });
+    assert(ring.buffer instanceof SharedArrayBuffer, 'Ring should live in a SharedArrayBuffer');
+    assert(ring.buffer.byteLength === ResultRing.byteLength({ slots: 4, maxResults: 2, textBytes: 16 }), 'Ring size should match');
+    assert(!ring.next(), 'Empty ring should have no records');
+
+    // Record 0 as the native side writes it: one QR code with text "hi"
+    const base = 64;
+    const int32 = new Int32Array(ring.buffer);
+    int32[base / 4 + 1] = 7;
+    int32[base / 4 + 3] = 1;
+    int32[base / 4 + 4] = 1;
+    int32[(base + 64) / 4] = constants.BarcodeTypes.indexOf('QR');
+    int32[(base + 64) / 4 + 2] = 2;
+    new Float32Array(ring.buffer)[(base + 64) / 4 + 6] = 12.5;
+    Buffer.from(ring.buffer).write('hi', base + 64 + 2 * 48);
+    Atomics.store(int32, base / 4, 1);
+    Atomics.store(int32, 6, 1);
+
+    assert(ring.next(), 'Published record should be readable');
+    assert(ring.frameId === 7 && ring.resultsCount === 1, 'Record fields should be read in place');
+    assert(ring.barcodeTypeName(0) === 'QR' && ring.text(0) === 'hi', 'Result type and text should be read');
+    assert(ring.cornerX(0, 1) === 12.5, 'Corners should be read');
+    assert(ring.valid() && !ring.next(), 'Record should stay valid and be read once');
+
+    assert.throws(() => new ResultRing({ slots: 1 }), 'Ring needs at least two slots');
+    assert.throws(() => BarkoderSDK.attachResultRing({}), 'Should reject a non-ring');
+});
+
+// Test 22: initializeAsync validation
+test('initializeAsync should validate input', async () => {
+    const pending = BarkoderSDK.initializeAsync(42);
+    assert(pending instanceof Promise, 'Should return a promise');
+    await assert.rejects(pending, /string/);
+});
+
+// Test 23: warmup validation
+test('warmup should validate input', async () => {
+    const pending = BarkoderSDK.warmup({ decoders: ['NotADecoder'] });
+    assert(pending instanceof Promise, 'Should return a promise');
+    await assert.rejects(pending, /Unknown decoder/);
+});
+
+// Test 24: Startup report
+test('startupReport should time loading the addon', () => {
+    const { events, durations } = BarkoderSDK.startupReport();
+    assert(events.requireStart <= events.requireDone, 'Require should end after it starts');
+    assert(durations.require >= 0, 'Require duration should be measured');
+    assert(events.firstDecodeDone === null || events.firstDecodeDone >= events.requireStart, 'First decode follows loading');
+});
+
+// Test 25: Memory usage
+test('memoryUsage should list every native memory category', () => {
+    const usage = BarkoderSDK.memoryUsage();
+    for (const name of ['pinnedFrames', 'conversionScratch', 'resultBuffers', 'capture', 'caches', 'tracing']) {
+        assert(usage.categories[name].bytes >= 0, `${name} should be reported`);
+        assert(usage.categories[name].peakBytes >= usage.categories[name].bytes, `${name} peak should not be below current`);
+    }
+    assert(usage.ownedBytes >= usage.categories.resultBuffers.bytes, 'Owned bytes should include result buffers');
+});
+
+// Test 26: Frame stream behaviour
+test('Frame streams should decode the newest frame and hold back while results go unread', async () => {
+    const { FrameStream } = BarkoderSDK;
+    const frame = id => ({ id, buffer: Buffer.alloc(4), width: 2, height: 2 });
+    const tick = () => new Promise(resolve => setImmediate(resolve));
+
+    // Decodes finish when the test resolves them
+    const decodes = [];
+    const stream = new FrameStream(() => new Promise(resolve => decodes.push(resolve)));
+    const results = [];
+    let finished = false;
+    stream.on('data', output => results.push(output));
+    stream.on('finish', () => { finished = true; });
+    for (let id = 1; id <= 4; id++) {
+        stream.write(frame(id));
+    }
+    stream.end();
+    await tick();
+    assert(decodes.length === 1 && stream.dropped === 2, 'Frames 2 and 3 should be replaced while frame 1 decodes');
+    decodes[0]({ textualData: 'first' });
+    await tick();
+    assert(results.length === 1 && results[0].frame.id === 1 && results[0].dropped === 2, 'Result should count the drops');
+    assert(decodes.length === 2 && !finished, 'Ending should wait for the newest frame');
+    decodes[1]({ textualData: 'newest' });
+    await new Promise(resolve => stream.on('end', resolve));
+    assert(finished && results.map(output => output.frame.id).join() === '1,4', 'The newest frame should be decoded last');
+
+    // Nobody reads: decoding stops once the readable side is full, and only the newest frame waits
+    const unread = new FrameStream(async () => ({}));
+    for (let id = 1; id <= 40; id++) {
+        unread.write(frame(id));
+        await tick();
+    }
+    const held = unread.readableHighWaterMark;
+    assert(unread.decoded === held && unread.dropped === 40 - held - 1, 'Decoding should stop while results go unread');
+    unread.end();
+    const ids = [];
+    for await (const output of unread) {
+        ids.push(output.frame.id);
+    }
+    assert(ids.length === held + 1 && ids[held] === 40, 'Reading should resume with the newest frame');
+});
+
+// Test 27: Result ring sequence wrap
+test('Result ring should keep reading when the 32-bit sequence wraps', () => {
+    const { ResultRing } = BarkoderSDK;
+    const ring = new ResultRing({ slots: 3, maxResults: 1, textBytes: 8 });
+    const int32 = new Int32Array(ring.buffer);
+    const publish = (slot, stamp, frameId) => {
+        const base = (64 + slot * ring.recordBytes) / 4;
+        int32[base + 1] = frameId;
+        Atomics.store(int32, base, stamp);
+    };
+
+    // The reader has read 2^32 - 1 records, the last one from slot 0, so the next record goes to slot 1
+    ring.cursor = 0xFFFFFFFF;
+    ring.cursorSlot = 1;
+    publish(1, 1, 10);   // Sequence 2^32 - 1: its stamp wraps to 0, which is skipped
+    publish(2, 1, 11);   // Sequence 0 in the next slot, not in slot 0
+    Atomics.store(int32, 6, 1);
+
+    assert(ring.next() && ring.frameId === 10 && ring.valid(), 'The record before the wrap should be read from the next slot');
+    Atomics.store(int32, (64 + ring.recordBytes) / 4, 0);
+    assert(!ring.valid(), 'The record should not read as valid while it is rewritten');
+    assert(ring.next() && ring.frameId === 11 && ring.valid(), 'The record after the wrap should follow it');
+    assert(!ring.next() && ring.dropped === 0, 'Both records should be read once');
+});
+
+// Test 28: Decode statistics
+test('getStats should report every stage and start over after resetStats', () => {
+    BarkoderSDK.resetStats();
+    const stats = BarkoderSDK.getStats();
+    for (const name of ['queueWait', 'conversion', 'decode', 'marshal', 'total']) {
+        const stage = stats.stages[name];
+        assert(stage.count >= 0, `${name} should be counted`);
+        assert(stage.p50Ms <= stage.p99Ms && stage.p99Ms <= stage.maxMs, `${name} percentiles should be ordered`);
+    }
+    assert(Array.isArray(stats.breakdown), 'The speed and size breakdown should be a list');
+    assert(stats.results.emptyDecodes >= 0 && Array.isArray(stats.results.decoderSets), 'Decode outcomes should be reported');
+    assert(Object.values(stats.results.byType).every(count => count > 0), 'Only decoded symbologies should be counted');
+    for (const set of stats.results.decoderSets) {
+        assert(set.hits.count + set.misses.count > 0, 'Listed decoder sets should have decoded something');
+    }
+});
+
+// Test 29: OpenMetrics exposition
+test('metricsText should be OpenMetrics text ending in # EOF', () => {
+    const text = BarkoderSDK.metricsText();
+    assert(text.endsWith('\n# EOF\n') || text === '# EOF\n', 'The exposition should end with # EOF');
+    let family = null;
+    let type = null;
+    for (const line of text.slice(0, -'# EOF\n'.length).split('\n').filter(Boolean)) {
+        const declared = /^# TYPE ([a-zA-Z_:][a-zA-Z0-9_:]*) (counter|gauge|histogram)$/.exec(line);
+        if (declared) {
+            [, family, type] = declared;
+            continue;
+        }
+        if (line.startsWith('# HELP ')) {
+            assert(line.startsWith(`# HELP ${family} `), `Help should follow its type: ${line}`);
+            continue;
+        }
+        const sample = /^([a-zA-Z_:][a-zA-Z0-9_:]*)(\{[a-zA-Z_][a-zA-Z0-9_]*="[^"]*"(,[a-zA-Z_][a-zA-Z0-9_]*="[^"]*")*\})? (\S+)$/.exec(line);
+        assert(sample, `Not a sample: ${line}`);
+        assert(sample[1].startsWith(family), `Sample outside its family: ${line}`);
+        assert(type !== 'counter' || sample[1].endsWith('_total'), `Counter samples should end in _total: ${line}`);
+        assert(/^([+-]Inf|NaN)$/.test(sample[4]) || !Number.isNaN(Number(sample[4])), `Malformed value: ${line}`);
+    }
+});
+
+// Test 30: Trace timeline
+test('stopTracing should return Chrome trace-event JSON', () => {
+    assert(BarkoderSDK.startTracing(1024).ok, 'Tracing should start');
+    const trace = JSON.parse(BarkoderSDK.stopTracing());
+    assert(Array.isArray(trace.traceEvents), 'Events should be listed under traceEvents');
+    assert(trace.displayTimeUnit === 'ms', 'The display unit should be set');
+    for (const event of trace.traceEvents) {
+        assert(typeof event.name === 'string' && event.cat === 'barkoder', 'Events should be named');
+        assert(event.ph === 'X' ? event.dur >= 0 : event.ph === 'i' && event.s === 't', 'Events should be spans or instants');
+        assert([event.ts, event.pid, event.tid].every(Number.isFinite), 'Events should have a time, process and thread');
+    }
+});
+
+// Summary, once the async tests have settled
+Promise.all(pendingTests).then(() => {
+    console.log(`\n📊 Test Results:`);
+    console.log(`   ✅ Passed: ${testsPassed}`);
+    console.log(`   ❌ Failed: ${testsFailed}`);
+    console.log(`   📈 Total: ${testsPassed + testsFailed}`);
+
+    if (testsFailed === 0) {
+        console.log(`\n🎉 All tests passed!`);
+        process.exit(0);
+    } else {
+        console.log(`\n💥 ${testsFailed} test(s) failed!`);
+        process.exit(1);
+    }
+});
@@ -0,0 +1,37 @@
+#ifndef NativeTest_hpp
+#define NativeTest_hpp
+
+/**
+ * Minimal harness shared by the native tests
+ *
+ * Each *.test.cpp file exposes one Run*Tests function that main.cpp calls in
+ * turn. A test is a function that records failures with CHECK; the first
+ * failed CHECK marks it failed but the remaining ones still run.
+ *
+ * Build: npm run test:native (node-gyp rebuild --build_native_tests=true)
+ */
+
+#include <stdio.h>
+
+extern bool currentFailed;
+
+#define CHECK(condition, message)                                \
+    do {                                                         \
+        if (!(condition)) {                                      \
+            printf("   %s:%d %s\n", __FILE__, __LINE__, message); \
+            currentFailed = true;                                \
+        }                                                        \
+    } while (0)
+
+/**
+ * Run one test and print its outcome
+ */
+void Test(const char *name, void (*body)());
+
+void RunTileTests();
+void RunJsonTests();
+void RunStatsTests();
+void RunMetricsTests();
+void RunTraceTests();
+
+#endif /* NativeTest_hpp */
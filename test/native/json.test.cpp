@@ -0,0 +1,229 @@
+/**
+ * Result JSON tests
+ *
+ * Builds, prints and parses result-shaped cJSON trees with the per-thread
+ * arena installed, as the addon does, and checks that the text survives a
+ * round trip whether the tree lives in the arena or on the heap, and that
+ * appends after the cached tail stay in order as items are detached and
+ * replaced.
+ */
+
+#include <string>
+#include "JsonArena.hpp"
+#include "MemoryAccount.hpp"
+#include "NativeTest.hpp"
+#include "json/cJSON.h"
+
+using namespace BKNode;
+
+/**
+ * A decode result with the field kinds the addon writes
+ */
+static cJSON *ResultTree(int barcodes) {
+    static const int bytes[] = { 0, 1, 127, 255 };
+    cJSON *root = cJSON_CreateObject();
+    cJSON *results = cJSON_CreateArray();
+    for (int i = 0; i < barcodes; i++) {
+        cJSON *result = cJSON_CreateObject();
+        cJSON_AddStringToObject(result, "barcodeTypeName", "QR");
+        cJSON_AddStringToObject(result, "textualData", "h\xC3\xA9llo \"quoted\"\n\t\\ \x01 end");
+        cJSON_AddNumberToObject(result, "index", i);
+        cJSON_AddFloatToObject(result, "confidence", 0.1f + i);
+        cJSON_AddItemToObject(result, "binaryData", cJSON_CreateIntArray(bytes, 4));
+        cJSON *location = cJSON_CreateArray();
+        for (int corner = 0; corner < 4; corner++) {
+            cJSON *point = cJSON_CreateObject();
+            cJSON_AddFloatToObject(point, "x", 10.25f * corner + i);
+            cJSON_AddFloatToObject(point, "y", 1.0f / 3 + corner);
+            cJSON_AddItemToArray(location, point);
+        }
+        cJSON_AddItemToObject(result, "location", location);
+        cJSON_AddItemToArray(results, result);
+    }
+    cJSON_AddItemToObject(root, "results", results);
+    cJSON_AddTrueToObject(root, "complete");
+    cJSON_AddNullToObject(root, "error");
+    return root;
+}
+
+static std::string Print(cJSON *item, bool formatted = false) {
+    char *text = formatted ? cJSON_Print(item) : cJSON_PrintUnformatted(item);
+    std::string json(text ? text : "");
+    JsonArena::Release(text);
+    return json;
+}
+
+static void TestArenaRoundTrip() {
+    std::string heapText;
+    {
+        cJSON *root = ResultTree(3);
+        heapText = Print(root);
+        cJSON_Delete(root);
+    }
+
+    JsonArena::Scope scope;
+    cJSON *root = ResultTree(3);
+    const std::string text = Print(root);
+    cJSON_Delete(root);
+    CHECK(text == heapText, "A tree built in the arena should print like one built on the heap");
+
+    cJSON *parsed = cJSON_Parse(text.c_str());
+    CHECK(parsed != nullptr, "Printed results should parse");
+    CHECK(Print(parsed) == text, "Parsing and printing again should give the same text");
+    cJSON *first = cJSON_GetArrayItem(cJSON_GetObjectItem(parsed, "results"), 0);
+    CHECK(std::string(cJSON_GetObjectItem(first, "textualData")->valuestring) == "h\xC3\xA9llo \"quoted\"\n\t\\ \x01 end",
+          "Escaped and UTF-8 text should survive the round trip");
+    CHECK(static_cast<float>(cJSON_GetObjectItem(cJSON_GetArrayItem(cJSON_GetObjectItem(first, "location"), 1), "y")->valuedouble) ==
+              1.0f / 3 + 1,
+          "Float coordinates should parse back to the same float");
+
+    cJSON *formatted = cJSON_Parse(Print(parsed, true).c_str());
+    CHECK(formatted && Print(formatted) == text, "Formatted text should parse back to the same tree");
+    cJSON_Delete(formatted);
+    cJSON_Delete(parsed);
+}
+
+static void TestArenaReusesItsBlock() {
+    // A tree larger than the first block makes the arena grow. Each scope keeps only its
+    // largest block, so it can take a few scopes to reach one that holds the whole tree.
+    for (int pass = 0; pass < 3; pass++) {
+        JsonArena::Scope scope;
+        cJSON *root = ResultTree(500);
+        Print(root);
+        cJSON_Delete(root);
+    }
+    const int64_t grown = MemoryAccount::Current(MemoryCategory::ResultBuffers);
+    CHECK(grown > 64 * 1024, "The arena should have outgrown its first block");
+
+    std::string text;
+    for (int pass = 0; pass < 3; pass++) {
+        JsonArena::Scope scope;
+        cJSON *root = ResultTree(500);
+        text = Print(root);
+        cJSON_Delete(root);
+        CHECK(MemoryAccount::Current(MemoryCategory::ResultBuffers) == grown, "A tree that fits should not allocate blocks");
+    }
+
+    cJSON *parsed = cJSON_Parse(text.c_str());
+    CHECK(parsed && cJSON_GetArraySize(cJSON_GetObjectItem(parsed, "results")) == 500, "A large tree should print whole");
+    cJSON_Delete(parsed);
+}
+
+static void TestNestedScopes() {
+    JsonArena::Scope outer;
+    cJSON *root = ResultTree(1);
+    {
+        JsonArena::Scope inner;
+        cJSON_AddItemToObject(root, "inner", ResultTree(2));
+    }
+    // The inner scope closing must not rewind what the outer one still uses
+    cJSON *other = ResultTree(1);
+    CHECK(cJSON_GetArraySize(cJSON_GetObjectItem(cJSON_GetObjectItem(root, "inner"), "results")) == 2,
+          "Trees from an inner scope should live until the outer one closes");
+    CHECK(Print(root).find("\"inner\":{\"results\":[{") != std::string::npos, "The nested tree should print intact");
+    cJSON_Delete(other);
+    cJSON_Delete(root);
+}
+
+/**
+ * Values of an array's numbers in chain order, after checking that the
+ * links agree both ways and that the cached tail is the last item
+ */
+static std::string Values(cJSON *array) {
+    std::string values;
+    cJSON *last = nullptr;
+    for (cJSON *item = array->child; item; item = item->next) {
+        if (item->prev != last || (!last && item != array->child)) {
+            return "broken links";
+        }
+        values += (last ? "," : "") + (item->string ? std::string(item->string) + ":" : "") + std::to_string(item->valueint);
+        last = item;
+    }
+    return array->tail == last ? values : "stale tail";
+}
+
+static void TestArrayAppendOrder() {
+    JsonArena::Scope scope;
+    cJSON *array = cJSON_CreateArray();
+    std::string expected;
+    for (int i = 0; i < 1000; i++) {
+        cJSON_AddItemToArray(array, cJSON_CreateNumber(i));
+        expected += (i ? "," : "") + std::to_string(i);
+    }
+    CHECK(Values(array) == expected, "Appended items should stay in order");
+
+    cJSON_Delete(cJSON_DetachItemFromArray(array, 999));
+    cJSON_AddItemToArray(array, cJSON_CreateNumber(1000));
+    CHECK(cJSON_GetArraySize(array) == 1000 && cJSON_GetArrayItem(array, 998)->valueint == 998 &&
+              cJSON_GetArrayItem(array, 999)->valueint == 1000,
+          "An append after detaching the last item should follow the new last item");
+
+    cJSON_ReplaceItemInArray(array, 999, cJSON_CreateNumber(2000));
+    cJSON_AddItemToArray(array, cJSON_CreateNumber(2001));
+    CHECK(cJSON_GetArrayItem(array, 999)->valueint == 2000 && cJSON_GetArrayItem(array, 1000)->valueint == 2001,
+          "An append after replacing the last item should follow the replacement");
+
+    while (array->child) {
+        cJSON_DeleteItemFromArray(array, cJSON_GetArraySize(array) / 2);
+    }
+    cJSON_AddItemToArray(array, cJSON_CreateNumber(1));
+    cJSON_AddItemToArray(array, cJSON_CreateNumber(2));
+    CHECK(Values(array) == "1,2", "An array emptied by detaching should append from the start again");
+
+    cJSON_ReplaceItemInArray(array, 0, cJSON_CreateNumber(10));
+    cJSON_Delete(cJSON_DetachItemFromArray(array, 0));
+    cJSON_AddItemToArray(array, cJSON_CreateNumber(3));
+    CHECK(Values(array) == "2,3", "Replacing and detaching the first item should keep the tail");
+    cJSON_Delete(array);
+}
+
+static void TestObjectAppendOrder() {
+    JsonArena::Scope scope;
+    cJSON *object = cJSON_CreateObject();
+    cJSON_AddNumberToObject(object, "a", 1);
+    cJSON_AddNumberToObject(object, "b", 2);
+    cJSON_AddNumberToObject(object, "c", 3);
+
+    cJSON_ReplaceItemInObject(object, "c", cJSON_CreateNumber(30));
+    cJSON_AddNumberToObject(object, "d", 4);
+    CHECK(Values(object) == "a:1,b:2,c:30,d:4", "A key added after replacing the last one should follow it");
+
+    cJSON_Delete(cJSON_DetachItemFromObject(object, "d"));
+    cJSON_Delete(cJSON_DetachItemFromObject(object, "b"));
+    cJSON_AddNumberToObject(object, "e", 5);
+    CHECK(Values(object) == "a:1,c:30,e:5", "A key added after detaching the last one should follow the new last key");
+    CHECK(Print(object) == "{\"a\":1,\"c\":30,\"e\":5}", "Keys should print in insertion order");
+    cJSON_Delete(object);
+}
+
+static void TestBuiltChainsAppendOrder() {
+    // Arrays linked by the parser, the Create*Array helpers and Duplicate also set their tail
+    static const int numbers[] = { 1, 2, 3 };
+    JsonArena::Scope scope;
+    cJSON *parsed = cJSON_Parse("{\"list\":[1,2,3],\"z\":0}");
+    cJSON_AddItemToArray(cJSON_GetObjectItem(parsed, "list"), cJSON_CreateNumber(4));
+    cJSON_AddNumberToObject(parsed, "y", 9);
+    CHECK(Print(parsed) == "{\"list\":[1,2,3,4],\"z\":0,\"y\":9}", "Parsed arrays and objects should append at their end");
+
+    cJSON *created = cJSON_CreateIntArray(numbers, 3);
+    cJSON_AddItemToArray(created, cJSON_CreateNumber(4));
+    CHECK(Values(created) == "1,2,3,4", "Created arrays should append at their end");
+
+    cJSON *copy = cJSON_Duplicate(created, 1);
+    cJSON_AddItemToArray(copy, cJSON_CreateNumber(5));
+    CHECK(Values(copy) == "1,2,3,4,5" && Values(created) == "1,2,3,4", "Duplicates should append to themselves only");
+
+    cJSON_Delete(copy);
+    cJSON_Delete(created);
+    cJSON_Delete(parsed);
+}
+
+void RunJsonTests() {
+    JsonArena::Install();
+    Test("Result JSON built in the arena should survive a print and parse round trip", TestArenaRoundTrip);
+    Test("The arena should reuse its largest block between scopes", TestArenaReusesItsBlock);
+    Test("Nested arena scopes should release only when the outermost closes", TestNestedScopes);
+    Test("Array appends should follow the last item after detaching and replacing", TestArrayAppendOrder);
+    Test("Object keys should be appended in order after detaching and replacing", TestObjectAppendOrder);
+    Test("Parsed, created and duplicated arrays should append at their end", TestBuiltChainsAppendOrder);
+}
@@ -0,0 +1,27 @@
+#include <stdio.h>
+#include "NativeTest.hpp"
+
+bool currentFailed = false;
+
+static int testsPassed = 0;
+static int testsFailed = 0;
+
+void Test(const char *name, void (*body)()) {
+    currentFailed = false;
+    body();
+    printf("%s %s\n", currentFailed ? "❌" : "✅", name);
+    (currentFailed ? testsFailed : testsPassed)++;
+}
+
+int main() {
+    printf("🧪 Running native tests\n");
+    printf("=======================\n");
+    RunTileTests();
+    RunStatsTests();
+    RunJsonTests();
+    RunMetricsTests();
+    RunTraceTests();
+
+    printf("\n📊 Passed: %d, failed: %d\n", testsPassed, testsFailed);
+    return testsFailed == 0 ? 0 : 1;
+}
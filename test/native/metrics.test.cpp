@@ -0,0 +1,197 @@
+/**
+ * OpenMetrics exporter tests
+ *
+ * Parses what metricsText() serves with a strict checker for the parts of
+ * the OpenMetrics text format the exporter uses, and checks the histogram
+ * and counter values against what was recorded.
+ */
+
+#include <stdlib.h>
+#include <cmath>
+#include <map>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "BarkoderClasses.hpp"
+#include "DecodeStats.hpp"
+#include "MetricsText.hpp"
+#include "NativeTest.hpp"
+
+using namespace BKNode;
+using namespace NSBarkoder;
+
+static bool ParseValue(const std::string &text, double &value) {
+    if (text == "+Inf" || text == "-Inf" || text == "NaN") {
+        value = text == "+Inf" ? HUGE_VAL : text == "-Inf" ? -HUGE_VAL : NAN;
+        return true;
+    }
+    char *end = nullptr;
+    value = strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0';
+}
+
+/**
+ * Check an exposition against the OpenMetrics text format
+ * @return Empty when valid, otherwise the first problem found
+ */
+static std::string CheckOpenMetrics(const std::string &text) {
+    static const std::regex typeLine("# TYPE ([a-zA-Z_:][a-zA-Z0-9_:]*) (counter|gauge|histogram)");
+    static const std::regex helpLine("# HELP ([a-zA-Z_:][a-zA-Z0-9_:]*) [^\\n]*");
+    static const std::regex sampleLine("([a-zA-Z_:][a-zA-Z0-9_:]*)(?:\\{([^}]*)\\})? (\\S+)");
+    static const std::regex labelSet("[a-zA-Z_][a-zA-Z0-9_]*=\"(?:[^\"\\\\]|\\\\.)*\"(?:,[a-zA-Z_][a-zA-Z0-9_]*=\"(?:[^\"\\\\]|\\\\.)*\")*");
+    static const std::regex leLabel(",?le=\"([^\"]*)\"");
+
+    if (text.size() < 6 || text.compare(text.size() - 6, 6, "# EOF\n") != 0) {
+        return "The exposition should end with # EOF and a newline";
+    }
+
+    std::set<std::string> families;
+    std::string family, type;
+    bool helped = false;
+    std::map<std::string, double> lastBucket, infBucket;
+    std::istringstream lines(text.substr(0, text.size() - 6));
+    std::string line;
+    std::smatch match;
+    while (std::getline(lines, line)) {
+        if (std::regex_match(line, match, typeLine)) {
+            family = match[1];
+            type = match[2];
+            helped = false;
+            if (!families.insert(family).second) {
+                return "Family " + family + " is declared twice";
+            }
+            continue;
+        }
+        if (std::regex_match(line, match, helpLine)) {
+            if (match[1] != family || helped) {
+                return "Misplaced help: " + line;
+            }
+            helped = true;
+            continue;
+        }
+        if (!std::regex_match(line, match, sampleLine)) {
+            return "Not a sample: " + line;
+        }
+
+        const std::string name = match[1];
+        const std::string labels = match[2];
+        double value = 0;
+        if (!labels.empty() && !std::regex_match(labels, labelSet)) {
+            return "Malformed labels: " + line;
+        }
+        if (!ParseValue(match[3], value)) {
+            return "Malformed value: " + line;
+        }
+        if (family.empty() || name.compare(0, family.size(), family) != 0) {
+            return "Sample outside its family: " + line;
+        }
+
+        const std::string suffix = name.substr(family.size());
+        if (type == "counter" && suffix != "_total") {
+            return "Counter samples should end in _total: " + line;
+        }
+        if (type == "gauge" && !suffix.empty()) {
+            return "Gauge samples should be named after their family: " + line;
+        }
+        if (type == "histogram") {
+            std::smatch le;
+            const std::string series = std::regex_replace(labels, leLabel, "");
+            if (suffix == "_bucket") {
+                if (!std::regex_search(labels, le, leLabel)) {
+                    return "Bucket without le: " + line;
+                }
+                if (lastBucket.count(series) && value < lastBucket[series]) {
+                    return "Buckets should be cumulative: " + line;
+                }
+                lastBucket[series] = value;
+                if (le[1] == "+Inf") {
+                    infBucket[series] = value;
+                }
+            } else if (suffix == "_count") {
+                if (!infBucket.count(series) || infBucket[series] != value) {
+                    return "The count should equal the +Inf bucket: " + line;
+                }
+            } else if (suffix != "_sum") {
+                return "Unexpected histogram sample: " + line;
+            }
+        }
+    }
+    return "";
+}
+
+static bool HasLine(const std::string &text, const std::string &line) {
+    return text.find("\n" + line + "\n") != std::string::npos;
+}
+
+static void TestWriterFormat() {
+    MetricsText metrics;
+    metrics.Begin();
+    CHECK(metrics.End() == "# EOF\n", "An empty exposition should only hold # EOF");
+
+    metrics.Begin();
+    metrics.Family("test_depth", "gauge", "Depth.");
+    metrics.Sample("test_depth", nullptr, static_cast<uint64_t>(18446744073709551615ull));
+    metrics.Sample("test_depth", "lane=\"high\"", 0.25);
+    metrics.Sample("test_depth", "lane=\"low\"", HUGE_VAL);
+    const std::string &text = metrics.End();
+    CHECK(CheckOpenMetrics(text).empty(), "A gauge family should be valid OpenMetrics");
+    CHECK(text == "# TYPE test_depth gauge\n# HELP test_depth Depth.\ntest_depth 18446744073709551615\n"
+                  "test_depth{lane=\"high\"} 0.25\ntest_depth{lane=\"low\"} +Inf\n# EOF\n",
+          "Samples should be written exactly");
+
+    metrics.Begin();
+    CHECK(metrics.End() == "# EOF\n", "Begin should drop the previous exposition");
+}
+
+static void TestCheckerRejects() {
+    // The checker has to catch the mistakes it is there for
+    CHECK(!CheckOpenMetrics("# TYPE a counter\na_total 1\n").empty(), "A missing # EOF should be rejected");
+    CHECK(!CheckOpenMetrics("# TYPE a counter\na 1\n# EOF\n").empty(), "A counter without _total should be rejected");
+    CHECK(!CheckOpenMetrics("# TYPE a histogram\na_bucket{le=\"1\"} 2\na_bucket{le=\"+Inf\"} 1\na_count 1\n# EOF\n").empty(),
+          "Decreasing buckets should be rejected");
+    CHECK(!CheckOpenMetrics("# TYPE a gauge\na{b=c} 1\n# EOF\n").empty(), "Unquoted label values should be rejected");
+}
+
+static void TestDecodeMetrics() {
+    const uint64_t ms = 1000000;
+    DecodeStats::Record(DecodeStage::Marshal, DecodingSpeed::Fast, SizeBucket::Over16MP, ms / 10);
+    DecodeStats::Record(DecodeStage::Marshal, DecodingSpeed::Fast, SizeBucket::Over16MP, 3 * ms);
+    DecodeStats::Record(DecodeStage::Marshal, DecodingSpeed::Fast, SizeBucket::Over16MP, 20 * 1000 * ms);
+    const int aztec = DecodeStats::DecoderSetIndex({ DecoderType::Aztec });
+    BaseResult result;
+    result.barcodeType = BarcodeType::Aztec;
+    result.textualData = "aztec";
+    DecodeStats::RecordOutcome(aztec, { result, result }, ms);
+    DecodeStats::RecordOutcome(aztec, {}, ms);
+
+    MetricsText metrics;
+    metrics.Begin();
+    DecodeStats::WriteMetrics(metrics);
+    std::string text = metrics.End();
+    const std::string problem = CheckOpenMetrics(text);
+    CHECK(problem.empty(), problem.c_str());
+
+    const std::string labels = "{stage=\"marshal\",speed=\"fast\",size=\"over16MP\"";
+    CHECK(HasLine(text, "barkoder_decode_stage_seconds_bucket" + labels + ",le=\"0.0005\"} 1"), "0.1 ms should be under 0.5 ms");
+    CHECK(HasLine(text, "barkoder_decode_stage_seconds_bucket" + labels + ",le=\"0.005\"} 2"), "3 ms should be under 5 ms");
+    CHECK(HasLine(text, "barkoder_decode_stage_seconds_bucket" + labels + ",le=\"10\"} 2"), "20 s should be above every bound");
+    CHECK(HasLine(text, "barkoder_decode_stage_seconds_bucket" + labels + ",le=\"+Inf\"} 3"), "+Inf should count everything");
+    CHECK(HasLine(text, "barkoder_decode_stage_seconds_sum" + labels + "} 20.0031"), "The sum should be in seconds");
+    CHECK(HasLine(text, "barkoder_decodes_total{decoders=\"Aztec\",outcome=\"hit\"} 1"), "Hits should be exported per decoder set");
+    CHECK(HasLine(text, "barkoder_decodes_total{decoders=\"Aztec\",outcome=\"miss\"} 1"), "Misses should be exported per decoder set");
+    CHECK(HasLine(text, "barkoder_results_total{type=\"Aztec\"} 2"), "Results should be exported per symbology");
+
+    // Scrapers need monotonic counters, so resetStats() does not touch them
+    DecodeStats::Reset();
+    metrics.Begin();
+    DecodeStats::WriteMetrics(metrics);
+    CHECK(metrics.End() == text, "A reset should not change the exported values");
+}
+
+void RunMetricsTests() {
+    Test("Metric samples should be written in the OpenMetrics format", TestWriterFormat);
+    Test("The OpenMetrics checker should reject malformed expositions", TestCheckerRejects);
+    Test("Decode metrics should be valid OpenMetrics with the recorded values", TestDecodeMetrics);
+}
@@ -0,0 +1,159 @@
+/**
+ * Decode statistics tests
+ *
+ * Records stage latencies and decode outcomes the way the addon does and
+ * checks what getStats() reports for them: counts, percentiles, the speed and
+ * size breakdown, results per symbology, hits and misses per decoder set, and
+ * starting over after a reset.
+ */
+
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BarkoderClasses.hpp"
+#include "DecodeStats.hpp"
+#include "NativeTest.hpp"
+#include "json/cJSON.h"
+
+using namespace BKNode;
+using namespace NSBarkoder;
+
+static const uint64_t kMs = 1000000;
+
+static double Number(cJSON *object, const char *name) {
+    cJSON *item = object ? cJSON_GetObjectItem(object, name) : nullptr;
+    return item ? item->valuedouble : -1;
+}
+
+static bool Near(double value, double expected) {
+    return std::fabs(value - expected) <= expected * 0.05;
+}
+
+static void TestHistogramRecording() {
+    DecodeStats::Reset();
+    CHECK(DecodeStats::Snapshot(DecodeStage::Decode, DecodingSpeed::Normal, SizeBucket::UpTo1MP).Count() == 0,
+          "Nothing should be counted right after a reset");
+
+    for (int i = 0; i < 99; i++) {
+        DecodeStats::Record(DecodeStage::Decode, DecodingSpeed::Normal, SizeBucket::UpTo1MP, 2 * kMs);
+    }
+    DecodeStats::Record(DecodeStage::Decode, DecodingSpeed::Normal, SizeBucket::UpTo1MP, 40 * kMs);
+
+    HistogramSnapshot decode = DecodeStats::Snapshot(DecodeStage::Decode, DecodingSpeed::Normal, SizeBucket::UpTo1MP);
+    CHECK(decode.Count() == 100, "Every recorded decode should be counted");
+    CHECK(decode.SumNs() == 238 * kMs, "The sum should be exact");
+    CHECK(Near(decode.ValueAtQuantile(0.5), 2 * kMs), "The median should be within 5% of 2 ms");
+    CHECK(Near(decode.ValueAtQuantile(1.0), 40 * kMs), "The maximum should be within 5% of 40 ms");
+    CHECK(DecodeStats::Snapshot(DecodeStage::Decode, DecodingSpeed::Fast, SizeBucket::UpTo1MP).Count() == 0,
+          "Other speeds should be counted separately");
+    CHECK(DecodeStats::Snapshot(DecodeStage::Decode, DecodingSpeed::Normal, SizeBucket::UpTo4MP).Count() == 0,
+          "Other sizes should be counted separately");
+}
+
+static void TestThreadsAreMerged() {
+    // Queue waits are recorded by pool workers, each into its own shard
+    DecodeStats::Reset();
+    std::thread workers[4];
+    for (std::thread &worker : workers) {
+        worker = std::thread([] {
+            for (int i = 0; i < 250; i++) {
+                DecodeStats::Record(DecodeStage::QueueWait, DecodingSpeed::Slow, SizeBucket::UpTo16MP, kMs);
+            }
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    CHECK(DecodeStats::Snapshot(DecodeStage::QueueWait, DecodingSpeed::Slow, SizeBucket::UpTo16MP).Count() == 1000,
+          "Samples from every thread should be summed");
+}
+
+static void TestStatsJson() {
+    DecodeStats::Reset();
+    DecodeStats::Record(DecodeStage::QueueWait, DecodingSpeed::Rigorous, DecodeStats::SizeBucketFor(4000, 3000), 3 * kMs);
+    DecodeStats::Record(DecodeStage::Decode, DecodingSpeed::Rigorous, DecodeStats::SizeBucketFor(4000, 3000), 30 * kMs);
+    DecodeStats::Record(DecodeStage::Decode, DecodingSpeed::Fast, DecodeStats::SizeBucketFor(640, 480), 5 * kMs);
+
+    cJSON *root = DecodeStats::ToJson();
+    cJSON *stages = cJSON_GetObjectItem(root, "stages");
+    CHECK(Number(cJSON_GetObjectItem(stages, "decode"), "count") == 2, "The decode stage should count both decodes");
+    CHECK(Number(cJSON_GetObjectItem(stages, "queueWait"), "count") == 1, "The queue wait should be counted once");
+    CHECK(Near(Number(cJSON_GetObjectItem(stages, "queueWait"), "p50Ms"), 3), "Queue wait percentiles should be in ms");
+    CHECK(Number(cJSON_GetObjectItem(stages, "total"), "count") == 0, "Unrecorded stages should be empty");
+
+    cJSON *breakdown = cJSON_GetObjectItem(root, "breakdown");
+    CHECK(cJSON_GetArraySize(breakdown) == 2, "Only speed and size pairs that were used should be listed");
+    cJSON *fast = cJSON_GetArrayItem(breakdown, 0);
+    cJSON *rigorous = cJSON_GetArrayItem(breakdown, 1);
+    CHECK(Number(fast, "decodingSpeed") == 0 && std::string(cJSON_GetObjectItem(fast, "imageSize")->valuestring) == "upTo1MP",
+          "A VGA fast decode should be in the fast, up to 1 MP entry");
+    CHECK(Number(rigorous, "decodingSpeed") == 3 && std::string(cJSON_GetObjectItem(rigorous, "imageSize")->valuestring) == "upTo16MP",
+          "A 12 MP rigorous decode should be in the rigorous, up to 16 MP entry");
+    CHECK(Number(cJSON_GetObjectItem(cJSON_GetObjectItem(rigorous, "stages"), "decode"), "count") == 1,
+          "Breakdown entries should hold their own counts");
+    cJSON_Delete(root);
+
+    DecodeStats::Reset();
+    root = DecodeStats::ToJson();
+    CHECK(Number(cJSON_GetObjectItem(cJSON_GetObjectItem(root, "stages"), "decode"), "count") == 0, "A reset should zero getStats()");
+    CHECK(cJSON_GetArraySize(cJSON_GetObjectItem(root, "breakdown")) == 0, "A reset should empty the breakdown");
+    cJSON_Delete(root);
+}
+
+static BaseResult Decoded(BarcodeType type, const char *text) {
+    BaseResult result;
+    result.barcodeType = type;
+    result.textualData = text;
+    return result;
+}
+
+static void TestOutcomeCounters() {
+    DecodeStats::Reset();
+    const int qrAndCode128 = DecodeStats::DecoderSetIndex({ DecoderType::Code128, DecoderType::QR });
+    CHECK(DecodeStats::DecoderSetIndex({ DecoderType::QR, DecoderType::Code128, DecoderType::QR }) == qrAndCode128,
+          "The same decoders in any order should share a set");
+    const int qrOnly = DecodeStats::DecoderSetIndex({ DecoderType::QR });
+    CHECK(qrOnly != qrAndCode128, "Different decoders should get another set");
+
+    // A located but undecoded candidate is not a result
+    std::vector<BaseResult> results = { Decoded(BarcodeType::QR, "a"), Decoded(BarcodeType::Code128, "b"),
+                                        Decoded(BarcodeType::QR, "c"), Decoded(BarcodeType::QR, "") };
+    DecodeStats::RecordOutcome(qrAndCode128, results, 4 * kMs);
+    DecodeStats::RecordOutcome(qrAndCode128, {}, 9 * kMs);
+    DecodeStats::RecordOutcome(qrOnly, { Decoded(BarcodeType::QR, "d") }, kMs);
+
+    cJSON *root = DecodeStats::ToJson();
+    cJSON *outcomes = cJSON_GetObjectItem(root, "results");
+    cJSON *byType = cJSON_GetObjectItem(outcomes, "byType");
+    CHECK(Number(byType, "QR") == 3 && Number(byType, "Code128") == 1, "Results should be counted by symbology");
+    CHECK(cJSON_GetArraySize(byType) == 2, "Symbologies never decoded should be left out");
+    CHECK(Number(outcomes, "emptyDecodes") == 1, "The decode without results should be counted as empty");
+
+    cJSON *sets = cJSON_GetObjectItem(outcomes, "decoderSets");
+    CHECK(cJSON_GetArraySize(sets) == 2, "Both decoder sets should be listed");
+    cJSON *both = cJSON_GetArrayItem(sets, 0);
+    cJSON *decoders = cJSON_GetObjectItem(both, "decoders");
+    CHECK(cJSON_GetArraySize(decoders) == 2 && std::string(cJSON_GetArrayItem(decoders, 0)->valuestring) == "QR" &&
+              std::string(cJSON_GetArrayItem(decoders, 1)->valuestring) == "Code128",
+          "A set should list its decoders by name");
+    CHECK(Number(cJSON_GetObjectItem(both, "hits"), "count") == 1 && Number(cJSON_GetObjectItem(both, "misses"), "count") == 1,
+          "Decodes should be split into hits and misses");
+    CHECK(Near(Number(cJSON_GetObjectItem(both, "misses"), "p50Ms"), 9), "A miss should be attributed its decode time");
+    CHECK(Number(cJSON_GetObjectItem(cJSON_GetArrayItem(sets, 1), "results"), "QR") == 1, "Each set should count its own results");
+    cJSON_Delete(root);
+
+    DecodeStats::Reset();
+    root = DecodeStats::ToJson();
+    outcomes = cJSON_GetObjectItem(root, "results");
+    CHECK(cJSON_GetArraySize(cJSON_GetObjectItem(outcomes, "byType")) == 0 && Number(outcomes, "emptyDecodes") == 0,
+          "A reset should zero the result counts");
+    cJSON_Delete(root);
+}
+
+void RunStatsTests() {
+    Test("Stage latencies should be counted per speed and size", TestHistogramRecording);
+    Test("Stage latencies from every thread should be merged", TestThreadsAreMerged);
+    Test("getStats() should report recorded latencies and the breakdown", TestStatsJson);
+    Test("Results should be counted per symbology and decodes timed per decoder set", TestOutcomeCounters);
+}
@@ -0,0 +1,128 @@
+/**
+ * Tile geometry tests
+ *
+ * Checks the parts of tiled decoding that need no license: where tiles are
+ * placed, how tile coordinates are mapped back to the full image, and how
+ * results seen twice in overlap zones are merged.
+ */
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include "DecodeStrategies.hpp"
+#include "NativeTest.hpp"
+
+using namespace BKNode;
+using namespace NSBarkoder;
+
+static ImageRect Area(int left, int top, int width, int height) {
+    ImageRect rect;
+    rect.left = left;
+    rect.top = top;
+    rect.width = width;
+    rect.height = height;
+    return rect;
+}
+
+/**
+ * A decoded QR code with an axis-aligned square outline
+ */
+static BaseResult Square(const std::string &text, float left, float top, float side) {
+    BaseResult result;
+    result.barcodeType = BarcodeType::QR;
+    result.textualData = text;
+    result.location[0] = { left, top };
+    result.location[1] = { left + side, top };
+    result.location[2] = { left + side, top + side };
+    result.location[3] = { left, top + side };
+    result.locationCenter = { left + side / 2, top + side / 2 };
+    return result;
+}
+
+static bool Contains(const ImageRect &outer, const ImageRect &inner) {
+    return inner.left >= outer.left && inner.top >= outer.top && inner.Right() <= outer.Right() && inner.Bottom() <= outer.Bottom();
+}
+
+static void TestTileOffsets() {
+    // 200 px barcodes: 800 px tiles every 600 px, the last ones aligned to the right and bottom edges
+    std::vector<ImageRect> tiles = PlanTiles(Area(0, 0, 2000, 1200), 200);
+    const int lefts[] = { 0, 600, 1200 };
+    const int tops[] = { 0, 400 };
+    CHECK(tiles.size() == 6, "2000x1200 should be cut into 3x2 tiles");
+    for (size_t i = 0; i < tiles.size() && i < 6; i++) {
+        CHECK(tiles[i].left == lefts[i % 3] && tiles[i].top == tops[i / 3], "Tiles should be in row-major order at the expected offsets");
+        CHECK(tiles[i].width == 800 && tiles[i].height == 800, "Tiles should be 4 barcode sizes wide");
+    }
+
+    // Small barcodes still get 512 px tiles, and an area smaller than a tile is a single tile
+    CHECK(PlanTiles(Area(0, 0, 5000, 512), 10)[0].width == 512, "Tiles should be at least 512 px");
+    std::vector<ImageRect> single = PlanTiles(Area(30, 40, 300, 200), 200);
+    CHECK(single.size() == 1 && single[0].left == 30 && single[0].top == 40 && single[0].width == 300 && single[0].height == 200,
+          "An area smaller than a tile should be one tile covering it");
+}
+
+static void TestTilesCoverEveryBarcode() {
+    // Every barcode up to the maximum size lies wholly inside a tile, wherever it is in the area
+    const ImageRect area = Area(100, 50, 3001, 2077);
+    const int maxBarcodeSize = 300;
+    std::vector<ImageRect> tiles = PlanTiles(area, maxBarcodeSize);
+    int uncovered = 0;
+    for (int top = area.top; top + maxBarcodeSize <= area.Bottom(); top += 7) {
+        for (int left = area.left; left + maxBarcodeSize <= area.Right(); left += 7) {
+            ImageRect barcode = Area(left, top, maxBarcodeSize, maxBarcodeSize);
+            bool covered = false;
+            for (const ImageRect &tile : tiles) {
+                covered = covered || Contains(tile, barcode);
+            }
+            uncovered += covered ? 0 : 1;
+        }
+    }
+    CHECK(uncovered == 0, "Every barcode position should fit inside a tile");
+    for (const ImageRect &tile : tiles) {
+        CHECK(Contains(area, tile), "Tiles should stay inside the area");
+    }
+}
+
+static void TestTileCoordinatesMapBack() {
+    // A barcode at (40, 60) in the tile at (600, 400) is at (640, 460) in the image
+    BaseResult result = Square("tile", 40, 60, 100);
+    result.polygonLocation = { { 40, 60 }, { 140, 60 }, { 140, 160 } };
+    TransformResult(result, 1.0f, 600, 400);
+    CHECK(result.location[0].x == 640 && result.location[0].y == 460, "Corners should be offset by the tile origin");
+    CHECK(result.location[2].x == 740 && result.location[2].y == 560, "Every corner should be offset");
+    CHECK(result.polygonLocation[1].x == 740 && result.polygonLocation[1].y == 460, "Polygon vertices should be offset");
+    CHECK(result.locationCenter.x == 690 && result.locationCenter.y == 510, "The center should be offset");
+
+    // Coarse pyramid passes scale first, then offset
+    BaseResult coarse = Square("coarse", 10, 20, 5);
+    TransformResult(coarse, 4.0f, 0, 0);
+    CHECK(coarse.location[2].x == 60 && coarse.location[2].y == 100, "Downscaled coordinates should be scaled back");
+}
+
+static void TestDuplicatesMerge() {
+    // The same barcode decoded by two overlapping tiles, once cut by a tile edge
+    std::vector<BaseResult> results;
+    CHECK(MergeResult(results, Square("same", 590, 390, 80)), "The first result should be added");
+    CHECK(!MergeResult(results, Square("same", 600, 400, 100)), "An overlapping result with the same text should be merged");
+    CHECK(results.size() == 1 && results[0].location[0].x == 600, "The larger outline should be kept");
+    CHECK(!MergeResult(results, Square("same", 610, 410, 60)), "A partial outline inside it should be merged");
+    CHECK(results[0].location[2].x == 700, "A smaller outline should not replace the larger one");
+
+    // Equal text elsewhere, or other text in the same place, are different barcodes
+    CHECK(MergeResult(results, Square("same", 1500, 400, 100)), "The same text far away should be a second barcode");
+    CHECK(MergeResult(results, Square("other", 600, 400, 100)), "Other text in the same place should be a second barcode");
+    BaseResult code128 = Square("same", 600, 400, 100);
+    code128.barcodeType = BarcodeType::Code128;
+    CHECK(MergeResult(results, code128), "Another symbology in the same place should be a second barcode");
+
+    // Overlap below the IoU threshold: a 100 px square shifted by 70 px overlaps by 3000 of 17000 px
+    CHECK(MergeResult(results, Square("same", 1570, 400, 100)), "A result overlapping less than the threshold should be kept");
+    CHECK(results.size() == 5, "Five distinct barcodes should remain");
+}
+
+void RunTileTests() {
+    Test("Tiles should be placed at the expected offsets", TestTileOffsets);
+    Test("Tiles should fully contain every barcode up to the maximum size", TestTilesCoverEveryBarcode);
+    Test("Tile coordinates should map back to the full image", TestTileCoordinatesMapBack);
+    Test("Results seen by overlapping tiles should be merged", TestDuplicatesMerge);
+}
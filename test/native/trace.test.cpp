@@ -0,0 +1,142 @@
+/**
+ * Trace timeline tests
+ *
+ * Records spans and instants, parses the timeline stopTracing() returns and
+ * checks it against the Chrome trace-event format: the fields each event
+ * needs, oldest first order, and only the most recent events kept.
+ */
+
+#include <set>
+#include <string>
+#include <thread>
+#include "NativeTest.hpp"
+#include "Tracer.hpp"
+#include "json/cJSON.h"
+
+using namespace BKNode;
+
+static bool IsNumber(cJSON *object, const char *name) {
+    cJSON *item = cJSON_GetObjectItem(object, name);
+    return item && item->type == cJSON_Number;
+}
+
+static std::string String(cJSON *object, const char *name) {
+    cJSON *item = cJSON_GetObjectItem(object, name);
+    return item && item->type == cJSON_String ? item->valuestring : "";
+}
+
+/**
+ * Check the trace-event fields of every event
+ * @return The events array, or nullptr if the timeline is not valid trace JSON
+ */
+static cJSON *CheckTrace(cJSON *root) {
+    cJSON *events = root ? cJSON_GetObjectItem(root, "traceEvents") : nullptr;
+    if (!events || events->type != cJSON_Array || String(root, "displayTimeUnit") != "ms") {
+        return nullptr;
+    }
+    for (cJSON *event = events->child; event; event = event->next) {
+        const std::string phase = String(event, "ph");
+        if (String(event, "name").empty() || String(event, "cat") != "barkoder" || !IsNumber(event, "ts") ||
+            !IsNumber(event, "pid") || !IsNumber(event, "tid")) {
+            return nullptr;
+        }
+        if (phase == "X" ? !IsNumber(event, "dur") || cJSON_GetObjectItem(event, "dur")->valuedouble < 0
+                         : phase != "i" || String(event, "s") != "t") {
+            return nullptr;
+        }
+        cJSON *args = cJSON_GetObjectItem(event, "args");
+        if (args && (args->type != cJSON_Object || !args->child || args->child->type != cJSON_Number)) {
+            return nullptr;
+        }
+    }
+    return events;
+}
+
+static void TestTimelineFormat() {
+    Tracer::Start(64);
+    {
+        TraceSpan span("decode", "width", 640);
+        Tracer::Instant("enqueue", "pending", 3);
+    }
+    Tracer::Instant("settle");
+    Tracer::Stop();
+    Tracer::Instant("stopped");
+
+    cJSON *root = cJSON_Parse(Tracer::ToJson().c_str());
+    cJSON *events = CheckTrace(root);
+    CHECK(events != nullptr, "The timeline should be valid Chrome trace JSON");
+    CHECK(events && cJSON_GetArraySize(events) == 3, "Events recorded after stopping should be left out");
+    if (events && cJSON_GetArraySize(events) == 3) {
+        cJSON *enqueue = cJSON_GetArrayItem(events, 0);
+        cJSON *decode = cJSON_GetArrayItem(events, 1);
+        cJSON *settle = cJSON_GetArrayItem(events, 2);
+        CHECK(String(enqueue, "name") == "enqueue" && String(enqueue, "ph") == "i", "Instants should be thread-scoped i events");
+        CHECK(cJSON_GetObjectItem(cJSON_GetObjectItem(enqueue, "args"), "pending")->valueint == 3, "Arguments should be kept");
+        CHECK(String(decode, "name") == "decode" && String(decode, "ph") == "X", "Spans should be complete X events");
+        CHECK(cJSON_GetObjectItem(decode, "ts")->valuedouble <= cJSON_GetObjectItem(enqueue, "ts")->valuedouble &&
+                  cJSON_GetObjectItem(decode, "ts")->valuedouble + cJSON_GetObjectItem(decode, "dur")->valuedouble >=
+                      cJSON_GetObjectItem(enqueue, "ts")->valuedouble,
+              "A span should cover what happened inside it");
+        CHECK(!cJSON_GetObjectItem(settle, "args"), "Events without an argument should have no args");
+    }
+    cJSON_Delete(root);
+}
+
+static void TestRingKeepsNewest() {
+    static const char *const names[] = { "e0", "e1", "e2", "e3", "e4", "e5", "e6", "e7", "e8", "e9" };
+    Tracer::Start(4);
+    for (int i = 0; i < 10; i++) {
+        Tracer::Instant(names[i], "index", i);
+    }
+    Tracer::Stop();
+
+    cJSON *root = cJSON_Parse(Tracer::ToJson().c_str());
+    cJSON *events = CheckTrace(root);
+    CHECK(events && cJSON_GetArraySize(events) == 4, "A full ring should keep as many events as its capacity");
+    for (int i = 0; events && i < cJSON_GetArraySize(events); i++) {
+        CHECK(String(cJSON_GetArrayItem(events, i), "name") == names[6 + i], "The newest events should be kept, oldest first");
+    }
+    cJSON_Delete(root);
+
+    // Starting again with the same capacity reuses the ring without showing old events
+    Tracer::Start(4);
+    Tracer::Instant("again");
+    Tracer::Stop();
+    root = cJSON_Parse(Tracer::ToJson().c_str());
+    events = CheckTrace(root);
+    CHECK(events && cJSON_GetArraySize(events) == 1 && String(events->child, "name") == "again",
+          "A restart should discard the previous events");
+    cJSON_Delete(root);
+}
+
+static void TestThreadsAreSeparated() {
+    Tracer::Start(1024);
+    std::thread workers[4];
+    for (std::thread &worker : workers) {
+        worker = std::thread([] {
+            for (int i = 0; i < 100; i++) {
+                TraceSpan span("work", "index", i);
+            }
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    Tracer::Stop();
+
+    cJSON *root = cJSON_Parse(Tracer::ToJson().c_str());
+    cJSON *events = CheckTrace(root);
+    CHECK(events && cJSON_GetArraySize(events) == 400, "Every event from every thread should be kept");
+    std::set<double> threads;
+    for (cJSON *event = events ? events->child : nullptr; event; event = event->next) {
+        threads.insert(cJSON_GetObjectItem(event, "tid")->valuedouble);
+    }
+    CHECK(threads.size() == 4, "Each thread should get its own tid");
+    cJSON_Delete(root);
+}
+
+void RunTraceTests() {
+    Test("The timeline should be valid Chrome trace JSON", TestTimelineFormat);
+    Test("The timeline should keep the most recent events, oldest first", TestRingKeepsNewest);
+    Test("Events from several threads should be kept per thread", TestThreadsAreSeparated);
+}